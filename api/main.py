@@ -52,6 +52,7 @@ from pathlib import Path
 from datetime import datetime
 import subprocess
 import asyncio
+import socket
 
 # ====================================================================
 # FastAPI Application Initialization
@@ -572,6 +573,24 @@ async def run_simulation(request: SimulationRequest = SimulationRequest()):
         orders = data_dir / request.customer_orders_file.split("/")[-1]
         assembly = data_dir / request.assembly_line_file.split("/")[-1]
         
+        # Fast path: a warm simulation daemon (assembly_line --daemon <socket>)
+        # keeps the parsed scenario and DB connection open, so a run costs
+        # only the simulation itself instead of a process start
+        daemon_socket = os.getenv("SIMULATOR_SOCKET", "").strip()
+        if daemon_socket and os.path.exists(daemon_socket):
+            command = f"run {stations1} {stations2} {orders} {assembly}\n"
+            response = await asyncio.to_thread(_daemon_request, daemon_socket, command)
+            if response.get("status") != "success":
+                raise HTTPException(
+                    status_code=500,
+                    detail=f"Simulation failed: {response.get('detail', 'unknown error')}"
+                )
+            return {
+                "status": "success",
+                "message": "Simulation completed successfully",
+                "output": response.get("output", "")
+            }
+
         # Run simulation
         # This executes the C++ program which:
         # 1. Loads stations and orders from data files
@@ -600,6 +619,14 @@ async def run_simulation(request: SimulationRequest = SimulationRequest()):
     except Exception as e:
         raise HTTPException(status_code=500, detail=str(e))
 
+def _daemon_request(socket_path: str, command: str) -> dict:
+    """Send one command to the simulation daemon and return its JSON reply"""
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path)
+        sock.sendall(command.encode())
+        with sock.makefile("r") as reader:
+            return json.loads(reader.readline())
+
 # ====================================================================
 # WebSocket Endpoint for Real-Time Updates
 # ====================================================================
@@ -638,6 +665,26 @@ async def websocket_endpoint(websocket: WebSocket):
     - This is optional - app works fine without WebSocket
     """
     await websocket.accept()
+
+    # Prefer the simulator's live event stream when it is running: frames
+    # arrive as the line progresses instead of being polled from SQLite
+    event_socket = os.getenv("EVENT_STREAM_SOCKET", "").strip()
+    if event_socket and os.path.exists(event_socket):
+        try:
+            reader, writer = await asyncio.open_unix_connection(event_socket)
+            try:
+                while True:
+                    line = await reader.readline()
+                    if not line:
+                        break
+                    if line.startswith(b"data: "):
+                        await websocket.send_text(line[6:].decode().strip())
+            finally:
+                writer.close()
+        except WebSocketDisconnect:
+            pass
+        return
+
     try:
         while True:
             # Send statistics every second
@@ -0,0 +1,978 @@
+// Micro and macro benchmarks for the assembly line simulator.
+//
+// The harness mirrors the Google Benchmark command line and JSON report so
+// results can be fed to the usual comparison tooling (compare.py etc.)
+// without adding a third-party dependency to the build:
+//
+//   bench_assembly_line [--benchmark_filter=<substring>]
+//                       [--benchmark_min_time=<seconds>]
+//                       [--benchmark_out=<file.json>]
+//
+// Every benchmark body calls state.keepRunning() in a loop; the harness
+// grows the iteration count until a run lasts at least the minimum time.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <queue>
+#include <cmath>
+#include <unordered_map>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <algorithm>
+#include <thread>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "seneca/Station.h"
+#include "seneca/Workstation.h"
+#include "seneca/CustomerOrder.h"
+#include "seneca/LineManager.h"
+#include "seneca/Utilities.h"
+#include "seneca/Logger.h"
+#include "seneca/Database.h"
+#include "seneca/OrderTable.h"
+#include "seneca/RunArena.h"
+#include "seneca/StationRegistry.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/CalendarQueue.h"
+#include "seneca/IncrementalEngine.h"
+#include "seneca/RecordParser.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    class State
+    {
+        size_t m_iterations;
+        size_t m_done{0};
+        long m_arg;
+        bool m_timing{false};
+        Clock::time_point m_realStart{};
+        std::clock_t m_cpuStart{};
+        double m_realSeconds{0};
+        double m_cpuSeconds{0};
+        double m_items{0};
+
+    public:
+        State(size_t iterations, long arg) : m_iterations(iterations), m_arg(arg) {}
+
+        bool keepRunning()
+        {
+            if (m_done == 0 && !m_timing) {
+                resumeTiming();
+            }
+            if (m_done++ < m_iterations) {
+                return true;
+            }
+            pauseTiming();
+            return false;
+        }
+
+        // Exclude setup work (building inputs, resetting globals) from the measurement
+        void pauseTiming()
+        {
+            if (m_timing) {
+                m_realSeconds += std::chrono::duration<double>(Clock::now() - m_realStart).count();
+                m_cpuSeconds += double(std::clock() - m_cpuStart) / CLOCKS_PER_SEC;
+                m_timing = false;
+            }
+        }
+
+        void resumeTiming()
+        {
+            if (!m_timing) {
+                m_timing = true;
+                m_cpuStart = std::clock();
+                m_realStart = Clock::now();
+            }
+        }
+
+        long range() const { return m_arg; }
+        size_t iterations() const { return m_iterations; }
+        void setItemsProcessed(double items) { m_items = items; }
+        double itemsProcessed() const { return m_items; }
+        double realSeconds() const { return m_realSeconds; }
+        double cpuSeconds() const { return m_cpuSeconds; }
+    };
+
+    struct Benchmark
+    {
+        std::string name;
+        std::function<void(State&)> fn;
+        std::vector<long> args;
+    };
+
+    std::vector<Benchmark>& registry()
+    {
+        static std::vector<Benchmark> benchmarks;
+        return benchmarks;
+    }
+
+    void registerBenchmark(const std::string& name, std::function<void(State&)> fn, std::vector<long> args = {})
+    {
+        registry().push_back({name, std::move(fn), std::move(args)});
+    }
+
+    // Discards everything written to it; the simulation is chatty and the
+    // benchmarks measure the engine, not the terminal
+    class NullBuffer : public std::streambuf
+    {
+    protected:
+        int overflow(int ch) override { return ch; }
+        std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+    };
+
+    NullBuffer g_nullBuffer;
+    std::ostream g_null(&g_nullBuffer);
+
+    template <typename T>
+    void doNotOptimize(T const& value)
+    {
+#if defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    std::string itemName(size_t i)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "Item%05zu", i);
+        return buf;
+    }
+
+    void clearGlobals()
+    {
+        seneca::g_pending.clear();
+        seneca::g_completed.clear();
+        seneca::g_incomplete.clear();
+    }
+
+    // ---------------------------------------------------------------------
+    // Tokenizer
+    // ---------------------------------------------------------------------
+
+    void BM_ExtractToken(State& state)
+    {
+        seneca::Utilities::setDelimiter(',');
+        const std::string record = "Elliott C., Gaming PC, Desk, Office Chair, CPU, Memory, SSD, GPU";
+        size_t tokens = 0;
+        while (state.keepRunning()) {
+            seneca::Utilities util;
+            size_t next_pos = 0;
+            bool more = true;
+            while (more) {
+                std::string token = util.extractToken(record, next_pos, more);
+                doNotOptimize(token);
+                tokens++;
+            }
+        }
+        state.setItemsProcessed(double(tokens));
+    }
+
+    // Order records from a dirty feed: every tenth one has an empty field
+    std::vector<std::string> dirtyOrderRecords(size_t count)
+    {
+        std::vector<std::string> records;
+        records.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            records.push_back("Customer " + std::to_string(i) + (i % 10 == 3 ? " || " : " | ") +
+                              "Product " + std::to_string(i % 100) + " | Desk | Office Chair | Bookcase | Lamp");
+        }
+        return records;
+    }
+
+    // Skipping the bad records by catching what the constructor throws...
+    void BM_ParseDirtyOrdersThrowing(State& state)
+    {
+        std::vector<std::string> records = dirtyOrderRecords(size_t(state.range()));
+        size_t kept = 0;
+        while (state.keepRunning()) {
+            for (const auto& record : records) {
+                try {
+                    seneca::CustomerOrder order(record, '|');
+                    doNotOptimize(order);
+                    kept++;
+                }
+                catch (const std::exception&) {
+                }
+            }
+        }
+        doNotOptimize(kept);
+        state.setItemsProcessed(double(records.size()) * double(state.iterations()));
+    }
+
+    // ...and by checking the status parseOrder() returns
+    void BM_ParseDirtyOrdersStatus(State& state)
+    {
+        std::vector<std::string> records = dirtyOrderRecords(size_t(state.range()));
+        seneca::OrderSpec spec;
+        while (state.keepRunning()) {
+            seneca::ParseReport report;
+            size_t line = 0;
+            for (const auto& record : records) {
+                line++;
+                seneca::ParseStatus status = seneca::parseOrder(record, '|', spec);
+                if (status != seneca::ParseStatus::OK) {
+                    report.reject("orders", line, status, record);
+                    continue;
+                }
+                seneca::CustomerOrder order(spec.m_name, spec.m_product, spec.m_items);
+                doNotOptimize(order);
+                report.accept();
+            }
+            doNotOptimize(report);
+        }
+        state.setItemsProcessed(double(records.size()) * double(state.iterations()));
+    }
+
+    // ---------------------------------------------------------------------
+    // CustomerOrder lifetime
+    // ---------------------------------------------------------------------
+
+    void BM_CustomerOrderConstruct(State& state)
+    {
+        seneca::Utilities::setDelimiter(',');
+        const std::string record = "Chris S., Bookcase, Bookcase, Desk, Office Chair, Filing Cabinet";
+        while (state.keepRunning()) {
+            seneca::CustomerOrder order(record);
+            doNotOptimize(order);
+        }
+        state.setItemsProcessed(double(state.iterations()));
+    }
+
+    void BM_CustomerOrderMove(State& state)
+    {
+        seneca::Utilities::setDelimiter(',');
+        seneca::CustomerOrder a("Chris S., Bookcase, Bookcase, Desk, Office Chair, Filing Cabinet");
+        seneca::CustomerOrder b;
+        while (state.keepRunning()) {
+            b = std::move(a);
+            a = std::move(b);
+            doNotOptimize(a);
+        }
+        state.setItemsProcessed(double(state.iterations()) * 2);
+    }
+
+    void BM_CustomerOrderDestroy(State& state)
+    {
+        seneca::Utilities::setDelimiter(',');
+        const std::string record = "Chris S., Bookcase, Bookcase, Desk, Office Chair, Filing Cabinet";
+        const size_t batch = 256;
+        std::vector<seneca::CustomerOrder> orders;
+        orders.reserve(batch);
+        size_t destroyed = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            for (size_t i = 0; i < batch; i++) {
+                orders.emplace_back(record);
+            }
+            state.resumeTiming();
+            orders.clear();
+            destroyed += batch;
+        }
+        state.setItemsProcessed(double(destroyed));
+    }
+
+    // Build a run's worth of orders and tear them down again, from the
+    // global heap or from a RunArena (teardown is then a single reset)
+    void buildOrderBatch(std::vector<seneca::CustomerOrder>& orders, size_t count)
+    {
+        static const std::vector<std::string> items = {"Bookcase", "Desk", "Office Chair", "Filing Cabinet"};
+        static std::vector<std::string> customers;
+        while (customers.size() < count) {
+            customers.push_back("Customer " + std::to_string(customers.size()));
+        }
+        for (size_t i = 0; i < count; i++) {
+            orders.emplace_back(customers[i], "Office", items);
+        }
+    }
+
+    void BM_OrderBatchHeap(State& state)
+    {
+        const size_t count = size_t(state.range());
+        std::vector<seneca::CustomerOrder> orders;
+        orders.reserve(count);
+        while (state.keepRunning()) {
+            buildOrderBatch(orders, count);
+            orders.clear();
+        }
+        state.setItemsProcessed(double(count) * double(state.iterations()));
+    }
+
+    void BM_OrderBatchArena(State& state)
+    {
+        const size_t count = size_t(state.range());
+        std::vector<seneca::CustomerOrder> orders;
+        orders.reserve(count);
+        seneca::RunArena arena;
+        while (state.keepRunning()) {
+            {
+                seneca::RunArena::Scope scope(arena);
+                buildOrderBatch(orders, count);
+            }
+            orders.clear();
+            arena.reset();
+        }
+        state.setItemsProcessed(double(count) * double(state.iterations()));
+    }
+
+    // ---------------------------------------------------------------------
+    // Workstation operations
+    // ---------------------------------------------------------------------
+
+    void BM_FillItem(State& state)
+    {
+        seneca::Utilities::setDelimiter(',');
+        const size_t batch = 1024;
+        std::vector<seneca::CustomerOrder> orders;
+        orders.reserve(batch);
+        size_t fills = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            seneca::Station station("Desk,100000," + std::to_string(batch) + ",Bench desk");
+            orders.clear();
+            for (size_t i = 0; i < batch; i++) {
+                orders.emplace_back("Cust,Office,Chair,Lamp,Desk,Shelf");
+            }
+            state.resumeTiming();
+            for (auto& order : orders) {
+                order.fillItem(station, g_null);
+            }
+            fills += batch;
+        }
+        state.setItemsProcessed(double(fills));
+    }
+
+    void BM_AttemptToMoveOrder(State& state)
+    {
+        seneca::Utilities::setDelimiter(',');
+        const size_t batch = 1024;
+        size_t moves = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            clearGlobals();
+            seneca::Workstation first("Desk,1,0,Empty so every order moves on");
+            seneca::Workstation last("Lamp,1,0,End of line");
+            first.setNextStation(&last);
+            for (size_t i = 0; i < batch; i++) {
+                first += seneca::CustomerOrder("Cust,Office,Desk,Lamp");
+            }
+            state.resumeTiming();
+            // Each order hops first -> last -> g_incomplete
+            while (first.attemptToMoveOrder()) {
+                last.attemptToMoveOrder();
+            }
+            while (last.attemptToMoveOrder()) {
+            }
+            moves += batch * 2;
+        }
+        clearGlobals();
+        state.setItemsProcessed(double(moves));
+    }
+
+    // ---------------------------------------------------------------------
+    // Whole-line runs
+    // ---------------------------------------------------------------------
+
+    // A straight line of `stations` stations with one order per 10 stations
+    // (at least 50); each order asks for four items spread along the line.
+    // One pass over a line of `stations` workstations, allocated one per
+    // heap block or contiguously from a StationRegistry
+    void runLine(State& state, bool contiguous, bool fast = false)
+    {
+        const size_t stations = size_t(state.range());
+        const size_t orders = std::max<size_t>(50, stations / 10);
+        seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+        size_t iterations = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            clearGlobals();
+            seneca::Utilities::setDelimiter(',');
+            std::vector<seneca::Station> specs;
+            std::vector<std::pair<std::string, std::string>> links;
+            specs.reserve(stations);
+            for (size_t i = 0; i < stations; i++) {
+                specs.emplace_back(itemName(i) + ",1," + std::to_string(orders / 2) + ",Bench");
+            }
+            for (size_t i = 0; i < stations; i++) {
+                links.emplace_back(itemName(i), i + 1 < stations ? itemName(i + 1) : "");
+            }
+            seneca::StationRegistry registry;
+            std::vector<seneca::Workstation*> line;
+            if (contiguous) {
+                registry = seneca::StationRegistry(specs);
+                line = registry.stations();
+            }
+            else {
+                for (const auto& spec : specs) {
+                    line.push_back(new seneca::Workstation(spec));
+                }
+            }
+            for (size_t o = 0; o < orders; o++) {
+                std::vector<std::string> items;
+                for (size_t k = 0; k < 4; k++) {
+                    items.push_back(itemName((o * 7 + k * stations / 4) % stations));
+                }
+                seneca::g_pending.push_back(seneca::CustomerOrder("Cust" + std::to_string(o), "Product", items));
+            }
+            seneca::LineManager lm(links, line);
+            state.resumeTiming();
+
+            if (fast) {
+                lm.fastForward();
+                iterations++;
+            }
+            else {
+                while (!lm.run(g_null)) {
+                    iterations++;
+                }
+            }
+
+            state.pauseTiming();
+            if (!contiguous) {
+                for (auto* ws : line) {
+                    delete ws;
+                }
+            }
+            clearGlobals();
+        }
+        state.setItemsProcessed(double(iterations));
+    }
+
+    void BM_LineManagerRun(State& state)
+    {
+        runLine(state, false);
+    }
+
+    void BM_LineManagerRunRegistry(State& state)
+    {
+        runLine(state, true);
+    }
+
+    // Same line and orders; items/s counts whole runs here, not iterations
+    void BM_LineManagerFastForward(State& state)
+    {
+        runLine(state, true, true);
+    }
+
+    // What-if query on a large scenario: one inventory change re-resolves
+    // only the orders whose items cross the old/new supply boundary
+    void BM_IncrementalSetQuantity(State& state)
+    {
+        seneca::GeneratorOptions options;
+        options.m_stations = 1000;
+        options.m_orders = size_t(state.range());
+        options.m_scarcity = 0.7;
+        options.m_seed = 42;
+        seneca::Scenario scenario = seneca::ScenarioGenerator(options).build();
+        seneca::IncrementalEngine engine(scenario);
+
+        uint64_t rng = 42;
+        size_t changed = 0;
+        while (state.keepRunning()) {
+            rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+            size_t station = size_t(rng >> 33) % engine.stationCount();
+            size_t quantity = size_t(rng >> 17) % (2 * engine.quantity(station) + 100);
+            seneca::OutcomeDiff diff = engine.setQuantity(station, quantity);
+            changed += diff.m_completed.size() + diff.m_incomplete.size();
+            doNotOptimize(diff);
+        }
+        doNotOptimize(changed);
+        state.setItemsProcessed(double(state.iterations()));
+    }
+
+    // Whole runs of one generated line; the range is the number of worker
+    // processes, 0 for fastForward() in this process as the reference
+    void BM_ShardedRun(State& state)
+    {
+        seneca::GeneratorOptions options;
+        options.m_stations = 1000;
+        options.m_orders = 200000;
+        options.m_scarcity = 0.7;
+        options.m_seed = 42;
+        seneca::Scenario scenario = seneca::ScenarioGenerator(options).build();
+        seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+        seneca::ShardOptions shard;
+        shard.m_segments = size_t(state.range());
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            seneca::SimulationContext context;
+            seneca::SimulationContext::Scope scope(context);
+            seneca::StationRegistry registry = scenario.createStations();
+            scenario.enqueueOrders();
+            seneca::LineManager lm(scenario.getLinks(), registry.stations());
+            state.resumeTiming();
+
+            if (shard.m_segments == 0) {
+                lm.fastForward();
+            }
+            else {
+                lm.runSharded(shard);
+            }
+            doNotOptimize(context.completed().size());
+
+            state.pauseTiming();
+            context.clearOrders();
+            state.resumeTiming();
+        }
+        state.setItemsProcessed(double(options.m_orders) * double(state.iterations()));
+    }
+
+    // Classic hold model: with range() events pending, pop the earliest and
+    // schedule one an exponential delay later. items/s counts pop + push.
+    template <typename Queue, typename Push, typename Pop>
+    void holdModel(State& state, Queue& queue, Push push, Pop pop)
+    {
+        uint64_t seed = 42;
+        auto delay = [&seed]()
+        {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            return -std::log(1.0 - double(seed >> 11) * (1.0 / 9007199254740992.0));
+        };
+        for (int64_t i = 0; i < state.range(); i++) {
+            push(queue, delay());
+        }
+        uint64_t holds = 0;
+        while (state.keepRunning()) {
+            for (int i = 0; i < 1000; i++) {
+                push(queue, pop(queue) + delay());
+            }
+            holds += 1000;
+        }
+        state.setItemsProcessed(double(holds));
+    }
+
+    void BM_CalendarQueueHold(State& state)
+    {
+        seneca::CalendarQueue calendar;
+        holdModel(state, calendar,
+                  [](seneca::CalendarQueue& q, double t) { q.push(t, 0, 0); },
+                  [](seneca::CalendarQueue& q) { return q.pop().m_time; });
+    }
+
+    // The same events in a binary heap, ordered by (time, seq) as well
+    void BM_PriorityQueueHold(State& state)
+    {
+        using Event = std::pair<double, uint64_t>;
+        std::priority_queue<Event, std::vector<Event>, std::greater<Event>> heap;
+        uint64_t seq = 0;
+        holdModel(state, heap,
+                  [&seq](decltype(heap)& q, double t) { q.push({t, seq++}); },
+                  [](decltype(heap)& q) { double t = q.top().first; q.pop(); return t; });
+    }
+
+    // Whole timed runs of a generated line with exponential service times;
+    // items/s counts calendar events
+    void BM_TimedRun(State& state)
+    {
+        seneca::GeneratorOptions options;
+        options.m_stations = 100;
+        options.m_orders = size_t(state.range());
+        options.m_scarcity = 0.9;
+        options.m_seed = 42;
+        options.m_serviceTime = "exp:1";
+        seneca::Scenario scenario = seneca::ScenarioGenerator(options).build();
+        seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+        seneca::TimedOptions timing;
+        timing.m_interarrival = {seneca::ServiceTime::Kind::EXPONENTIAL, 2.0, 0.0};
+        uint64_t events = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            seneca::SimulationContext context;
+            seneca::SimulationContext::Scope scope(context);
+            seneca::StationRegistry registry = scenario.createStations();
+            scenario.enqueueOrders();
+            seneca::LineManager lm(scenario.getLinks(), registry.stations());
+            state.resumeTiming();
+
+            events += lm.runTimed(timing).m_events;
+
+            state.pauseTiming();
+            context.clearOrders();
+            state.resumeTiming();
+        }
+        state.setItemsProcessed(double(events));
+    }
+
+    // Checkpoint of a line a third of the way through a run: every order
+    // queued somewhere, inventory and metrics partly consumed
+    void checkpointLine(State& state, bool restore)
+    {
+        seneca::GeneratorOptions options;
+        options.m_stations = 100;
+        options.m_orders = size_t(state.range());
+        options.m_seed = 42;
+        seneca::Scenario scenario = seneca::ScenarioGenerator(options).build();
+
+        clearGlobals();
+        seneca::RunArena arena;
+        seneca::RunArena::Scope arenaScope(arena);
+        seneca::StationRegistry registry = scenario.createStations();
+        std::vector<seneca::Workstation*> line = registry.stations();
+        scenario.enqueueOrders();
+        seneca::LineManager lm(scenario.getLinks(), line);
+        for (size_t i = 0; i < options.m_orders / 3; i++) {
+            lm.run(g_null);
+        }
+
+        std::string path = "/tmp/bench_assembly_line_" + std::to_string(::getpid()) + ".ckpt";
+        lm.saveCheckpoint(path);
+        while (state.keepRunning()) {
+            if (restore) {
+                lm.restoreCheckpoint(path);
+            }
+            else {
+                lm.saveCheckpoint(path);
+            }
+        }
+        std::remove(path.c_str());
+        clearGlobals();
+        state.setItemsProcessed(double(options.m_orders) * double(state.iterations()));
+    }
+
+    void BM_CheckpointSave(State& state)
+    {
+        checkpointLine(state, false);
+    }
+
+    void BM_CheckpointRestore(State& state)
+    {
+        checkpointLine(state, true);
+    }
+
+    // Text scenario load: stations on this thread, orders and links parsed
+    // on the loader's pool
+    void BM_ScenarioLoadText(State& state)
+    {
+        seneca::GeneratorOptions options;
+        options.m_stations = 100;
+        options.m_orders = size_t(state.range());
+        options.m_seed = 42;
+        std::string directory = "/tmp/bench_assembly_line_" + std::to_string(::getpid());
+        ::mkdir(directory.c_str(), 0755);
+        seneca::ScenarioGenerator(options).writeFiles(directory);
+
+        while (state.keepRunning()) {
+            seneca::SimulationContext context;
+            seneca::SimulationContext::Scope scope(context);
+            seneca::Scenario scenario(directory + "/Stations1.txt", directory + "/Stations2.txt",
+                                      directory + "/CustomerOrders.txt", directory + "/AssemblyLine.txt");
+            doNotOptimize(scenario);
+        }
+        for (const char* file : {"Stations1.txt", "Stations2.txt", "CustomerOrders.txt", "AssemblyLine.txt"}) {
+            std::remove((directory + "/" + file).c_str());
+        }
+        ::rmdir(directory.c_str());
+        state.setItemsProcessed(double(options.m_orders) * double(state.iterations()));
+    }
+
+    // ---------------------------------------------------------------------
+    // Post-run aggregation: per-product filled-item totals over the
+    // retired orders, walking the order objects vs. the column table
+    // ---------------------------------------------------------------------
+
+    void fillRetiredOrders(size_t count)
+    {
+        clearGlobals();
+        seneca::Utilities::setDelimiter(',');
+        for (size_t o = 0; o < count; o++) {
+            seneca::CustomerOrder order("Cust" + std::to_string(o), "Product" + std::to_string(o % 100),
+                                        {"Desk", "Chair", "Lamp", "Shelf"});
+            seneca::Station station("Desk,1,1,Bench");
+            order.fillItem(station, g_null);
+            seneca::g_completed.push_back(std::move(order));
+        }
+    }
+
+    void BM_AggregateOrderObjects(State& state)
+    {
+        const size_t count = size_t(state.range());
+        fillRetiredOrders(count);
+        while (state.keepRunning()) {
+            std::unordered_map<std::string, size_t> filled;
+            for (const auto& order : seneca::g_completed) {
+                filled[std::string(order.getProduct())] += order.getFilledItemCount();
+            }
+            doNotOptimize(filled);
+        }
+        clearGlobals();
+        state.setItemsProcessed(double(count) * double(state.iterations()));
+    }
+
+    void BM_AggregateOrderTable(State& state)
+    {
+        const size_t count = size_t(state.range());
+        fillRetiredOrders(count);
+        seneca::OrderTable table;
+        table.appendAll(seneca::g_completed, seneca::OrderOutcome::COMPLETED);
+        clearGlobals();
+        while (state.keepRunning()) {
+            auto summaries = table.summarizeByProduct();
+            doNotOptimize(summaries);
+        }
+        state.setItemsProcessed(double(count) * double(state.iterations()));
+    }
+
+    // ---------------------------------------------------------------------
+    // Persistence
+    // ---------------------------------------------------------------------
+
+    std::string benchDatabasePath()
+    {
+        return "/tmp/bench_assembly_line_" + std::to_string(::getpid()) + ".db";
+    }
+
+    std::vector<seneca::OrderRecord> makeRecords(size_t count)
+    {
+        std::vector<seneca::OrderRecord> records;
+        records.reserve(count);
+        for (size_t i = 0; i < count; i++) {
+            records.push_back(seneca::Database::makeOrderRecord("Cust" + std::to_string(i), "Product", i % 2 == 0, 3, 4));
+        }
+        return records;
+    }
+
+    void BM_DatabaseSaveOrderSingle(State& state)
+    {
+        const size_t count = size_t(state.range());
+        seneca::Database& db = seneca::Database::getInstance();
+        size_t saved = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            auto records = makeRecords(count);
+            state.resumeTiming();
+            for (const auto& record : records) {
+                saved += db.saveOrder(record) ? 1 : 0;
+            }
+        }
+        state.setItemsProcessed(double(saved));
+    }
+
+    void BM_DatabaseSaveOrdersBatched(State& state)
+    {
+        const size_t count = size_t(state.range());
+        seneca::Database& db = seneca::Database::getInstance();
+        size_t saved = 0;
+        while (state.keepRunning()) {
+            state.pauseTiming();
+            auto records = makeRecords(count);
+            state.resumeTiming();
+            saved += db.saveOrders(records);
+        }
+        state.setItemsProcessed(double(saved));
+    }
+
+    // ---------------------------------------------------------------------
+    // Runner and report
+    // ---------------------------------------------------------------------
+
+    struct Result
+    {
+        std::string name;
+        size_t iterations;
+        double realNs;
+        double cpuNs;
+        double itemsPerSecond;
+    };
+
+    Result runOne(const std::string& name, const std::function<void(State&)>& fn, long arg, double minTime)
+    {
+        size_t iterations = 1;
+        while (true) {
+            State state(iterations, arg);
+            fn(state);
+            double elapsed = state.realSeconds();
+            if (elapsed >= minTime || iterations >= 1000000000) {
+                double perIter = 1e9 / double(iterations);
+                double items = state.itemsProcessed();
+                return {name, iterations, elapsed * perIter, state.cpuSeconds() * perIter,
+                        elapsed > 0 && items > 0 ? items / elapsed : 0.0};
+            }
+            // Same growth rule as Google Benchmark: aim 40% past the target, at most 10x
+            double multiplier = elapsed > 0 ? minTime * 1.4 / elapsed : 10.0;
+            multiplier = std::min(10.0, std::max(multiplier, 1.0 + 1e-9));
+            size_t next = size_t(double(iterations) * multiplier);
+            iterations = std::max(next, iterations + 1);
+        }
+    }
+
+    std::string timestamp()
+    {
+        std::time_t now = std::time(nullptr);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S%z", std::localtime(&now));
+        return buf;
+    }
+
+    void writeJson(std::ostream& os, const std::vector<Result>& results, const char* executable)
+    {
+        os << "{\n"
+           << "  \"context\": {\n"
+           << "    \"date\": \"" << timestamp() << "\",\n"
+           << "    \"executable\": \"" << seneca::escapeJson(executable) << "\",\n"
+           << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+           << "    \"library_build_type\": \"release\"\n"
+#else
+           << "    \"library_build_type\": \"debug\"\n"
+#endif
+           << "  },\n"
+           << "  \"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            const Result& r = results[i];
+            os << "    {\n"
+               << "      \"name\": \"" << seneca::escapeJson(r.name) << "\",\n"
+               << "      \"run_name\": \"" << seneca::escapeJson(r.name) << "\",\n"
+               << "      \"run_type\": \"iteration\",\n"
+               << "      \"iterations\": " << r.iterations << ",\n"
+               << std::fixed << std::setprecision(3)
+               << "      \"real_time\": " << r.realNs << ",\n"
+               << "      \"cpu_time\": " << r.cpuNs << ",\n"
+               << "      \"time_unit\": \"ns\"";
+            if (r.itemsPerSecond > 0) {
+                os << ",\n      \"items_per_second\": " << r.itemsPerSecond;
+            }
+            os << "\n    }" << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+        os << "  ]\n}\n";
+        os.unsetf(std::ios::floatfield);
+    }
+
+    bool flagValue(const std::string& arg, const std::string& flag, std::string& value)
+    {
+        std::string prefix = "--" + flag + "=";
+        if (arg.compare(0, prefix.size(), prefix) == 0) {
+            value = arg.substr(prefix.size());
+            return true;
+        }
+        return false;
+    }
+} // namespace
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    std::string outFile;
+    double minTime = 0.5;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string value;
+        if (flagValue(arg, "benchmark_filter", value)) {
+            filter = value;
+        }
+        else if (flagValue(arg, "benchmark_out", value)) {
+            outFile = value;
+        }
+        else if (flagValue(arg, "benchmark_min_time", value)) {
+            // Accept both "0.5" and Google Benchmark's newer "0.5s"
+            if (!value.empty() && value.back() == 's') {
+                value.pop_back();
+            }
+            minTime = std::stod(value);
+        }
+        else if (arg == "--help" || arg == "-h") {
+            std::cout << "Usage: " << argv[0]
+                      << " [--benchmark_filter=<substring>] [--benchmark_min_time=<seconds>]"
+                      << " [--benchmark_out=<file.json>]\n";
+            return 0;
+        }
+        else {
+            std::cerr << "ERROR: Unknown argument: " << arg << "\n";
+            return 1;
+        }
+    }
+
+    seneca::Logger::getInstance().enableConsoleOutput(false);
+    seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+    registerBenchmark("BM_ExtractToken", BM_ExtractToken);
+    registerBenchmark("BM_ParseDirtyOrdersThrowing", BM_ParseDirtyOrdersThrowing, {10000});
+    registerBenchmark("BM_ParseDirtyOrdersStatus", BM_ParseDirtyOrdersStatus, {10000});
+    registerBenchmark("BM_CustomerOrderConstruct", BM_CustomerOrderConstruct);
+    registerBenchmark("BM_CustomerOrderMove", BM_CustomerOrderMove);
+    registerBenchmark("BM_CustomerOrderDestroy", BM_CustomerOrderDestroy);
+    registerBenchmark("BM_OrderBatchHeap", BM_OrderBatchHeap, {10000});
+    registerBenchmark("BM_OrderBatchArena", BM_OrderBatchArena, {10000});
+    registerBenchmark("BM_FillItem", BM_FillItem);
+    registerBenchmark("BM_AttemptToMoveOrder", BM_AttemptToMoveOrder);
+    registerBenchmark("BM_LineManagerRun", BM_LineManagerRun, {10, 100, 1000, 10000});
+    registerBenchmark("BM_LineManagerRunRegistry", BM_LineManagerRunRegistry, {10, 100, 1000, 10000});
+    registerBenchmark("BM_LineManagerFastForward", BM_LineManagerFastForward, {10, 100, 1000, 10000});
+    registerBenchmark("BM_ShardedRun", BM_ShardedRun, {0, 1, 2, 4});
+    registerBenchmark("BM_CalendarQueueHold", BM_CalendarQueueHold, {1000, 100000, 1000000});
+    registerBenchmark("BM_PriorityQueueHold", BM_PriorityQueueHold, {1000, 100000, 1000000});
+    registerBenchmark("BM_TimedRun", BM_TimedRun, {10000, 100000});
+    registerBenchmark("BM_IncrementalSetQuantity", BM_IncrementalSetQuantity, {1000000});
+    registerBenchmark("BM_CheckpointSave", BM_CheckpointSave, {10000, 100000});
+    registerBenchmark("BM_CheckpointRestore", BM_CheckpointRestore, {10000, 100000});
+    registerBenchmark("BM_ScenarioLoadText", BM_ScenarioLoadText, {100000, 1000000});
+    registerBenchmark("BM_AggregateOrderObjects", BM_AggregateOrderObjects, {100000});
+    registerBenchmark("BM_AggregateOrderTable", BM_AggregateOrderTable, {100000});
+    registerBenchmark("BM_DatabaseSaveOrderSingle", BM_DatabaseSaveOrderSingle, {100});
+    registerBenchmark("BM_DatabaseSaveOrdersBatched", BM_DatabaseSaveOrdersBatched, {100});
+
+    // Only open the scratch database when a persistence benchmark is selected
+    bool needsDatabase = false;
+    for (const auto& bench : registry()) {
+        if (bench.name.compare(0, 11, "BM_Database") == 0 &&
+            (filter.empty() || (bench.name + "/").find(filter) != std::string::npos ||
+             filter.find(bench.name) != std::string::npos)) {
+            needsDatabase = true;
+        }
+    }
+    std::string dbPath = benchDatabasePath();
+    if (needsDatabase && !seneca::Database::getInstance().initialize(dbPath)) {
+        std::cerr << "ERROR: Could not open benchmark database " << dbPath << "\n";
+        return 1;
+    }
+
+    std::vector<Result> results;
+    std::cout << std::left << std::setw(40) << "Benchmark" << std::right
+              << std::setw(16) << "Time (ns)" << std::setw(16) << "CPU (ns)"
+              << std::setw(14) << "Iterations" << std::setw(18) << "items/s" << "\n";
+    std::cout << std::string(104, '-') << "\n";
+
+    for (const auto& bench : registry()) {
+        std::vector<long> args = bench.args.empty() ? std::vector<long>{0} : bench.args;
+        for (long arg : args) {
+            std::string name = bench.name + (bench.args.empty() ? "" : "/" + std::to_string(arg));
+            if (!filter.empty() && name.find(filter) == std::string::npos) {
+                continue;
+            }
+            Result r = runOne(name, bench.fn, arg, minTime);
+            std::cout << std::left << std::setw(40) << r.name << std::right << std::fixed << std::setprecision(0)
+                      << std::setw(16) << r.realNs << std::setw(16) << r.cpuNs
+                      << std::setw(14) << r.iterations << std::setw(18) << r.itemsPerSecond << "\n";
+            results.push_back(r);
+        }
+    }
+
+    if (needsDatabase) {
+        seneca::Database::getInstance().close();
+        std::remove(dbPath.c_str());
+    }
+
+    if (!outFile.empty()) {
+        std::ofstream out(outFile);
+        if (!out) {
+            std::cerr << "ERROR: Could not write " << outFile << "\n";
+            return 1;
+        }
+        writeJson(out, results, argv[0]);
+    }
+    return 0;
+}
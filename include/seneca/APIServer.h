@@ -2,6 +2,7 @@
 #define SENECA_APISERVER_H
 
 #include <string>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <functional>
@@ -11,6 +12,10 @@ namespace seneca
 {
     class Database;
 
+    // Handler for a dynamic route. Receives the request body and returns a
+    // JSON document. Throwing yields a 500 response with the message.
+    using RouteHandler = std::function<std::string(const std::string& body)>;
+
     class APIServer
     {
     private:
@@ -18,8 +23,8 @@ namespace seneca
         static std::mutex s_mutex;
 
         int m_port;
-        bool m_running;
-        void* m_server; // Opaque pointer to avoid including httplib.h in header
+        std::atomic<bool> m_running;
+        void* m_server; // Opaque pointer to keep socket/epoll details out of the header
 
         APIServer();
         APIServer(const APIServer&) = delete;
@@ -27,19 +32,34 @@ namespace seneca
 
     public:
         ~APIServer();
-        
+
         static APIServer& getInstance();
 
-        // Server control
+        // Server control. Binds to the loopback interface unless another
+        // address is given; port 0 picks a free port (see getPort()).
         bool start(int port = 8080);
+        bool start(int port, const std::string& bindAddress, int threads = 2);
         void stop();
         bool isRunning() const { return m_running; }
         int getPort() const { return m_port; }
 
+        // Routes. Published documents are served as-is for GET requests and
+        // can be replaced at any time from any thread without blocking
+        // readers; handlers are invoked on the server's worker threads.
+        void publish(const std::string& path, const std::string& json);
+        void addRoute(const std::string& method, const std::string& path, RouteHandler handler);
+
+        // Long-running routes. The request is answered at once with 202 and
+        // the handler runs on the server's executor thread, one job at a
+        // time; a request arriving while a job runs gets 409. When the job
+        // ends, its result (or {"detail": error}) is published as the GET
+        // document of the same path.
+        void addJob(const std::string& method, const std::string& path, RouteHandler handler);
+        bool isJobRunning() const;
+
         // Status
         std::string getStatus() const;
     };
 } // namespace seneca
 
 #endif // SENECA_APISERVER_H
-
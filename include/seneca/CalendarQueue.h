@@ -0,0 +1,60 @@
+#ifndef SENECA_CALENDARQUEUE_H
+#define SENECA_CALENDARQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace seneca
+{
+    struct TimedEvent
+    {
+        double m_time;
+        uint64_t m_seq;         // Scheduling order, so equal times pop first in, first out
+        uint32_t m_target;
+        uint32_t m_kind;
+    };
+
+    // Pending event set of a discrete-event run: a calendar queue (Brown,
+    // 1988). Time is cut into days of m_width; day d lives in bucket
+    // d mod bucket count, and a bucket is a small min-heap on (time, seq).
+    // pop() walks the days from the last event popped, so while the
+    // bucket count tracks the number of events and the width their
+    // spacing, push() and pop() are O(1) amortized. The calendar is
+    // rebuilt, with a width re-estimated from the earliest events, when
+    // the event count leaves [buckets / 2, buckets * 2]; a whole year
+    // without an event due falls back to a search of the bucket heads.
+    //
+    // Events must not be scheduled before the last one popped.
+    class CalendarQueue {
+        std::vector<std::vector<TimedEvent>> m_buckets;
+        size_t m_mask{};
+        double m_width{1.0};
+        double m_inverse{1.0};
+        uint64_t m_day{};           // No event is due before this day
+        size_t m_size{};
+        uint64_t m_nextSeq{};
+        uint64_t m_resizes{};
+
+        uint64_t dayOf(double time) const;
+        void resize(size_t buckets);
+
+        public:
+            static constexpr size_t MIN_BUCKETS = 16;
+
+            // `width` is a first guess at the spacing of events
+            explicit CalendarQueue(double width = 1.0);
+
+            void push(double time, uint32_t target, uint32_t kind);
+            // Earliest event, first scheduled on a tie; the queue must not be empty
+            TimedEvent pop();
+
+            bool empty() const { return m_size == 0; }
+            size_t size() const { return m_size; }
+            size_t bucketCount() const { return m_buckets.size(); }
+            double width() const { return m_width; }
+            uint64_t resizeCount() const { return m_resizes; }
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef SENECA_CHECKPOINT_H
+#define SENECA_CHECKPOINT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include "seneca/MappedFile.h"
+
+namespace seneca
+{
+    // Binary snapshot of a line mid-run (see LineManager::saveCheckpoint).
+    //
+    // Layout, native byte order, every section 8-byte aligned:
+    //   CheckpointHeader
+    //   CheckpointStation[m_stationCount]   active line order
+    //   CheckpointOrder[m_orderCount]       pending queue, then each
+    //                                       station's queue in line order,
+    //                                       then completed, then incomplete
+    //   CheckpointItem[m_itemCount]         each order's items, contiguous
+    //   char[m_stringBytes]                 names, each stored once
+    //
+    // Records are fixed size and hold no pointers, so a mapped file is read
+    // in place. Bump CHECKPOINT_VERSION whenever a record changes.
+    constexpr uint32_t CHECKPOINT_MAGIC = 0x4B434C41;       // "ALCK"
+    constexpr uint16_t CHECKPOINT_VERSION = 1;
+    constexpr uint16_t CHECKPOINT_BYTE_ORDER = 0x0102;
+
+    struct CheckpointString
+    {
+        uint32_t m_offset;
+        uint32_t m_length;
+    };
+
+    struct CheckpointHeader
+    {
+        uint32_t m_magic;
+        uint16_t m_version;
+        uint16_t m_byteOrder;
+        uint64_t m_fileSize;
+        uint64_t m_checksum;        // checksum64() of the sections, then of this header with m_checksum = 0
+        uint64_t m_iteration;
+        uint64_t m_orderTotal;      // Orders the run started with
+        uint32_t m_stationCount;
+        uint32_t m_orderCount;
+        uint32_t m_itemCount;
+        uint32_t m_stringBytes;
+        uint32_t m_pending;
+        uint32_t m_completed;
+        uint32_t m_incomplete;
+        uint32_t m_reserved;
+    };
+
+    struct CheckpointStation
+    {
+        CheckpointString m_name;
+        uint32_t m_queued;          // Orders in this station's queue
+        uint32_t m_reserved;
+        uint64_t m_serialNumber;
+        uint64_t m_quantity;
+        uint64_t m_fills;
+        uint64_t m_failedFills;
+        uint64_t m_ordersPassed;
+        uint64_t m_maxQueueDepth;
+        uint64_t m_queueDepthSum;
+        uint64_t m_busyTicks;
+        uint64_t m_idleTicks;
+    };
+
+    struct CheckpointOrder
+    {
+        CheckpointString m_name;
+        CheckpointString m_product;
+        uint32_t m_firstItem;
+        uint32_t m_itemCount;
+        uint64_t m_entryTick;
+        uint64_t m_retireTick;
+        int64_t m_entryTimeNs;
+        int64_t m_retireTimeNs;
+        uint8_t m_retired;
+        uint8_t m_reserved[7];
+    };
+
+    struct CheckpointItem
+    {
+        CheckpointString m_name;
+        uint64_t m_serialNumber;
+        uint8_t m_filled;
+        uint8_t m_reserved[7];
+    };
+
+    static_assert(sizeof(CheckpointHeader) == 72, "checkpoint header layout changed");
+    static_assert(sizeof(CheckpointStation) == 88, "checkpoint station layout changed");
+    static_assert(sizeof(CheckpointOrder) == 64, "checkpoint order layout changed");
+    static_assert(sizeof(CheckpointItem) == 24, "checkpoint item layout changed");
+
+    // Assembles a checkpoint in memory and writes it in one go. The file is
+    // written next to the target and renamed over it once synced, so a
+    // crash mid-write leaves the previous checkpoint intact. Text passed to
+    // addString() must stay valid until write() returns.
+    class CheckpointWriter {
+        CheckpointHeader m_header{};
+        std::vector<CheckpointStation> m_stations{};
+        std::vector<CheckpointOrder> m_orders{};
+        std::vector<CheckpointItem> m_items{};
+        std::string m_strings{};
+        std::unordered_map<std::string_view, CheckpointString> m_stringRefs{};
+
+        public:
+            CheckpointWriter(uint64_t iteration, uint64_t orderTotal);
+            CheckpointWriter(const CheckpointWriter&) = delete;
+            CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+            void reserve(size_t stations, size_t orders, size_t items);
+
+            // Shared text (products, item names) is stored once; text that
+            // rarely repeats (customer names) skips the lookup
+            CheckpointString addString(std::string_view text);
+            CheckpointString addUniqueString(std::string_view text);
+            CheckpointStation& addStation();
+            CheckpointOrder& addOrder();
+            CheckpointItem& addItem();
+            CheckpointHeader& header() { return m_header; }
+
+            void write(const std::string& path);
+    };
+
+    // Read-only mapping of a checkpoint file. Opening checks the magic,
+    // version, byte order, size and checksum and throws FileException on
+    // any mismatch; after that every accessor reads the mapping in place.
+    class CheckpointReader {
+        MappedFile m_file;
+        const CheckpointHeader* m_header{};
+        const CheckpointStation* m_stations{};
+        const CheckpointOrder* m_orders{};
+        const CheckpointItem* m_items{};
+        const char* m_strings{};
+
+        public:
+            explicit CheckpointReader(const std::string& path);
+
+            const CheckpointHeader& header() const { return *m_header; }
+            const CheckpointStation& station(size_t i) const { return m_stations[i]; }
+            const CheckpointOrder& order(size_t i) const { return m_orders[i]; }
+            const CheckpointItem& item(size_t i) const { return m_items[i]; }
+            std::string_view string(CheckpointString ref) const { return {m_strings + ref.m_offset, ref.m_length}; }
+    };
+} // namespace seneca
+
+#endif
@@ -7,34 +7,85 @@
 #include <sstream>
 #include <memory>
 #include <mutex>
+#include <functional>
+#include <vector>
+#include <thread>
+#include <atomic>
 
 namespace seneca
 {
+    using ConfigMap = std::unordered_map<std::string, std::string>;
+
+    // Immutable view of the configuration at one point in time. Readers keep
+    // the snapshot alive for as long as they need consistent values; reloads
+    // publish a new snapshot instead of mutating the old one.
+    using ConfigSnapshot = std::shared_ptr<const ConfigMap>;
+
+    // Invoked with the new value (empty if the key was removed)
+    using ConfigCallback = std::function<void(const std::string& value)>;
+
     class Config
     {
     private:
+        struct Subscriber
+        {
+            size_t id;
+            std::string key;
+            ConfigCallback callback;
+        };
+
         static std::unique_ptr<Config> s_instance;
         static std::mutex s_mutex;
-        std::unordered_map<std::string, std::string> m_config;
+
+        // Held by every change from reading the current snapshot until its
+        // subscribers have been notified, so concurrent changes neither lose
+        // each other's keys nor reach subscribers out of order
+        std::mutex m_writeMutex;
+
+        mutable std::mutex m_dataMutex;
+        ConfigSnapshot m_snapshot;
         std::string m_configFile;
 
+        std::mutex m_subscriberMutex;
+        std::vector<Subscriber> m_subscribers;
+        size_t m_nextSubscriberId;
+
+        std::thread m_watcher;
+        std::atomic<bool> m_watching;
+        int m_wakeFd[2];
+
         Config();
-        
+
         // Delete copy constructor and assignment operator
         Config(const Config&) = delete;
         Config& operator=(const Config&) = delete;
 
+        bool parseFile(const std::string& filename, ConfigMap& out) const;
+        void publish(ConfigSnapshot next);  // Caller holds m_writeMutex
+        void update(const std::string& key, const std::string& value);
+        void watchLoop();
+
     public:
-        ~Config() = default;
+        ~Config();
         static Config& getInstance();
-        
+
         // Load configuration from file (simple key=value format)
         bool loadFromFile(const std::string& filename);
-        
+
+        // Re-read the last loaded file into a fresh snapshot and notify
+        // subscribers of every key whose value changed
+        bool reload();
+
+        // Current configuration snapshot (cheap, lock held only for the copy)
+        ConfigSnapshot snapshot() const;
+
         // Get configuration values
         std::string getString(const std::string& key, const std::string& defaultValue = "") const;
         int getInt(const std::string& key, int defaultValue = 0) const;
         bool getBool(const std::string& key, bool defaultValue = false) const;
+
+        // The true/false spellings getBool() accepts; anything else is defaultValue
+        static bool parseBool(const std::string& value, bool defaultValue);
         double getDouble(const std::string& key, double defaultValue = 0.0) const;
 
         // Set configuration values
@@ -51,8 +102,21 @@ namespace seneca
 
         // Clear all configuration
         void clear();
+
+        // Change notifications. Callbacks run on the thread that applied the
+        // change (the watcher thread for file reloads), one change at a time
+        // and in the order the changes were made. They may read the
+        // configuration but must not block or change it.
+        size_t subscribe(const std::string& key, ConfigCallback callback);
+        void unsubscribe(size_t id);
+
+        // Watch the loaded file for modifications (inotify on Linux) and
+        // reload it in the background. Returns false if watching is not
+        // supported on this platform or no file has been loaded.
+        bool startWatching();
+        void stopWatching();
+        bool isWatching() const { return m_watching; }
     };
 } // namespace seneca
 
 #endif // SENECA_CONFIG_H
-
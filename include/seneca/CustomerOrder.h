@@ -2,6 +2,8 @@
 #define SENECA_CUSTOMERORDER_H
 #include <iostream>
 #include <vector>
+#include <cstdint>
+#include <string_view>
 #include "seneca/Utilities.h"
 #include "seneca/Station.h"
 
@@ -9,37 +11,70 @@ namespace seneca
 {
     struct Item
     {
-        std::string m_itemName;
+        std::string_view m_itemName;
         size_t m_serialNumber{0};
         bool m_isFilled{false};
 
-        Item(const std::string &src) : m_itemName(src) {};
+        Item(std::string_view src) : m_itemName(src) {};
     };
 
     class CustomerOrder {
-        std::string m_name{};
-        std::string m_product{};
+        // Names and items point into either the current RunArena or, for
+        // orders built outside a run, one heap block owned by the order:
+        // [Item array][name and item characters]
+        std::string_view m_name{};
+        std::string_view m_product{};
         size_t m_cntItem{};
-        Item** m_lstItem{};
-        static size_t m_widthField;
+        Item* m_lstItem{};
+        void* m_heapBlock{};
+
+        // Line entry/retire stamps: LineManager iteration and steady-clock ns
+        size_t m_entryTick{};
+        size_t m_retireTick{};
+        int64_t m_entryTimeNs{};
+        int64_t m_retireTimeNs{};
+        bool m_retired{};
+
+        template <typename ItemNames>
+        void build(std::string_view name, std::string_view product, const ItemNames& items);
+        template <typename ItemNames>
+        void raiseOrderWidth(std::string_view name, std::string_view product, const ItemNames& items) const;
+        void release();
 
         public : 
             CustomerOrder() = default;
             CustomerOrder(const std::string& str);
+            CustomerOrder(const std::string& str, char delimiter);
+            CustomerOrder(const std::string& name, const std::string& product, const std::vector<std::string>& items);
+            CustomerOrder(std::string_view name, std::string_view product, const std::vector<std::string_view>& items);
             CustomerOrder(CustomerOrder&& customer) noexcept;
             CustomerOrder(const CustomerOrder& customer);
             CustomerOrder& operator=(CustomerOrder&& customer) noexcept;
             ~CustomerOrder();
             bool isOrderFilled() const;
             bool isItemFilled(const std::string& itemName) const;
-            void fillItem(Station& station, std::ostream& os);
+            // Fills the first unfilled item the station supplies; true if
+            // it took a unit
+            bool fillItem(Station& station, std::ostream& os);
             void display(std::ostream& os) const;
             
             // Getters for database integration
-            const std::string& getCustomerName() const { return m_name; }
-            const std::string& getProduct() const { return m_product; }
+            std::string_view getCustomerName() const { return m_name; }
+            std::string_view getProduct() const { return m_product; }
             size_t getItemCount() const { return m_cntItem; }
+            const Item& getItem(size_t i) const { return m_lstItem[i]; }
+            void setItemFilled(size_t i, size_t serialNumber);
             size_t getFilledItemCount() const;
+
+            // Latency stamps (see LatencyRecorder)
+            void markEntry(size_t tick);
+            void markRetired(size_t tick);
+            void restoreStamps(size_t entryTick, int64_t entryTimeNs, size_t retireTick, int64_t retireTimeNs, bool retired);
+            bool hasRetired() const { return m_retired; }
+            size_t getEntryTick() const { return m_entryTick; }
+            size_t getRetireTick() const { return m_retireTick; }
+            int64_t getEntryTimeNs() const { return m_entryTimeNs; }
+            int64_t getRetireTimeNs() const { return m_retireTimeNs; }
     };
 } // namespace seneca
 
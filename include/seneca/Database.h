@@ -5,11 +5,15 @@
 #include <memory>
 #include <mutex>
 #include <vector>
+#include <utility>
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 namespace seneca
 {
+    struct LatencySummary;
+
     struct OrderRecord
     {
         std::string customerName;
@@ -27,6 +31,14 @@ namespace seneca
         size_t itemsProcessed;
         size_t inventoryRemaining;
         std::string timestamp;
+
+        // Runtime counters from the simulation (see StationMetrics)
+        size_t failedFills{0};
+        size_t ordersPassed{0};
+        size_t maxQueueDepth{0};
+        double meanQueueDepth{0.0};
+        size_t busyTicks{0};
+        size_t idleTicks{0};
     };
 
     class Database
@@ -40,8 +52,15 @@ namespace seneca
         bool m_initialized;
         mutable std::string m_lastError;
 
+        // Pragma changes from other threads (config hot reload), applied by
+        // the thread that owns the connection; see queuePragma()
+        std::mutex m_pragmaMutex;
+        std::vector<std::pair<std::string, std::string>> m_queuedPragmas;
+
         Database();
         Database(const Database&) = delete;
+        bool ensureColumn(const std::string& table, const std::string& column, const std::string& definition);
+        bool insertOrder(sqlite3_stmt* stmt, const OrderRecord& order, const std::string& completedAt);
         Database& operator=(const Database&) = delete;
 
     public:
@@ -60,6 +79,12 @@ namespace seneca
 
         // Order operations
         bool saveOrder(const OrderRecord& order);
+        size_t saveOrders(const std::vector<OrderRecord>& orders);  // One transaction; returns rows saved
+        static OrderRecord makeOrderRecord(const std::string& customerName,
+                                           const std::string& product,
+                                           bool completed,
+                                           size_t filledItems,
+                                           size_t totalItems);
         bool saveOrderCompletion(const std::string& customerName, 
                                  const std::string& product, 
                                  bool completed,
@@ -72,6 +97,9 @@ namespace seneca
 
         // Station operations
         bool saveStationStatus(const StationRecord& station);
+
+        // Latency percentiles for one run (one transaction); returns rows saved
+        size_t saveLatencySummaries(const std::vector<LatencySummary>& summaries);
         bool updateStationInventory(const std::string& stationName, size_t inventory);
         std::vector<StationRecord> getStationHistory(const std::string& stationName, size_t limit = 100);
 
@@ -85,6 +113,13 @@ namespace seneca
         
         // Utility
         bool executeQuery(const std::string& query);
+        bool setPragma(const std::string& name, const std::string& value);
+
+        // The connection is only used by the thread running simulations, so
+        // other threads queue pragma changes here; that thread applies them
+        // with applyQueuedPragmas() between runs, outside any transaction
+        void queuePragma(const std::string& name, const std::string& value);
+        void applyQueuedPragmas();
         std::string getLastError() const;
     };
 } // namespace seneca
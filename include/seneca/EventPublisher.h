@@ -0,0 +1,73 @@
+#ifndef SENECA_EVENTPUBLISHER_H
+#define SENECA_EVENTPUBLISHER_H
+
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+namespace seneca
+{
+    // Live progress stream for dashboards. The simulation thread hands over
+    // rendered frames; a background thread fans them out to any number of
+    // clients connected to a local Unix socket, using Server-Sent Events
+    // framing ("event: ...\ndata: {...}\n\n").
+    //
+    // Publishing never blocks the simulation: frames are rate limited, a new
+    // frame replaces one that has not been sent yet, and a client that cannot
+    // keep up misses intermediate frames but, once its socket drains, always
+    // receives the latest one (so the final "complete" frame is never lost).
+    class EventPublisher
+    {
+    private:
+        static std::unique_ptr<EventPublisher> s_instance;
+        static std::mutex s_mutex;
+
+        std::atomic<bool> m_active;
+        std::atomic<long long> m_nextFrameDue;  // steady_clock ticks
+        long long m_interval;
+
+        std::mutex m_frameMutex;
+        std::string m_pendingFrame;
+        std::atomic<unsigned long long> m_framesPublished;
+        std::atomic<unsigned long long> m_framesCoalesced;
+
+        std::string m_socketPath;
+        int m_listenFd;
+        int m_wakeFd[2];
+        std::thread m_thread;
+
+        EventPublisher();
+        EventPublisher(const EventPublisher&) = delete;
+        EventPublisher& operator=(const EventPublisher&) = delete;
+
+        void serveLoop();
+        void wake();
+
+    public:
+        ~EventPublisher();
+
+        static EventPublisher& getInstance();
+
+        // Listen on a Unix socket and send at most maxRateHz frames per second.
+        // Returns false if another process is still serving the socket.
+        bool start(const std::string& socketPath, double maxRateHz = 10.0);
+        void stop();
+        bool isActive() const { return m_active; }
+
+        // Cheap check for the producer: true (once per interval) when the
+        // next frame should be rendered. Always false while inactive.
+        bool frameDue();
+
+        // Queue a frame for delivery. Not rate limited itself: producers use
+        // frameDue() for periodic frames and publish final frames directly.
+        void publish(const std::string& event, const std::string& json);
+
+        unsigned long long getFramesPublished() const { return m_framesPublished; }
+        unsigned long long getFramesCoalesced() const { return m_framesCoalesced; }
+    };
+} // namespace seneca
+
+#endif // SENECA_EVENTPUBLISHER_H
@@ -0,0 +1,84 @@
+#ifndef SENECA_INCREMENTALENGINE_H
+#define SENECA_INCREMENTALENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "seneca/Scenario.h"
+
+namespace seneca
+{
+    // Orders whose outcome changed with one inventory update. Orders are
+    // identified by their index in Scenario::getOrders()
+    struct OutcomeDiff
+    {
+        std::vector<size_t> m_completed{};      // Incomplete before, complete now
+        std::vector<size_t> m_incomplete{};     // Complete before, incomplete now
+        size_t m_itemsFilled{};
+        size_t m_itemsUnfilled{};
+    };
+
+    // Final line outcome kept up to date under inventory changes.
+    //
+    // As LineManager::fastForward relies on, every station on the chain
+    // serves orders in pending order, so the demand for one item name is a
+    // fixed sequence: every unit ordered, in order and item order. With T
+    // units stocked by the stations of that name, exactly the first T
+    // demand units are filled, station by station in chain order. The
+    // engine records each item's rank in its name's demand sequence; a
+    // quantity change moves T and flips only the items between the old
+    // and the new T, so an update costs O(flipped items), independent of
+    // how many orders the scenario holds.
+    //
+    // Lines with forks are refused with a ValidationException. The
+    // scenario must outlive the engine. Not synchronized.
+    class IncrementalEngine {
+        struct Supply
+        {
+            std::vector<size_t> m_stations{};   // Chain order; indices into the scenario's stations
+            size_t m_total{};                   // Units stocked over those stations
+            std::vector<uint32_t> m_demand{};   // Ordering order of every demanded unit
+        };
+
+        const Scenario& m_scenario;
+        std::vector<size_t> m_quantity{};       // Current inventory per station
+        std::vector<uint32_t> m_supplyOf{};     // Station -> supply, or NO_SUPPLY when off the chain
+        std::vector<Supply> m_supplies{};
+        std::vector<uint64_t> m_itemOffset{0};  // Order i owns items [m_itemOffset[i], m_itemOffset[i + 1])
+        std::vector<uint32_t> m_itemSupply{};   // Per item, NO_SUPPLY when no station makes it
+        std::vector<uint32_t> m_itemRank{};     // Per item, position in its supply's demand
+        std::vector<uint32_t> m_missing{};      // Per order, items left unfilled
+        size_t m_completed{};
+
+        static constexpr uint32_t NO_SUPPLY = UINT32_MAX;
+
+        std::vector<size_t> resolveChain() const;
+        bool isFilled(uint64_t item) const;
+
+        public:
+            explicit IncrementalEngine(const Scenario& scenario);
+
+            size_t stationCount() const { return m_quantity.size(); }
+            size_t orderCount() const { return m_missing.size(); }
+            size_t completedCount() const { return m_completed; }
+            size_t incompleteCount() const { return orderCount() - m_completed; }
+            bool isCompleted(size_t order) const { return m_missing[order] == 0; }
+
+            // Item i of order `order` (as listed in its OrderSpec)
+            bool isItemFilled(size_t order, size_t i) const { return isFilled(m_itemOffset[order] + i); }
+            size_t itemSerial(size_t order, size_t i) const;
+
+            // Inventory at the start of the run and what the run leaves
+            size_t quantity(size_t station) const { return m_quantity[station]; }
+            size_t remainingQuantity(size_t station) const;
+
+            // Index of the (first) station handing out itemName, or npos
+            size_t findStation(const std::string& itemName) const;
+            static constexpr size_t npos = static_cast<size_t>(-1);
+
+            OutcomeDiff setQuantity(size_t station, size_t quantity);
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef SENECA_LATENCYHISTOGRAM_H
+#define SENECA_LATENCYHISTOGRAM_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <map>
+#include <iostream>
+#include "seneca/CustomerOrder.h"
+#include "seneca/OrderPool.h"
+
+namespace seneca
+{
+    // Log-linear histogram in the style of HdrHistogram: every power of two
+    // is split into 16 equal sub-buckets, so any recorded value is reported
+    // within ~6% (1/16) of its true value while the whole 64-bit range fits
+    // in under a thousand counters. Buckets are allocated on demand, so
+    // histograms of small values (ticks) stay small.
+    class LatencyHistogram {
+        std::vector<uint64_t> m_counts{};
+        uint64_t m_total{};
+        uint64_t m_min{UINT64_MAX};
+        uint64_t m_max{};
+        long double m_sum{};
+
+        public:
+            static constexpr unsigned SUB_BUCKET_BITS = 5;
+
+            static size_t bucketIndex(uint64_t value);
+            static uint64_t bucketLowest(size_t index);
+            static uint64_t bucketHighest(size_t index);
+
+            void record(uint64_t value, uint64_t count = 1);
+            void merge(const LatencyHistogram& other);
+            void reset();
+
+            // Highest value equivalent to the recorded value at quantile q
+            // (0 < q <= 1), capped at the largest value actually recorded
+            uint64_t percentile(double q) const;
+
+            uint64_t count() const { return m_total; }
+            uint64_t min() const { return m_total ? m_min : 0; }
+            uint64_t max() const { return m_max; }
+            double mean() const { return m_total ? double(m_sum / m_total) : 0.0; }
+    };
+
+    struct LatencySummary
+    {
+        std::string m_product;      // "*" for all products
+        bool m_completed{};
+        std::string m_metric;       // "ticks" or "wall_us"
+        uint64_t m_count{};
+        double m_mean{};
+        uint64_t m_p50{};
+        uint64_t m_p90{};
+        uint64_t m_p99{};
+        uint64_t m_p999{};
+        uint64_t m_max{};
+    };
+
+    // Time on the line per order, grouped by product and outcome. Built from
+    // the entry/retire stamps the LineManager leaves on each order, so the
+    // simulation loop itself pays only for two clock reads per order.
+    class LatencyRecorder {
+        struct Group
+        {
+            LatencyHistogram m_ticks;
+            LatencyHistogram m_wallUs;
+        };
+
+        // Key: (product, completed); product "*" aggregates every product
+        std::map<std::pair<std::string, bool>, Group> m_groups{};
+
+        public:
+            void record(const CustomerOrder& order, bool completed);
+            void recordAll(const OrderQueue& orders, bool completed);
+            void reset() { m_groups.clear(); }
+
+            std::vector<LatencySummary> summarize() const;
+            void report(std::ostream& os) const;
+    };
+} // namespace seneca
+
+#endif
@@ -6,21 +6,116 @@
 #include <string>
 #include <fstream>
 #include <algorithm>
+#include <memory>
+#include <sstream>
 #include "seneca/Workstation.h"
 #include "seneca/Utilities.h"
+#include "seneca/ShardedLine.h"
+#include "seneca/TimedEngine.h"
 
 namespace seneca
 {
+    class ThreadPool;
+    struct ReplicaGroup;
+
+    // Drives the stations of one SimulationContext: the context current
+    // when the LineManager is constructed supplies its pending orders and
+    // receives the retired ones
     class LineManager {
+        SimulationContext* m_context{&SimulationContext::current()};
         std::vector<Workstation*> m_activeLine{};
         size_t m_cntCustomerOrder{};
         Workstation* m_firstStation{};
+        size_t m_iterationCount{};
+        size_t m_fillsSinceFrame{};
+        size_t m_retiredCompleted{};
+        size_t m_retiredIncomplete{};
+        std::vector<std::unique_ptr<ReplicaGroup>> m_replicas{};
+        std::vector<std::unique_ptr<ForkRoutes>> m_forks{};
+        std::unique_ptr<ThreadPool> m_pool{};
+        std::vector<std::ostringstream> m_traces{};     // Per fill task, appended in line order
+
+        void publishProgress(bool done);
+        size_t fillStations(std::ostream& os);
+        void linkStations(const std::vector<std::pair<std::string, std::string>>& stationLinks,
+                          const std::vector<Workstation*>& stations);
+        void mapBranches(ForkRoutes& fork) const;
+        void validateTopology(const std::vector<Workstation*>& stations) const;
 
         public: 
+            // Throw ValidationException if a link names an unknown station,
+            // every station is linked to from another, or the links close a
+            // cycle; stations the line never reaches only draw a warning
             LineManager(const std::string& file, const std::vector<Workstation*>& stations);
+            LineManager(const std::vector<std::pair<std::string, std::string>>& stationLinks,
+                        const std::vector<Workstation*>& stations);
+            ~LineManager();
+            LineManager(const LineManager&) = delete;
+            LineManager& operator=(const LineManager&) = delete;
+
+            // Runs the station on `lanes` replicas that share its inventory
+            // and serve one queue each: every iteration each replica fills
+            // its front order, and orders arriving from upstream go to the
+            // least loaded replica. The extra replicas are owned by the line
+            // and join the active line right after the station; they stop
+            // sharing its inventory when the line is destroyed. Call before
+            // the first run(), once per station.
+            void replicateStation(const std::string& itemName, size_t lanes);
+
+            // Fill the stations on `threads` workers; 0 or 1 fills on the
+            // calling thread. Stations are split into contiguous ranges, one
+            // task each, and the trace is written in line order, so the output
+            // only differs from a single-threaded run where replicas of one
+            // station race for their last units. Short lines are always
+            // filled on the calling thread.
+            void setThreads(size_t threads);
+
+            // Puts the active line in line order: the chain from the first
+            // station or, on a line with forks, a topological order of the
+            // stations reachable from it. A station linked to several
+            // successors is a fork (see Workstation::route()); one several
+            // stations link to is a join and serves the orders of every
+            // branch in one queue. Replicas follow their station.
             void reorderStations();
             bool run(std::ostream& os);
+
+            // Final state of the line without simulating iterations: every
+            // pending order ends up in the completed/incomplete queue with the
+            // same fills, serial numbers and remaining inventory run() would
+            // produce, in O(total items). Writes no trace and records no
+            // latency stamps or station metrics. Only valid before the first
+            // run(), while every order is still pending, on a line without
+            // replicated stations or forks.
+            void fastForward();
+
+            // The same final state as fastForward(), computed by worker
+            // processes that each own a contiguous segment of the chain and
+            // pass the orders on in batches over Unix domain sockets (see
+            // ShardedLine.h). The same restrictions apply. Forks the calling
+            // process once per segment.
+            ShardStats runSharded(const ShardOptions& options);
+
+            // Runs every pending order through the line in simulated time,
+            // each station taking its ServiceTime per unit (see
+            // TimedEngine.h), and reports the makespan, throughput and
+            // station utilization. Replicas and forks behave as in run();
+            // on a chain the final state is the one run() reaches. Only
+            // valid while every order is still pending.
+            TimedStats runTimed(const TimedOptions& options);
             void display(std::ostream& os) const;
+            size_t getIterationCount() const { return m_iterationCount; }
+
+            // Full mid-run state of the line (station inventories, serials
+            // and metrics, every order queue, the iteration counter) to a
+            // binary checkpoint; see Checkpoint.h. Safe between run() calls.
+            void saveCheckpoint(const std::string& path) const;
+
+            // Replace the line's state with a checkpoint of the same line:
+            // the stations must match the active line name for name. Orders
+            // currently queued anywhere in the context are dropped. The
+            // next run() continues with the iteration after the checkpoint.
+            // Restored orders are built in the current RunArena, if any.
+            void restoreCheckpoint(const std::string& path);
     };
 } // namespace seneca
 
@@ -6,6 +6,7 @@
 #include <string>
 #include <mutex>
 #include <memory>
+#include <atomic>
 
 namespace seneca
 {
@@ -24,9 +25,9 @@ namespace seneca
         static std::unique_ptr<Logger> s_instance;
         static std::mutex s_mutex;
         
-        LogLevel m_level;
+        std::atomic<LogLevel> m_level;  // May be changed by the config watcher thread
         std::ofstream m_file;
-        bool m_consoleOutput;
+        std::atomic<bool> m_consoleOutput;     // Also toggled by the config watcher thread
         bool m_fileOutput;
         std::string m_logFile;
 
@@ -47,6 +48,8 @@ namespace seneca
         
         // Configuration
         void setLogLevel(LogLevel level);
+        LogLevel getLogLevel() const { return m_level; }
+        static LogLevel parseLogLevel(const std::string& level);
         void setLogFile(const std::string& filename);
         void enableConsoleOutput(bool enable);
         void enableFileOutput(bool enable);
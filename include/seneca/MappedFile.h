@@ -0,0 +1,47 @@
+#ifndef SENECA_MAPPEDFILE_H
+#define SENECA_MAPPEDFILE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace seneca
+{
+    // Read-only, private memory mapping of a whole file. Binary formats
+    // built from fixed-size records (checkpoints, compiled scenarios) are
+    // read in place through it. Throws FileException if the file cannot
+    // be opened or mapped.
+    class MappedFile {
+        const char* m_data{};
+        size_t m_size{};
+
+        public:
+            explicit MappedFile(const std::string& path);
+            ~MappedFile();
+            MappedFile(MappedFile&& other) noexcept;
+            MappedFile& operator=(MappedFile&& other) noexcept;
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            const char* data() const { return m_data; }
+            size_t size() const { return m_size; }
+    };
+
+    // Pointer and length of one contiguous part of a file being written
+    using FileSection = std::pair<const char*, size_t>;
+
+    // Write the sections back to back to a temporary file next to `path`,
+    // sync it and rename it over `path`: readers see the old file or the
+    // complete new one, never a partial write. Throws FileException.
+    void writeFileAtomically(const std::string& path, const std::vector<FileSection>& sections);
+
+    // FNV-1a over 64-bit words (sections of the binary formats are
+    // multiples of 8 bytes), about eight times faster than hashing bytes.
+    // Sections chain by passing the previous result as the seed.
+    constexpr uint64_t CHECKSUM_SEED = 14695981039346656037ULL;
+    uint64_t checksum64(const char* data, size_t size, uint64_t seed = CHECKSUM_SEED);
+} // namespace seneca
+
+#endif
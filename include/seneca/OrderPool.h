@@ -0,0 +1,117 @@
+#ifndef SENECA_ORDERPOOL_H
+#define SENECA_ORDERPOOL_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <iterator>
+#include "seneca/CustomerOrder.h"
+
+namespace seneca
+{
+    // Index of an order in an OrderPool
+    using OrderHandle = uint32_t;
+
+    // Stable storage for customer orders. Orders are placed once, when they
+    // are queued, and stay at the same address until released; everything
+    // downstream passes 32-bit handles around instead of moving the orders.
+    //
+    // Storage grows in fixed-size chunks, so get() is two loads and an
+    // order's address never changes. The pool is not synchronized: orders
+    // are acquired while a run is being set up, after which any number of
+    // threads may get() existing handles concurrently.
+    class OrderPool {
+        static constexpr unsigned CHUNK_BITS = 12;
+        static constexpr OrderHandle CHUNK_SIZE = OrderHandle(1) << CHUNK_BITS;
+
+        std::vector<std::unique_ptr<CustomerOrder[]>> m_chunks{};
+        std::vector<OrderHandle> m_free{};
+        OrderHandle m_next{};
+
+        public:
+            OrderPool() = default;
+            OrderPool(const OrderPool&) = delete;
+            OrderPool& operator=(const OrderPool&) = delete;
+
+            OrderHandle acquire(CustomerOrder&& order);
+            void release(OrderHandle handle);
+
+            // Drop all storage; only valid once no queue holds a handle
+            void clear();
+
+            CustomerOrder& get(OrderHandle handle) { return m_chunks[handle >> CHUNK_BITS][handle & (CHUNK_SIZE - 1)]; }
+            const CustomerOrder& get(OrderHandle handle) const { return m_chunks[handle >> CHUNK_BITS][handle & (CHUNK_SIZE - 1)]; }
+
+            size_t size() const { return m_next - m_free.size(); }
+    };
+
+    // FIFO of order handles that reads like a container of orders.
+    //
+    // Pushing a CustomerOrder places it in the pool; pushing a handle just
+    // links an order that already lives there. pop_front() hands the front
+    // order over to whoever took its handle (nothing is released), while
+    // clear() and destruction release every order still queued.
+    class OrderQueue {
+        OrderPool* m_pool;
+        std::deque<OrderHandle> m_handles{};
+
+        public:
+            template <typename Order, typename HandleIt>
+            class Iterator {
+                OrderPool* m_pool;
+                HandleIt m_it;
+
+                public:
+                    using iterator_category = std::random_access_iterator_tag;
+                    using value_type = CustomerOrder;
+                    using difference_type = std::ptrdiff_t;
+                    using pointer = Order*;
+                    using reference = Order&;
+
+                    Iterator(OrderPool* pool, HandleIt it) : m_pool(pool), m_it(it) {}
+                    reference operator*() const { return m_pool->get(*m_it); }
+                    pointer operator->() const { return &**this; }
+                    Iterator& operator++() { ++m_it; return *this; }
+                    Iterator operator++(int) { Iterator tmp = *this; ++m_it; return tmp; }
+                    Iterator& operator--() { --m_it; return *this; }
+                    Iterator& operator+=(difference_type n) { m_it += n; return *this; }
+                    Iterator operator+(difference_type n) const { return Iterator(m_pool, m_it + n); }
+                    difference_type operator-(const Iterator& other) const { return m_it - other.m_it; }
+                    bool operator==(const Iterator& other) const { return m_it == other.m_it; }
+                    bool operator!=(const Iterator& other) const { return m_it != other.m_it; }
+                    OrderHandle handle() const { return *m_it; }
+            };
+
+            using iterator = Iterator<CustomerOrder, std::deque<OrderHandle>::const_iterator>;
+            using const_iterator = Iterator<const CustomerOrder, std::deque<OrderHandle>::const_iterator>;
+
+            explicit OrderQueue(OrderPool& pool) : m_pool(&pool) {}
+            OrderQueue(const OrderQueue&) = delete;
+            OrderQueue& operator=(const OrderQueue&) = delete;
+            ~OrderQueue() { clear(); }
+
+            OrderPool& pool() const { return *m_pool; }
+
+            void push_back(CustomerOrder&& order) { m_handles.push_back(m_pool->acquire(std::move(order))); }
+            void push_back(OrderHandle handle) { m_handles.push_back(handle); }
+            void pop_front() { m_handles.pop_front(); }
+            void clear();
+
+            CustomerOrder& front() { return m_pool->get(m_handles.front()); }
+            const CustomerOrder& front() const { return m_pool->get(m_handles.front()); }
+            OrderHandle frontHandle() const { return m_handles.front(); }
+            CustomerOrder& operator[](size_t i) { return m_pool->get(m_handles[i]); }
+            const CustomerOrder& operator[](size_t i) const { return m_pool->get(m_handles[i]); }
+
+            size_t size() const { return m_handles.size(); }
+            bool empty() const { return m_handles.empty(); }
+
+            iterator begin() { return iterator(m_pool, m_handles.cbegin()); }
+            iterator end() { return iterator(m_pool, m_handles.cend()); }
+            const_iterator begin() const { return const_iterator(m_pool, m_handles.cbegin()); }
+            const_iterator end() const { return const_iterator(m_pool, m_handles.cend()); }
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef SENECA_ORDERTABLE_H
+#define SENECA_ORDERTABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <ostream>
+#include "seneca/CustomerOrder.h"
+#include "seneca/OrderPool.h"
+
+namespace seneca
+{
+    enum class OrderOutcome : uint8_t
+    {
+        PENDING = 0,
+        COMPLETED = 1,
+        INCOMPLETE = 2
+    };
+
+    // Interned strings: each distinct value is stored once and referred to
+    // by a dense 32-bit id
+    class StringTable {
+        std::deque<std::string> m_strings{};    // Stable addresses: m_ids keys view into it
+        std::unordered_map<std::string_view, uint32_t> m_ids{};
+
+        public:
+            uint32_t intern(std::string_view str);
+            const std::string& get(uint32_t id) const { return m_strings[id]; }
+            size_t size() const { return m_strings.size(); }
+            void clear();
+    };
+
+    struct ProductSummary
+    {
+        uint32_t m_product{};
+        uint64_t m_orders{};
+        uint64_t m_completed{};
+        uint64_t m_items{};
+        uint64_t m_filledItems{};
+    };
+
+    // Column-oriented snapshot of a set of orders, for end-of-run work:
+    // persistence, aggregation and export. Each attribute lives in its own
+    // contiguous array (customer name, product id, outcome, item offsets
+    // into a shared item array, one fill bit per item, serials), so a bulk
+    // pass reads only the columns it needs, in order.
+    class OrderTable {
+        StringTable m_names{};                      // Products and item names: few distinct values
+        std::string m_customerChars{};              // Customer names back to back; mostly unique, so not interned
+        std::vector<uint64_t> m_customerOffset{0};  // Order i's name is [m_customerOffset[i], m_customerOffset[i + 1])
+        std::vector<uint32_t> m_product{};
+        std::vector<OrderOutcome> m_outcome{};
+        std::vector<uint64_t> m_entryTick{};
+        std::vector<uint64_t> m_retireTick{};
+        std::vector<uint64_t> m_itemOffset{0};      // Order i owns items [m_itemOffset[i], m_itemOffset[i + 1])
+        std::vector<uint32_t> m_itemName{};
+        std::vector<uint64_t> m_serial{};
+        std::vector<uint64_t> m_fillBits{};         // Bit k set when item k is filled
+
+        public:
+            void reserve(size_t orders, size_t items);
+            void append(const CustomerOrder& order, OrderOutcome outcome);
+            void appendAll(const OrderQueue& orders, OrderOutcome outcome);
+            void clear();
+
+            size_t size() const { return m_outcome.size(); }
+            size_t itemCount() const { return m_itemName.size(); }
+
+            std::string_view customerName(size_t order) const
+            {
+                return std::string_view(m_customerChars).substr(m_customerOffset[order],
+                                                                m_customerOffset[order + 1] - m_customerOffset[order]);
+            }
+            const std::string& productName(size_t order) const { return m_names.get(m_product[order]); }
+            const std::string& name(uint32_t id) const { return m_names.get(id); }
+            OrderOutcome outcome(size_t order) const { return m_outcome[order]; }
+            uint64_t entryTick(size_t order) const { return m_entryTick[order]; }
+            uint64_t retireTick(size_t order) const { return m_retireTick[order]; }
+            size_t orderItemCount(size_t order) const { return size_t(m_itemOffset[order + 1] - m_itemOffset[order]); }
+            size_t filledItemCount(size_t order) const;
+            uint64_t firstItem(size_t order) const { return m_itemOffset[order]; }
+            const std::string& itemName(uint64_t item) const { return m_names.get(m_itemName[item]); }
+            uint64_t itemSerial(uint64_t item) const { return m_serial[item]; }
+            bool isItemFilled(uint64_t item) const { return (m_fillBits[item >> 6] >> (item & 63)) & 1; }
+
+            // Bulk scans
+            size_t count(OrderOutcome outcome) const;
+            size_t filledItemCount() const;
+            std::vector<ProductSummary> summarizeByProduct() const;
+
+            // One CSV row per order: customer,product,outcome,filled,total,entry,retire
+            void exportCsv(std::ostream& os) const;
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef SENECA_PARAMETERSWEEP_H
+#define SENECA_PARAMETERSWEEP_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ServiceTime.h"
+
+namespace seneca
+{
+    // One swept station inventory (the quantity column of a station file)
+    struct SweepAxis
+    {
+        enum class Kind
+        {
+            RANGE,      // Every value min, min + step, ... <= max
+            RANDOM      // One uniform draw from [min, max] per variant
+        };
+
+        size_t m_station{};     // Index into Scenario::getStations()
+        Kind m_kind{Kind::RANGE};
+        size_t m_min{};
+        size_t m_max{};
+        size_t m_step{1};
+
+        size_t valueCount() const { return m_kind == Kind::RANGE ? (m_max - m_min) / m_step + 1 : 1; }
+    };
+
+    struct SweepResult
+    {
+        size_t m_variant{};
+        std::vector<size_t> m_quantities{};     // One per axis
+        size_t m_totalInventory{};              // Initial inventory over every station
+        size_t m_completed{};
+        size_t m_incomplete{};
+        size_t m_iterations{};
+        double m_elapsedMs{};
+        double m_makespan{};                    // Timed variants only
+        double m_throughput{};
+    };
+
+    // Inventory parameter sweep over one parsed scenario. The spec file has
+    // one '|'-separated entry per line; blank lines and '#' comments are
+    // skipped:
+    //
+    //   @seed     | 42                  seed for random draws (default 1)
+    //   @samples  | 100                 random draws per range combination
+    //   @engine   | fast                LineManager::fastForward instead of
+    //                                   simulating (default: simulate), or
+    //                                   timed for LineManager::runTimed
+    //   @interarrival | exp:2           release spacing of timed variants
+    //                                   (a ServiceTime, default 0); @seed
+    //                                   seeds their draws, the same for
+    //                                   every variant
+    //   Desk      | range  | 0 | 10 | 2 every value 0, 2, ..., 10
+    //   Bookcase  | random | 5 | 20     uniform draw per variant
+    //   *         | random | 0 | 5      every station not listed otherwise
+    //
+    // Variants are the cartesian product of the range axes, times @samples.
+    // Fast and timed variants report 0 iterations; timed variants add
+    // makespan and throughput columns to the CSV.
+    // A variant's quantities depend only on its index and the seed, so
+    // results are reproducible however the variants are scheduled.
+    class ParameterSweep {
+        const Scenario& m_scenario;
+        std::vector<SweepAxis> m_axes{};
+        uint64_t m_seed{1};
+        size_t m_samples{1};
+        size_t m_variants{1};
+        enum class Engine
+        {
+            SIMULATE,
+            FAST,
+            TIMED
+        };
+
+        Engine m_engine{Engine::SIMULATE};
+        ServiceTime m_interarrival{ServiceTime::Kind::CONSTANT, 0.0, 0.0};
+
+        void parse(std::istream& spec);
+
+        public:
+            static constexpr size_t MAX_VARIANTS = 10000000;
+
+            ParameterSweep(const Scenario& scenario, const std::string& specFile);
+            ParameterSweep(const Scenario& scenario, std::istream& spec);
+
+            const std::vector<SweepAxis>& getAxes() const { return m_axes; }
+            size_t variantCount() const { return m_variants; }
+
+            // Inventory of each axis' station in a variant
+            std::vector<size_t> quantities(size_t variant) const;
+
+            // Simulate one variant in the calling thread's own
+            // SimulationContext; safe to call from several threads at once
+            SweepResult runVariant(size_t variant) const;
+
+            // All variants on a work-stealing pool, in variant order
+            std::vector<SweepResult> run(size_t threads) const;
+
+            // One CSV row per variant: variant, outcome columns, then one
+            // inventory column per axis (named after the station)
+            void writeCsv(std::ostream& os, const std::vector<SweepResult>& results) const;
+
+            // Variant with the smallest total inventory that completed every
+            // order, or nullptr if none did
+            static const SweepResult* cheapestComplete(const std::vector<SweepResult>& results);
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef SENECA_RECORDPARSER_H
+#define SENECA_RECORDPARSER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "seneca/Utilities.h"
+#include "seneca/Scenario.h"
+
+namespace seneca
+{
+    // Station record split into its fields, ready for the Station field
+    // constructor
+    struct StationFields
+    {
+        std::string m_name{};
+        size_t m_serialNumber{};
+        size_t m_quantity{};
+        std::string m_description{};
+        size_t m_fieldWidth{1};         // As measured by the Station record constructor
+        ServiceTime m_service{};
+    };
+
+    // Non-throwing record parsers. They accept exactly the records the
+    // Station and CustomerOrder constructors accept and produce the same
+    // fields; a record those would throw on returns its ParseStatus instead
+    // and leaves the output unspecified.
+    ParseStatus parseStation(const std::string& record, char delimiter, StationFields& fields);
+    ParseStatus parseOrder(const std::string& record, char delimiter, OrderSpec& spec);
+    ParseStatus parseLink(const std::string& record, char delimiter, StationLink& link);
+
+    struct ParseDiagnostic
+    {
+        std::string m_file{};
+        size_t m_line{};                // 1-based
+        ParseStatus m_status{};
+        std::string m_record{};
+    };
+
+    // Outcome of a lenient load: how many records were kept and why each
+    // of the others was skipped
+    class ParseReport {
+        std::vector<ParseDiagnostic> m_diagnostics{};
+        size_t m_accepted{};
+
+        public:
+            void accept() { m_accepted++; }
+            void reject(const std::string& file, size_t line, ParseStatus status, const std::string& record);
+            // Appends another report, its line numbers shifted by lineOffset
+            void merge(ParseReport&& other, size_t lineOffset);
+
+            size_t accepted() const { return m_accepted; }
+            size_t rejected() const { return m_diagnostics.size(); }
+            bool clean() const { return m_diagnostics.empty(); }
+            const std::vector<ParseDiagnostic>& diagnostics() const { return m_diagnostics; }
+
+            // One "file:line: reason: record" line per skipped record, then
+            // a summary; limit == 0 prints every diagnostic
+            void print(std::ostream& os, size_t limit = 0) const;
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef SENECA_RUNARENA_H
+#define SENECA_RUNARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <optional>
+#include <memory_resource>
+#include <unordered_set>
+
+namespace seneca
+{
+    // Monotonic arena for everything a simulation run allocates per order:
+    // item arrays, customer names, and interned product and item names
+    // (together with the set that interns them). Allocation
+    // is a pointer bump, nothing is freed individually, and reset() returns
+    // the whole run's memory at once.
+    //
+    // Orders built while an arena is current (see Scope) point into it, so
+    // they must be discarded before the arena is reset. An arena is not
+    // synchronized; use one per thread of simulation.
+    //
+    // The arena keeps one buffer sized to the largest run seen so far, so
+    // steady-state runs allocate nothing from the heap and touch no new pages.
+    class RunArena {
+        // Passes allocations on to the monotonic resource and counts them,
+        // so the intern set's nodes and buckets show up in bytesAllocated()
+        class CountingResource : public std::pmr::memory_resource {
+            std::pmr::memory_resource* m_upstream;
+            size_t& m_bytes;
+
+            void* do_allocate(size_t bytes, size_t alignment) override;
+            void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+            public:
+                CountingResource(std::pmr::memory_resource* upstream, size_t& bytes)
+                    : m_upstream(upstream), m_bytes(bytes) {}
+        };
+
+        std::unique_ptr<std::byte[]> m_buffer{};
+        size_t m_capacity{};
+        std::optional<std::pmr::monotonic_buffer_resource> m_resource{};
+        std::optional<CountingResource> m_counting{};
+        std::optional<std::pmr::unordered_set<std::string_view>> m_interned{};
+        size_t m_bytes{};
+        size_t m_highWater{};
+
+        void rebuild();
+
+        public:
+            explicit RunArena(size_t initialSize = 1 << 20);
+            RunArena(const RunArena&) = delete;
+            RunArena& operator=(const RunArena&) = delete;
+
+            std::pmr::memory_resource* resource() { return &*m_counting; }
+            void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+            // NUL-terminated copy of str in the arena
+            std::string_view copy(std::string_view str);
+
+            // One copy per distinct string for the lifetime of the run
+            std::string_view intern(std::string_view str);
+
+            void reset();
+
+            // Bytes handed out since the last reset, by allocate() and by
+            // resource() alike; the largest run's total sizes the buffer
+            size_t bytesAllocated() const { return m_bytes; }
+            size_t capacity() const { return m_capacity; }
+
+            // Arena that order construction on this thread allocates from,
+            // or nullptr for the global heap
+            static RunArena* current();
+
+            // Makes an arena current for the enclosing block
+            class Scope {
+                RunArena* m_previous;
+
+                public:
+                    explicit Scope(RunArena& arena);
+                    ~Scope();
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+            };
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef SENECA_SCENARIO_H
+#define SENECA_SCENARIO_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include "seneca/Station.h"
+#include "seneca/Workstation.h"
+#include "seneca/StationRegistry.h"
+
+namespace seneca
+{
+    // A customer order in parsed form, before it is turned into a CustomerOrder
+    struct OrderSpec
+    {
+        std::string m_name;
+        std::string m_product;
+        std::vector<std::string> m_items;
+    };
+
+    using StationLink = std::pair<std::string, std::string>;
+
+    class CompiledOrders;
+    class ParseReport;
+
+    // Fully parsed simulation input. Loading tokenizes the data files once;
+    // every run then instantiates fresh workstations and orders from the
+    // parsed form, so repeated runs of the same input skip all file I/O.
+    class Scenario {
+        std::vector<Station> m_stations{};
+        std::vector<OrderSpec> m_orders{};
+        std::vector<StationLink> m_links{};
+        std::shared_ptr<const CompiledOrders> m_compiled{};     // Orders still in a mapped compiled scenario
+
+        void load(const std::string& stationFile1, const std::string& stationFile2,
+                  const std::string& orderFile, const std::string& lineFile, bool lenient, ParseReport& report);
+
+        public:
+            Scenario() = default;
+            // Throws ValidationException, naming the file and line, at the
+            // first malformed record
+            Scenario(const std::string& stationFile1, const std::string& stationFile2,
+                     const std::string& orderFile, const std::string& lineFile);
+            // Lenient load: malformed records are skipped and listed in
+            // `report` instead; only a missing file still throws
+            Scenario(const std::string& stationFile1, const std::string& stationFile2,
+                     const std::string& orderFile, const std::string& lineFile, ParseReport& report);
+            Scenario(std::vector<Station>&& stations, std::vector<OrderSpec>&& orders,
+                     std::vector<StationLink>&& links);
+            Scenario(std::vector<Station>&& stations, std::shared_ptr<const CompiledOrders> orders,
+                     std::vector<StationLink>&& links);
+
+            const std::vector<Station>& getStations() const { return m_stations; }
+            // A compiled scenario's orders are turned into OrderSpecs on
+            // first use; running it never needs them
+            const std::vector<OrderSpec>& getOrders() const;
+            size_t getOrderCount() const;
+            const std::vector<StationLink>& getLinks() const { return m_links; }
+
+            // Fresh workstations with the scenario's initial inventory, laid
+            // out contiguously in assembly line order
+            StationRegistry createStations() const;
+
+            // Append one CustomerOrder per order spec to the current context's
+            // pending queue
+            void enqueueOrders() const;
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,123 @@
+#ifndef SENECA_SCENARIOFILE_H
+#define SENECA_SCENARIOFILE_H
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "seneca/Scenario.h"
+#include "seneca/MappedFile.h"
+
+namespace seneca
+{
+    // Compiled scenario: everything the text files hold, already tokenized,
+    // so loading is one mmap and a copy out of fixed-size records (see the
+    // scenario_compile tool).
+    //
+    // Layout, native byte order, every section 8-byte aligned:
+    //   ScenarioFileHeader
+    //   ScenarioFileStation[m_stationCount]   in text file order
+    //   ScenarioFileLink[m_linkCount]         AssemblyLine.txt, in order
+    //   ScenarioFileOrder[m_orderCount]       CustomerOrders.txt, in order
+    //   ScenarioFileString[m_itemCount]       item names, CSR: order i owns
+    //                                         [m_firstItem, m_firstItem + m_itemCount)
+    //   char[m_stringBytes]                   interned string table
+    //
+    // Bump SCENARIO_FILE_VERSION whenever a record changes.
+    constexpr uint32_t SCENARIO_FILE_MAGIC = 0x43534C41;     // "ALSC"
+    constexpr uint16_t SCENARIO_FILE_VERSION = 2;
+    constexpr uint16_t SCENARIO_FILE_BYTE_ORDER = 0x0102;
+
+    struct ScenarioFileString
+    {
+        uint32_t m_offset;
+        uint32_t m_length;
+    };
+
+    struct ScenarioFileHeader
+    {
+        uint32_t m_magic;
+        uint16_t m_version;
+        uint16_t m_byteOrder;
+        uint64_t m_fileSize;
+        uint64_t m_checksum;        // checksum64() of the sections, then of this header with m_checksum = 0
+        uint32_t m_stationCount;
+        uint32_t m_linkCount;
+        uint32_t m_orderCount;
+        uint32_t m_itemCount;
+        uint32_t m_stringBytes;
+        uint32_t m_reserved;
+    };
+
+    struct ScenarioFileStation
+    {
+        ScenarioFileString m_name;
+        ScenarioFileString m_description;
+        uint64_t m_serialNumber;
+        uint64_t m_quantity;
+        uint64_t m_fieldWidth;      // As the tokenizer measured it, for identical output
+        uint32_t m_serviceKind;     // ServiceTime::Kind
+        uint32_t m_reserved;
+        double m_serviceA;
+        double m_serviceB;
+    };
+
+    struct ScenarioFileLink
+    {
+        ScenarioFileString m_from;
+        ScenarioFileString m_to;    // Empty for the last station
+    };
+
+    struct ScenarioFileOrder
+    {
+        ScenarioFileString m_name;
+        ScenarioFileString m_product;
+        uint32_t m_firstItem;
+        uint32_t m_itemCount;
+    };
+
+    static_assert(sizeof(ScenarioFileHeader) == 48, "scenario file header layout changed");
+    static_assert(sizeof(ScenarioFileStation) == 64, "scenario file station layout changed");
+    static_assert(sizeof(ScenarioFileLink) == 16, "scenario file link layout changed");
+    static_assert(sizeof(ScenarioFileOrder) == 24, "scenario file order layout changed");
+
+    // Orders of a loaded compiled scenario, left in the mapping. Runs build
+    // their CustomerOrders straight from it; OrderSpecs are only created,
+    // once, for callers that ask for them. Immutable and thread safe.
+    class CompiledOrders {
+        MappedFile m_file;
+        const ScenarioFileOrder* m_orders{};
+        const ScenarioFileString* m_items{};
+        const char* m_strings{};
+        size_t m_count{};
+        mutable std::once_flag m_specsOnce{};
+        mutable std::vector<OrderSpec> m_specs{};
+
+        std::string_view string(ScenarioFileString ref) const { return {m_strings + ref.m_offset, ref.m_length}; }
+
+        public:
+            CompiledOrders(MappedFile&& file, const ScenarioFileOrder* orders, const ScenarioFileString* items,
+                           const char* strings, size_t count);
+
+            size_t size() const { return m_count; }
+
+            // Append one CustomerOrder per order to the queue
+            void enqueue(OrderQueue& pending) const;
+            const std::vector<OrderSpec>& specs() const;
+    };
+
+    class ScenarioFile {
+        public:
+            // Compile a parsed scenario; the file is replaced atomically
+            static void write(const Scenario& scenario, const std::string& path);
+
+            // Load a compiled scenario: stations and links are copied out,
+            // orders stay mapped (see CompiledOrders). Stations get their
+            // ids from the current context, as when the text files are
+            // parsed. Throws FileException for anything but an intact file
+            // of this version.
+            static Scenario read(const std::string& path);
+    };
+} // namespace seneca
+
+#endif
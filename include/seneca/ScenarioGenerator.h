@@ -0,0 +1,74 @@
+#ifndef SENECA_SCENARIOGENERATOR_H
+#define SENECA_SCENARIOGENERATOR_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <ostream>
+#include "seneca/Scenario.h"
+
+namespace seneca
+{
+    enum class ItemDistribution
+    {
+        UNIFORM,    // Every station item equally likely
+        ZIPF        // A few hot items dominate demand
+    };
+
+    struct GeneratorOptions
+    {
+        size_t m_stations{100};         // Stations on the line (= line length)
+        size_t m_orders{10000};
+        size_t m_products{1000};        // Catalogue size; each product has a fixed item list
+        size_t m_minItems{1};           // Items per product
+        size_t m_maxItems{8};
+        ItemDistribution m_distribution{ItemDistribution::UNIFORM};
+        double m_zipfExponent{1.0};
+        double m_scarcity{1.0};         // Inventory as a fraction of total demand per item
+        bool m_shuffleLines{true};      // Write AssemblyLine.txt out of line order, like the sample data
+        std::string m_serviceTime{};    // service=<time> field of every station (see ServiceTime); empty for none
+        uint64_t m_seed{1};
+    };
+
+    // Deterministic synthetic scenario source for stress runs and benchmarks.
+    // The same options (including the seed) always produce the same files:
+    // the generator carries its own PRNG and sampling code instead of
+    // relying on <random> distributions, whose output is
+    // implementation-defined.
+    //
+    // Stations are split across two files in the ',' and '|' formats read by
+    // the simulator; orders are streamed, so millions of them never need to
+    // be held in memory.
+    class ScenarioGenerator {
+        GeneratorOptions m_options;
+        std::vector<std::string> m_itemNames{};
+        std::vector<std::vector<uint32_t>> m_productItems{};
+        std::vector<size_t> m_inventory{};
+        std::vector<uint32_t> m_lineOrder{};
+
+        void buildCatalogue();
+        size_t pickProduct(uint64_t order) const;
+        std::vector<uint32_t> lineFileOrder() const;
+        StationLink lineRecord(size_t position) const;
+
+        public:
+            explicit ScenarioGenerator(const GeneratorOptions& options);
+
+            const GeneratorOptions& getOptions() const { return m_options; }
+
+            // Write Stations1.txt, Stations2.txt, CustomerOrders.txt and
+            // AssemblyLine.txt into an existing directory
+            void writeFiles(const std::string& directory) const;
+
+            void writeStations(std::ostream& os, char delimiter, size_t first, size_t last) const;
+            void writeOrders(std::ostream& os) const;
+            void writeLine(std::ostream& os) const;
+
+            // The same scenario, parsed form only (no files)
+            Scenario build() const;
+
+            static ItemDistribution parseDistribution(const std::string& name);
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SENECA_SERVICETIME_H
+#define SENECA_SERVICETIME_H
+
+#include <cstdint>
+#include <string>
+
+namespace seneca
+{
+    // Time a station takes to supply one unit in a timed run (see
+    // LineManager::runTimed), or any other duration drawn per event. Written
+    // in station files and options as:
+    //
+    //   2.5              constant, the same as const:2.5
+    //   const:T          always T
+    //   uniform:A:B      uniform on [A, B]
+    //   exp:MEAN         exponential with the given mean
+    //   normal:MEAN:SD   normal, negative draws taken as 0
+    //
+    // Every parameter is a finite number >= 0.
+    struct ServiceTime
+    {
+        enum class Kind
+        {
+            CONSTANT,
+            UNIFORM,
+            EXPONENTIAL,
+            NORMAL
+        };
+
+        Kind m_kind{Kind::CONSTANT};
+        double m_a{1.0};        // Constant, low bound or mean
+        double m_b{};           // High bound or standard deviation
+
+        // False, leaving `time` untouched, for anything but the forms above
+        static bool parse(const std::string& spec, ServiceTime& time);
+        std::string toString() const;
+
+        // Every draw is 0
+        bool isZero() const { return m_a == 0 && (m_b == 0 || m_kind == Kind::EXPONENTIAL); }
+        double mean() const;
+
+        // One draw; `state` is a splitmix64 stream the caller owns, so runs
+        // seeded alike draw alike
+        double sample(uint64_t& state) const;
+    };
+
+    // The optional field after a station record's description,
+    // "service=<time>". Any other field is left for comments and leaves
+    // `time` alone; false only when the time after "service=" is malformed.
+    bool parseServiceField(const std::string& field, ServiceTime& time);
+} // namespace seneca
+
+#endif
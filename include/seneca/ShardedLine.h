@@ -0,0 +1,71 @@
+#ifndef SENECA_SHARDEDLINE_H
+#define SENECA_SHARDEDLINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "seneca/Workstation.h"
+#include "seneca/SimulationContext.h"
+
+namespace seneca
+{
+    // Layout of a sharded run (see LineManager::runSharded)
+    struct ShardOptions
+    {
+        size_t m_segments{2};           // Worker processes, one contiguous run of stations each
+        size_t m_batchOrders{256};      // Orders per message
+        size_t m_credits{4};            // Batches a sender may have unacknowledged on one hop
+    };
+
+    struct ShardStats
+    {
+        size_t m_segments{};
+        uint64_t m_batches{};           // Order batches the coordinator sent
+        uint64_t m_bytes{};             // Frame bytes written on every hop
+        uint64_t m_stalls{};            // Times a sender had a batch ready and no credit
+    };
+
+    // Runs a chain of stations as contiguous segments in forked worker
+    // processes, connected in line order by Unix domain sockets:
+    //
+    //   coordinator -> segment 1 -> segment 2 -> ... -> segment N -> coordinator
+    //
+    // Every message is a frame: uint32 payload length, uint32 type, payload,
+    // in native byte order. Item names travel as indexes into the table of
+    // station names the coordinator builds, so a worker never sees a string:
+    //   SEGMENT  the stations of one segment (name index, quantity, serial);
+    //            each worker keeps the first one it receives and passes the
+    //            others on
+    //   ORDERS   a batch of orders in pending order, each an item count and
+    //            its items (name index, filled flag, serial number); every
+    //            worker fills what its stations can and passes the batch on
+    //   CREDIT   sent back upstream for the batches passed on since the last one
+    //   STATE    a segment's final station stock and wire counters
+    //   END      no more orders; each worker appends its STATE and exits
+    //
+    // Flow control is per hop: a sender starts with m_credits and spends
+    // one per ORDERS batch, so no socket holds more than m_credits batches
+    // and a slow segment holds back everything upstream of it. Credits are
+    // read as soon as they arrive and written without blocking, so a window
+    // wider than a socket buffer cannot wedge two neighbours writing to
+    // each other.
+    //
+    // The coordinator keeps the orders and merges what comes back into the
+    // context's completed and incomplete queues. Orders cannot overtake each
+    // other on a chain, so the batches return in pending order and every
+    // station sees the orders in pending order, which is all the outcome
+    // depends on (see LineManager::fastForward): fills, serial numbers and
+    // remaining stock match a run() of the same line. Throws
+    // StationException when a worker cannot be started or dies, or sends a
+    // frame shorter than the counts it declares.
+    //
+    // Only the stations are partitioned, not the orders: the coordinator
+    // holds every order in the context for the whole run, and each worker
+    // is forked with a copy-on-write image of them, so a sharded run needs
+    // as much memory for its scenario as run() does. What it splits across
+    // processes is the filling work.
+    ShardStats runSharded(const std::vector<Workstation*>& chain, SimulationContext& context,
+                          const ShardOptions& options);
+} // namespace seneca
+
+#endif
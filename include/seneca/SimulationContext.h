@@ -0,0 +1,62 @@
+#ifndef SENECA_SIMULATIONCONTEXT_H
+#define SENECA_SIMULATIONCONTEXT_H
+
+#include <cstddef>
+#include "seneca/OrderPool.h"
+
+namespace seneca
+{
+    // Everything one simulation mutates outside its stations and line
+    // manager: the order pool and queues, the station id counter and the
+    // column widths used when printing stations and orders.
+    //
+    // Stations, orders and line managers bind to the context that is
+    // current on their thread when they are constructed (see Scope), so
+    // independent simulations can run side by side, one context per
+    // thread. Without a Scope the process-wide default context is current;
+    // g_pending, g_completed and g_incomplete are its queues.
+    class SimulationContext {
+        OrderPool m_pool{};
+        OrderQueue m_pending{m_pool};
+        OrderQueue m_completed{m_pool};
+        OrderQueue m_incomplete{m_pool};
+        size_t m_stationIds{};
+        size_t m_stationWidth{};
+        size_t m_orderWidth{};
+
+        public:
+            SimulationContext() = default;
+            SimulationContext(const SimulationContext&) = delete;
+            SimulationContext& operator=(const SimulationContext&) = delete;
+
+            OrderPool& pool() { return m_pool; }
+            OrderQueue& pending() { return m_pending; }
+            OrderQueue& completed() { return m_completed; }
+            OrderQueue& incomplete() { return m_incomplete; }
+
+            size_t nextStationId() { return ++m_stationIds; }
+            size_t stationWidth() const { return m_stationWidth; }
+            size_t orderWidth() const { return m_orderWidth; }
+            void raiseStationWidth(size_t width) { if (width > m_stationWidth) m_stationWidth = width; }
+            void raiseOrderWidth(size_t width) { if (width > m_orderWidth) m_orderWidth = width; }
+
+            // Empty the queues; ids and widths carry on
+            void clearOrders();
+
+            static SimulationContext& current();
+            static SimulationContext& defaultContext();
+
+            // Makes a context current on this thread for the enclosing block
+            class Scope {
+                SimulationContext* m_previous;
+
+                public:
+                    explicit Scope(SimulationContext& context);
+                    ~Scope();
+                    Scope(const Scope&) = delete;
+                    Scope& operator=(const Scope&) = delete;
+            };
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef SENECA_SIMULATIONDAEMON_H
+#define SENECA_SIMULATIONDAEMON_H
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace seneca
+{
+    // Handles one request. Receives the whitespace-separated command words,
+    // with double quotes already removed from quoted ones (so "a b.txt" is
+    // one word), and returns the single-line response sent back to the client.
+    using DaemonHandler = std::function<std::string(const std::vector<std::string>& command)>;
+
+    // Long-lived process front end listening on a local Unix domain socket.
+    // Each connection carries one newline-terminated command and receives
+    // one newline-terminated response. Requests are served one at a time,
+    // which matches the single set of warm simulation state behind them; a
+    // client that has not sent its whole command within the command timeout
+    // is dropped, so it cannot hold up the others.
+    //
+    // Built-in commands: "ping" and "shutdown". Everything else is passed
+    // to the handler.
+    class SimulationDaemon
+    {
+    private:
+        std::string m_socketPath;
+        DaemonHandler m_handler;
+        int m_listenFd;
+        int m_commandTimeoutMs;
+
+        SimulationDaemon(const SimulationDaemon&) = delete;
+        SimulationDaemon& operator=(const SimulationDaemon&) = delete;
+
+        bool serveClient(int fd);
+
+    public:
+        SimulationDaemon(const std::string& socketPath, DaemonHandler handler, int commandTimeoutMs = 5000);
+        ~SimulationDaemon();
+
+        // Bind the socket and serve requests until "shutdown", SIGINT or
+        // SIGTERM. Returns false if the socket could not be created, or if
+        // another daemon is still listening on it.
+        bool run();
+    };
+} // namespace seneca
+
+#endif // SENECA_SIMULATIONDAEMON_H
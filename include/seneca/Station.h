@@ -1,33 +1,72 @@
 #ifndef SENECA_STATION_H
 #define SENECA_STATION_H
+#include <atomic>
 #include <iostream>
 #include <string>
 #include <iomanip>
+#include <memory>
 #include "seneca/Utilities.h"
+#include "seneca/ServiceTime.h"
 
 namespace seneca
 {
+    // Attributes that are fixed once a station is parsed and only read for
+    // display. They live out of line, shared by every copy of the station,
+    // so the fields the simulation loop touches stay packed together.
+    struct StationInfo
+    {
+        int m_id{};
+        std::string m_description{};
+        size_t m_fieldWidth{};          // Widest name/serial/quantity token seen while parsing
+        ServiceTime m_service{};        // Per unit, for timed runs; one time unit unless the record says
+    };
+
+    // Stock and serial counter of a station run as several replicas (see
+    // LineManager::replicateStation). Units are reserved atomically, so the
+    // replicas may fill on different threads.
+    struct SharedInventory
+    {
+        std::atomic<size_t> m_quantity{};
+        std::atomic<size_t> m_nextSerial{};
+    };
+
     class Station  {
         
-    int m_id{};
+    // Hot: read or written on every fill
     std::string m_name{};
-    std::string m_description{};
     size_t m_serialNumber{};
     size_t m_itemQuantity{};
-
-    static size_t id_generator;
-    static size_t m_widthField;
+    SharedInventory* m_shared{};        // Replaces the two above while set
+    // Cold
+    std::shared_ptr<const StationInfo> m_info{};
 
     public : 
         Station(const std::string& name);
+        // name, serial, quantity, description[, service=<time>]
+        Station(const std::string& record, char delimiter);
+        // Already tokenized fields; fieldWidth is what parsing the record would have measured
+        Station(const std::string& name, size_t serialNumber, size_t quantity,
+                const std::string& description, size_t fieldWidth, const ServiceTime& service = {});
         Station(Station &&) noexcept = default;
         Station &operator=(Station &&) noexcept = default;
         Station(const Station &) = default;
         Station &operator=(const Station &) = default;
         const std::string& getItemName() const;
+        const std::string& getDescription() const { return m_info->m_description; }
+        size_t getFieldWidth() const { return m_info->m_fieldWidth; }
+        const ServiceTime& getServiceTime() const { return m_info->m_service; }
         size_t getNextSerialNumber();
+        size_t getSerialNumber() const;
+        void setSerialNumber(size_t serialNumber);
         size_t getQuantity() const;
         void updateQuantity();
+        void setQuantity(size_t quantity);
+        // Takes one unit and its serial number in one step; false when out
+        // of stock
+        bool takeUnit(size_t& serialNumber);
+        // Draw on `inventory` instead of this station's own stock from now
+        // on; nullptr copies the shared stock back and stops sharing
+        void shareInventory(SharedInventory* inventory);
         void display(std::ostream& os, bool full) const;
     };
 } // namespace seneca
@@ -0,0 +1,104 @@
+#ifndef SENECA_STATIONMETRICS_H
+#define SENECA_STATIONMETRICS_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+namespace seneca
+{
+    // Size of a cache line on every target we build for. Kept as a constant
+    // instead of std::hardware_destructive_interference_size, which GCC warns
+    // about and older libc++ does not provide.
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    // Single-writer counter. Only the thread currently running the owning
+    // station updates it, so an increment is a relaxed load and store
+    // rather than a locked read-modify-write; other threads (API, event
+    // stream) may read it at any time and see a recent value.
+    class StationCounter {
+        std::atomic<uint64_t> m_value{0};
+
+        public:
+            void add(uint64_t n = 1) { m_value.store(m_value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+            void raise(uint64_t n) { if (n > get()) m_value.store(n, std::memory_order_relaxed); }
+            void reset() { m_value.store(0, std::memory_order_relaxed); }
+            uint64_t get() const { return m_value.load(std::memory_order_relaxed); }
+    };
+
+    // Plain copy of a station's counters, for reporting and persistence
+    struct StationStats
+    {
+        uint64_t m_fills{};             // Items handed out
+        uint64_t m_failedFills{};       // Ticks where the front order wanted the item but stock was out
+        uint64_t m_ordersPassed{};      // Orders moved on to the next station or retired
+        uint64_t m_maxQueueDepth{};
+        uint64_t m_queueDepthSum{};     // Sampled once per tick
+        uint64_t m_busyTicks{};         // Ticks with at least one order waiting
+        uint64_t m_idleTicks{};
+
+        uint64_t ticks() const { return m_busyTicks + m_idleTicks; }
+        double meanQueueDepth() const { return ticks() ? double(m_queueDepthSum) / double(ticks()) : 0.0; }
+        double utilization() const { return ticks() ? double(m_busyTicks) / double(ticks()) : 0.0; }
+    };
+
+    // Runtime counters for one workstation. Aligned to a cache line so
+    // stations processed by different threads never share one.
+    struct alignas(CACHE_LINE_SIZE) StationMetrics
+    {
+        StationCounter m_fills;
+        StationCounter m_failedFills;
+        StationCounter m_ordersPassed;
+        StationCounter m_maxQueueDepth;
+        StationCounter m_queueDepthSum;
+        StationCounter m_busyTicks;
+        StationCounter m_idleTicks;
+
+        // One scheduler tick at this station with `depth` orders queued
+        void recordTick(size_t depth)
+        {
+            m_queueDepthSum.add(depth);
+            m_maxQueueDepth.raise(depth);
+            (depth ? m_busyTicks : m_idleTicks).add();
+        }
+
+        StationStats snapshot() const
+        {
+            StationStats stats;
+            stats.m_fills = m_fills.get();
+            stats.m_failedFills = m_failedFills.get();
+            stats.m_ordersPassed = m_ordersPassed.get();
+            stats.m_maxQueueDepth = m_maxQueueDepth.get();
+            stats.m_queueDepthSum = m_queueDepthSum.get();
+            stats.m_busyTicks = m_busyTicks.get();
+            stats.m_idleTicks = m_idleTicks.get();
+            return stats;
+        }
+
+        // Counters exactly as a snapshot recorded them (checkpoint restore)
+        void restore(const StationStats& stats)
+        {
+            reset();
+            m_fills.add(stats.m_fills);
+            m_failedFills.add(stats.m_failedFills);
+            m_ordersPassed.add(stats.m_ordersPassed);
+            m_maxQueueDepth.add(stats.m_maxQueueDepth);
+            m_queueDepthSum.add(stats.m_queueDepthSum);
+            m_busyTicks.add(stats.m_busyTicks);
+            m_idleTicks.add(stats.m_idleTicks);
+        }
+
+        void reset()
+        {
+            m_fills.reset();
+            m_failedFills.reset();
+            m_ordersPassed.reset();
+            m_maxQueueDepth.reset();
+            m_queueDepthSum.reset();
+            m_busyTicks.reset();
+            m_idleTicks.reset();
+        }
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef SENECA_STATIONREGISTRY_H
+#define SENECA_STATIONREGISTRY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "seneca/Station.h"
+#include "seneca/Workstation.h"
+
+namespace seneca
+{
+    // Owns a run's workstations in one contiguous, cache-line aligned block.
+    // Stations are constructed in place and never move, so pointers and
+    // slots stay valid for the registry's lifetime. A layout chosen in line
+    // order (see Scenario::createStations) makes the LineManager's
+    // per-iteration passes walk memory front to back instead of chasing one
+    // heap allocation per station.
+    class StationRegistry {
+        Workstation* m_stations{};              // Memory order: m_stations[slot]
+        size_t m_count{};
+        std::vector<size_t> m_slotOf{};         // Input index -> slot
+        std::unordered_map<std::string, size_t> m_index{};
+
+        void destroy();
+
+        public:
+            static constexpr size_t npos = static_cast<size_t>(-1);
+
+            StationRegistry() = default;
+            // layout[slot] is the index in stations of the station stored at
+            // that slot; an empty layout keeps the input order
+            explicit StationRegistry(const std::vector<Station>& stations,
+                                     const std::vector<size_t>& layout = {});
+            StationRegistry(StationRegistry&& other) noexcept;
+            StationRegistry& operator=(StationRegistry&& other) noexcept;
+            StationRegistry(const StationRegistry&) = delete;
+            StationRegistry& operator=(const StationRegistry&) = delete;
+            ~StationRegistry();
+
+            size_t size() const { return m_count; }
+            Workstation& operator[](size_t slot) { return m_stations[slot]; }
+            const Workstation& operator[](size_t slot) const { return m_stations[slot]; }
+            Workstation* begin() { return m_stations; }
+            Workstation* end() { return m_stations + m_count; }
+            size_t slotOf(size_t index) const { return m_slotOf[index]; }
+
+            // Slot of the (first) station handing out itemName, or npos
+            size_t find(const std::string& itemName) const;
+
+            // Station addresses in input order, as LineManager expects them
+            std::vector<Workstation*> stations();
+    };
+} // namespace seneca
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef SENECA_THREADPOOL_H
+#define SENECA_THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace seneca
+{
+    // Runs a task; receives the index of the worker running it, so tasks
+    // can keep per-worker state without locking
+    using PoolTask = std::function<void(size_t worker)>;
+
+    // Fixed-size work-stealing thread pool. Every worker owns a deque:
+    // it takes its own work from the back (most recently queued, still
+    // warm in cache) and, when that runs dry, steals from the front of the
+    // other workers' deques. Tasks submitted from outside the pool are
+    // dealt round-robin; tasks submitted by a worker go to its own deque.
+    //
+    // Uneven tasks (simulation variants that finish in a handful of
+    // iterations next to ones that run the whole line) therefore balance
+    // themselves without a central queue every worker contends on.
+    class ThreadPool
+    {
+    private:
+        struct WorkQueue
+        {
+            std::mutex m_mutex;
+            std::deque<PoolTask> m_tasks;
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;                     // Guards sleeping, m_unfinished and m_error
+        std::condition_variable m_wake;         // Work was queued or the pool is stopping
+        std::condition_variable m_done;         // m_unfinished reached zero
+        std::atomic<size_t> m_queued;           // Tasks sitting in any deque
+        size_t m_unfinished;                    // Submitted and not yet completed
+        std::atomic<size_t> m_nextQueue;
+        std::exception_ptr m_error;
+        bool m_stopping;
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        void workerLoop(size_t index);
+        bool takeTask(size_t index, PoolTask& task);
+
+    public:
+        // threads == 0 uses one worker per hardware thread
+        explicit ThreadPool(size_t threads = 0);
+        ~ThreadPool();
+
+        size_t size() const { return m_threads.size(); }
+
+        void submit(PoolTask task);
+
+        // Block until every submitted task has finished. Rethrows the first
+        // exception a task threw since the last wait().
+        void wait();
+    };
+} // namespace seneca
+
+#endif // SENECA_THREADPOOL_H
@@ -0,0 +1,65 @@
+#ifndef SENECA_TIMEDENGINE_H
+#define SENECA_TIMEDENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "seneca/ServiceTime.h"
+#include "seneca/Workstation.h"
+#include "seneca/SimulationContext.h"
+
+namespace seneca
+{
+    struct TimedOptions
+    {
+        ServiceTime m_interarrival{ServiceTime::Kind::CONSTANT, 0.0, 0.0};    // Between releases; 0 releases every order at once
+        uint64_t m_seed{1};
+    };
+
+    struct StationTimes
+    {
+        const Workstation* m_station{};
+        double m_busy{};                // Simulated time spent serving
+        uint64_t m_services{};          // Orders this station took units for
+        uint64_t m_units{};
+    };
+
+    struct TimedStats
+    {
+        double m_makespan{};            // Simulated time the last order retired
+        double m_throughput{};          // Orders retired per unit of simulated time
+        double m_meanFlowTime{};        // From release to retirement
+        double m_maxFlowTime{};
+        uint64_t m_orders{};
+        uint64_t m_events{};            // Events the calendar delivered
+        uint64_t m_coalesced{};         // Events a per-unit, per-hop model would have added
+        uint64_t m_peakEvents{};        // Most events pending at once
+        std::vector<StationTimes> m_stations{};    // Active line order
+    };
+
+    // Discrete-event run of a line in simulated time. Orders are released
+    // into the first station from the pending queue, one interarrival time
+    // apart. Every workstation is a single server working through its own
+    // queue first come, first served: an order at the front takes its units
+    // the moment service starts, holds the station for one service time per
+    // unit taken (the station's ServiceTime, drawn per unit) and then moves
+    // on as attemptToMoveOrder() would move it, so forks route and
+    // replicated stations share their stock as in run().
+    //
+    // The only events are releases and service completions, kept in a
+    // CalendarQueue; everything else is coalesced into them: an order that
+    // takes nothing from an idle station passes it at once, a service of
+    // several units is one completion, and orders released at the same
+    // instant enter with one event.
+    //
+    // Each station draws from its own random stream, seeded from
+    // options.m_seed and its position on the line, so runs with the same
+    // seed are identical and a change at one station leaves the draws of
+    // the others alone. On a chain every station still sees the orders in
+    // pending order, so fills, serial numbers and remaining stock match a
+    // run() of the same line. Records no latency stamps.
+    TimedStats runTimed(const std::vector<Workstation*>& line, Workstation* first, SimulationContext& context,
+                        const TimedOptions& options);
+} // namespace seneca
+
+#endif
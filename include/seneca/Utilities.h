@@ -1,6 +1,7 @@
 #ifndef SENECA_UTILITIES_H
 #define SENECA_UTILITIES_H
 
+#include <atomic>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -9,18 +10,44 @@
 
 namespace seneca
 {
+    // Why a record could not be parsed
+    enum class ParseStatus
+    {
+        OK,
+        EMPTY_FIELD,    // Two delimiters in a row
+        BAD_NUMBER,     // A numeric field that does not start with a number, or overflows
+        BAD_SERVICE     // A service=<time> field that is not a ServiceTime
+    };
+
+    const char* toString(ParseStatus status);
+
+    // Splits records into trimmed tokens. Every instance tokenizes with its
+    // own delimiter, fixed when it is constructed, so parsers on different
+    // threads, or for files with different delimiters, share no state. The
+    // default constructor takes the process-wide default delimiter.
     class Utilities {
         size_t m_widthField{1};
-        static char m_delimiter;
+        char m_delimiter{m_defaultDelimiter.load(std::memory_order_relaxed)};
+        static std::atomic<char> m_defaultDelimiter;
 
         public:
             Utilities() = default;
+            explicit Utilities(char delimiter) : m_delimiter(delimiter) {}
             void setFieldWidth(size_t newWidth);
             size_t getFieldWidth() const;
             std::string extractToken(const std::string& str, size_t& next_pos, bool& more);
+            // extractToken() without the exception: an empty field returns
+            // EMPTY_FIELD instead of throwing "No token"
+            ParseStatus nextToken(const std::string& str, size_t& next_pos, bool& more, std::string& token);
+            char delimiter() const { return m_delimiter; }
+
+            // Default delimiter of instances constructed from now on
             static void setDelimiter(char newDelimiter);
             static char getDelimiter();
     };
+
+    // Escape a string for embedding in a JSON string literal
+    std::string escapeJson(const std::string& str);
 } // namespace seneca
 
 #endif
\ No newline at end of file
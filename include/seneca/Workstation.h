@@ -2,28 +2,78 @@
 #define SENECA_WORKSTATION_H
 
 #include <iostream>
-#include <deque>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 #include "seneca/CustomerOrder.h"
+#include "seneca/OrderPool.h"
 #include "seneca/Station.h"
+#include "seneca/StationMetrics.h"
+#include "seneca/SimulationContext.h"
 
 namespace seneca
 {
-    extern std::deque<CustomerOrder> g_pending;
-    extern std::deque<CustomerOrder> g_completed;
-    extern std::deque<CustomerOrder> g_incomplete;
+    // The default SimulationContext's order pool and queues. Every order in
+    // flight lives in a context's pool; the queues and the workstation
+    // queues only carry handles to it
+    extern OrderPool& g_orderPool;
+    extern OrderQueue& g_pending;
+    extern OrderQueue& g_completed;
+    extern OrderQueue& g_incomplete;
 
+    class Workstation;
+
+    // Branches out of a fork: its successors in link order and, for each,
+    // the stations reachable through it by item name
+    struct ForkRoutes
+    {
+        Workstation* m_station{};
+        std::vector<Workstation*> m_successors{};
+        std::vector<std::unordered_map<std::string_view, std::vector<Workstation*>>> m_reach{};
+    };
+
+    // A workstation belongs to the SimulationContext current when it was
+    // constructed and retires finished orders into that context's queues
     class Workstation : public Station {
-        std::deque<CustomerOrder> m_orders{};
-        Workstation* m_pNextStation{};
+        Workstation* m_pNextStation{};                  // First successor on a fork
+        const ForkRoutes* m_fork{};
+        const std::vector<Workstation*>* m_lanes{};     // Every replica of this station, this one included
+        SimulationContext* m_context{&SimulationContext::current()};
+        OrderQueue m_orders{m_context->pool()};
+        StationMetrics m_metrics{};
 
         public:
             Workstation(const std::string& str);
-            void fill(std::ostream& os);
+            explicit Workstation(const Station& station);
+            // Fills the front order; true if it took a unit
+            bool fill(std::ostream& os);
             bool attemptToMoveOrder();
+            // Removes the front order and hands its handle to the caller,
+            // who moves the order on (see TimedEngine.h)
+            OrderHandle popOrder();
             void setNextStation(Workstation* station);
             Workstation* getNextStation() const;
+            // A station linked to several successors is a fork: an order
+            // leaving it takes the branch that can still supply the most of
+            // its unfilled items, the first successor on a tie
+            void setFork(const ForkRoutes* fork) { m_fork = fork; }
+            const ForkRoutes* getFork() const { return m_fork; }
+            Workstation* route(const CustomerOrder& order) const;
+            // Replicas of one station share their inventory and each serve
+            // their own queue; an order sent to any of them goes to the one
+            // with the fewest orders queued (the first of those on a tie)
+            void setLanes(const std::vector<Workstation*>* lanes) { m_lanes = lanes; }
+            const std::vector<Workstation*>* getLanes() const { return m_lanes; }
+            Workstation* pickLane();
+            size_t getOrderCount() const { return m_orders.size(); }
+            const OrderQueue& getOrders() const { return m_orders; }
+            void clearOrders() { m_orders.clear(); }
+            const StationMetrics& getMetrics() const { return m_metrics; }
+            void resetMetrics() { m_metrics.reset(); }
+            void restoreMetrics(const StationStats& stats) { m_metrics.restore(stats); }
             void display(std::ostream& os) const;
             Workstation& operator+=(CustomerOrder&& newOrder);
+            Workstation& operator+=(OrderHandle order);
     };
 } // namespace seneca
 
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include "seneca/CalendarQueue.h"
+
+namespace seneca
+{
+    namespace
+    {
+        // Events a rebuild looks at to estimate the spacing near the front
+        constexpr size_t WIDTH_SAMPLE = 64;
+
+        // Heap order: the root is the earliest event
+        bool later(const TimedEvent& a, const TimedEvent& b)
+        {
+            return a.m_time > b.m_time || (a.m_time == b.m_time && a.m_seq > b.m_seq);
+        }
+
+        bool earlier(const TimedEvent& a, const TimedEvent& b)
+        {
+            return later(b, a);
+        }
+    }
+
+    CalendarQueue::CalendarQueue(double width)
+        : m_buckets(MIN_BUCKETS), m_mask(MIN_BUCKETS - 1), m_width(width > 0 ? width : 1.0), m_inverse(1.0 / m_width)
+    {
+    }
+
+    uint64_t CalendarQueue::dayOf(double time) const
+    {
+        // Days past 2^63 all share the last one; the heaps still order them
+        double day = time * m_inverse;
+        return day < 9.2e18 ? uint64_t(day) : uint64_t(9.2e18);
+    }
+
+    void CalendarQueue::push(double time, uint32_t target, uint32_t kind)
+    {
+        uint64_t day = dayOf(time);
+        m_day = m_size ? std::min(m_day, day) : day;
+        std::vector<TimedEvent>& bucket = m_buckets[day & m_mask];
+        bucket.push_back({time, m_nextSeq++, target, kind});
+        std::push_heap(bucket.begin(), bucket.end(), later);
+        if (++m_size > 2 * m_buckets.size())
+        {
+            resize(2 * m_buckets.size());
+        }
+    }
+
+    TimedEvent CalendarQueue::pop()
+    {
+        // The head of day d's bucket is due today if any of its events is
+        std::vector<TimedEvent>* due = nullptr;
+        for (size_t scanned = 0; scanned <= m_mask; scanned++, m_day++)
+        {
+            std::vector<TimedEvent>& bucket = m_buckets[m_day & m_mask];
+            if (!bucket.empty() && dayOf(bucket.front().m_time) == m_day)
+            {
+                due = &bucket;
+                break;
+            }
+        }
+
+        if (!due)
+        {
+            // A year with nothing due: the width no longer fits the events
+            if (m_size > MIN_BUCKETS)
+            {
+                resize(m_buckets.size());
+            }
+            for (std::vector<TimedEvent>& bucket : m_buckets)
+            {
+                if (!bucket.empty() && (!due || earlier(bucket.front(), due->front())))
+                {
+                    due = &bucket;
+                }
+            }
+            m_day = dayOf(due->front().m_time);
+        }
+
+        std::pop_heap(due->begin(), due->end(), later);
+        TimedEvent event = due->back();
+        due->pop_back();
+        if (--m_size < m_buckets.size() / 2 && m_buckets.size() > MIN_BUCKETS)
+        {
+            resize(m_buckets.size() / 2);
+        }
+        return event;
+    }
+
+    void CalendarQueue::resize(size_t buckets)
+    {
+        std::vector<TimedEvent> events;
+        events.reserve(m_size);
+        for (std::vector<TimedEvent>& bucket : m_buckets)
+        {
+            events.insert(events.end(), bucket.begin(), bucket.end());
+        }
+
+        // Three times the mean gap between the earliest events puts a few
+        // of them in each day
+        if (events.size() > 1)
+        {
+            size_t k = std::min(events.size(), WIDTH_SAMPLE) - 1;
+            std::nth_element(events.begin(), events.begin() + k, events.end(), earlier);
+            double first = std::min_element(events.begin(), events.begin() + k, earlier)->m_time;
+            double gap = (events[k].m_time - first) / double(k);
+            if (gap > 0)
+            {
+                m_width = 3 * gap;
+                m_inverse = 1.0 / m_width;
+            }
+        }
+
+        m_buckets.assign(buckets, {});
+        m_mask = buckets - 1;
+        if (!events.empty())
+        {
+            m_day = dayOf(std::min_element(events.begin(), events.end(), earlier)->m_time);
+        }
+        for (const TimedEvent& event : events)
+        {
+            std::vector<TimedEvent>& bucket = m_buckets[dayOf(event.m_time) & m_mask];
+            bucket.push_back(event);
+            std::push_heap(bucket.begin(), bucket.end(), later);
+        }
+        m_resizes++;
+    }
+} // namespace seneca
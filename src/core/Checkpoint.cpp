@@ -0,0 +1,136 @@
+#include "seneca/Checkpoint.h"
+#include "seneca/Exceptions.h"
+
+namespace seneca
+{
+    CheckpointWriter::CheckpointWriter(uint64_t iteration, uint64_t orderTotal)
+    {
+        m_header.m_magic = CHECKPOINT_MAGIC;
+        m_header.m_version = CHECKPOINT_VERSION;
+        m_header.m_byteOrder = CHECKPOINT_BYTE_ORDER;
+        m_header.m_iteration = iteration;
+        m_header.m_orderTotal = orderTotal;
+    }
+
+    void CheckpointWriter::reserve(size_t stations, size_t orders, size_t items)
+    {
+        m_stations.reserve(stations);
+        m_orders.reserve(orders);
+        m_items.reserve(items);
+    }
+
+    CheckpointString CheckpointWriter::addUniqueString(std::string_view text)
+    {
+        CheckpointString ref{uint32_t(m_strings.size()), uint32_t(text.size())};
+        m_strings.append(text);
+        return ref;
+    }
+
+    CheckpointString CheckpointWriter::addString(std::string_view text)
+    {
+        auto it = m_stringRefs.find(text);
+        if (it != m_stringRefs.end())
+        {
+            return it->second;
+        }
+        CheckpointString ref = addUniqueString(text);
+        m_stringRefs.emplace(text, ref);
+        return ref;
+    }
+
+    CheckpointStation& CheckpointWriter::addStation()
+    {
+        return m_stations.emplace_back();
+    }
+
+    CheckpointOrder& CheckpointWriter::addOrder()
+    {
+        return m_orders.emplace_back();
+    }
+
+    CheckpointItem& CheckpointWriter::addItem()
+    {
+        return m_items.emplace_back();
+    }
+
+    void CheckpointWriter::write(const std::string& path)
+    {
+        // Pad the string table so the file stays a multiple of 8 bytes
+        m_strings.resize((m_strings.size() + 7) & ~size_t(7), '\0');
+
+        m_header.m_stationCount = uint32_t(m_stations.size());
+        m_header.m_orderCount = uint32_t(m_orders.size());
+        m_header.m_itemCount = uint32_t(m_items.size());
+        m_header.m_stringBytes = uint32_t(m_strings.size());
+
+        std::vector<FileSection> sections = {
+            {reinterpret_cast<const char*>(&m_header), sizeof(m_header)},
+            {reinterpret_cast<const char*>(m_stations.data()), m_stations.size() * sizeof(CheckpointStation)},
+            {reinterpret_cast<const char*>(m_orders.data()), m_orders.size() * sizeof(CheckpointOrder)},
+            {reinterpret_cast<const char*>(m_items.data()), m_items.size() * sizeof(CheckpointItem)},
+            {m_strings.data(), m_strings.size()},
+        };
+        m_header.m_fileSize = 0;
+        uint64_t checksum = CHECKSUM_SEED;
+        for (size_t i = 0; i < sections.size(); i++)
+        {
+            m_header.m_fileSize += sections[i].second;
+            checksum = i ? checksum64(sections[i].first, sections[i].second, checksum) : checksum;
+        }
+        m_header.m_checksum = 0;
+        m_header.m_checksum = checksum64(reinterpret_cast<const char*>(&m_header), sizeof(m_header), checksum);
+
+        writeFileAtomically(path, sections);
+    }
+
+    CheckpointReader::CheckpointReader(const std::string& path) : m_file(path)
+    {
+        const char* data = m_file.data();
+        size_t size = m_file.size();
+        if (size < sizeof(CheckpointHeader))
+        {
+            throw FileException("Checkpoint " + path + " is truncated");
+        }
+        m_header = reinterpret_cast<const CheckpointHeader*>(data);
+
+        const CheckpointHeader& h = *m_header;
+        if (h.m_magic != CHECKPOINT_MAGIC)
+        {
+            throw FileException("Checkpoint " + path + " is not a checkpoint");
+        }
+        if (h.m_byteOrder != CHECKPOINT_BYTE_ORDER)
+        {
+            throw FileException("Checkpoint " + path + " was written with a different byte order");
+        }
+        if (h.m_version != CHECKPOINT_VERSION)
+        {
+            throw FileException("Checkpoint " + path + " has version " + std::to_string(h.m_version) +
+                                ", expected " + std::to_string(CHECKPOINT_VERSION));
+        }
+        if (h.m_fileSize != size ||
+            size != sizeof(CheckpointHeader) + uint64_t(h.m_stationCount) * sizeof(CheckpointStation) +
+                    uint64_t(h.m_orderCount) * sizeof(CheckpointOrder) +
+                    uint64_t(h.m_itemCount) * sizeof(CheckpointItem) + h.m_stringBytes)
+        {
+            throw FileException("Checkpoint " + path + " is truncated");
+        }
+
+        CheckpointHeader unsignedHeader = h;
+        unsignedHeader.m_checksum = 0;
+        uint64_t checksum = checksum64(data + sizeof(CheckpointHeader), size - sizeof(CheckpointHeader));
+        checksum = checksum64(reinterpret_cast<const char*>(&unsignedHeader), sizeof(unsignedHeader), checksum);
+        if (checksum != h.m_checksum)
+        {
+            throw FileException("Checkpoint " + path + " is corrupt (checksum mismatch)");
+        }
+
+        const char* cursor = data + sizeof(CheckpointHeader);
+        m_stations = reinterpret_cast<const CheckpointStation*>(cursor);
+        cursor += h.m_stationCount * sizeof(CheckpointStation);
+        m_orders = reinterpret_cast<const CheckpointOrder*>(cursor);
+        cursor += h.m_orderCount * sizeof(CheckpointOrder);
+        m_items = reinterpret_cast<const CheckpointItem*>(cursor);
+        cursor += h.m_itemCount * sizeof(CheckpointItem);
+        m_strings = cursor;
+    }
+} // namespace seneca
@@ -1,31 +1,102 @@
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <type_traits>
 #include "seneca/CustomerOrder.h"
+#include "seneca/RunArena.h"
+#include "seneca/SimulationContext.h"
 
 namespace seneca
 {
-    size_t CustomerOrder::m_widthField{0};
+    static_assert(std::is_trivially_destructible<Item>::value,
+                  "Item storage is released without running destructors");
 
-    CustomerOrder::CustomerOrder(const std::string& str) {
-        Utilities ut;
+    CustomerOrder::CustomerOrder(const std::string& str) : CustomerOrder(str, Utilities::getDelimiter()) {
+    }
+
+    CustomerOrder::CustomerOrder(const std::string& str, char delimiter) {
+        Utilities ut(delimiter);
         size_t next_pos = 0;
         bool more = true;
 
-        m_name = ut.extractToken(str,next_pos,more);
+        std::string name = ut.extractToken(str,next_pos,more);
 
-        m_product = ut.extractToken(str,next_pos,more);
+        std::string product = ut.extractToken(str,next_pos,more);
 
         std::vector<std::string> m_items;
         while(more) {
             m_items.push_back(ut.extractToken(str,next_pos,more));
         }
 
-        m_cntItem = m_items.size();
-        m_lstItem = new Item* [m_cntItem];
+        build(name, product, m_items);
+
+        SimulationContext::current().raiseOrderWidth(ut.getFieldWidth());
+    }
+
+    CustomerOrder::CustomerOrder(const std::string& name, const std::string& product, const std::vector<std::string>& items) {
+        build(name, product, items);
+        raiseOrderWidth(name, product, items);
+    }
+
+    CustomerOrder::CustomerOrder(std::string_view name, std::string_view product, const std::vector<std::string_view>& items) {
+        build(name, product, items);
+        raiseOrderWidth(name, product, items);
+    }
+
+    template <typename ItemNames>
+    void CustomerOrder::raiseOrderWidth(std::string_view name, std::string_view product, const ItemNames& items) const {
+        // Same field width the tokenizer would have reported for this record
+        size_t width = std::max<size_t>({1, name.length(), product.length()});
+        for(size_t i = 0; i < m_cntItem; i++) {
+            width = std::max(width, std::string_view(items[i]).length());
+        }
+
+        SimulationContext::current().raiseOrderWidth(width);
+    }
 
-        for(size_t i = 0; i < m_items.size();i++) {
-            m_lstItem[i] = new Item(m_items[i]);
+    template <typename ItemNames>
+    void CustomerOrder::build(std::string_view name, std::string_view product, const ItemNames& items) {
+        m_cntItem = items.size();
+
+        if (RunArena* arena = RunArena::current()) {
+            // Products and item names repeat across orders and are
+            // interned; customer names are mostly unique and just copied
+            m_name = arena->copy(name);
+            m_product = arena->intern(product);
+            m_lstItem = static_cast<Item*>(arena->allocate(sizeof(Item) * m_cntItem, alignof(Item)));
+            for(size_t i = 0; i < m_cntItem; i++) {
+                new (&m_lstItem[i]) Item(arena->intern(items[i]));
+            }
+            return;
         }
 
-        m_widthField = (m_widthField > ut.getFieldWidth()) ? m_widthField : ut.getFieldWidth();
+        size_t chars = name.size() + product.size();
+        for(const auto& item : items) {
+            chars += item.size();
+        }
+        m_heapBlock = ::operator new(sizeof(Item) * m_cntItem + chars);
+        m_lstItem = static_cast<Item*>(m_heapBlock);
+
+        char* text = reinterpret_cast<char*>(m_lstItem + m_cntItem);
+        auto store = [&text](std::string_view src) {
+            std::memcpy(text, src.data(), src.size());
+            std::string_view stored(text, src.size());
+            text += src.size();
+            return stored;
+        };
+        m_name = store(name);
+        m_product = store(product);
+        for(size_t i = 0; i < m_cntItem; i++) {
+            new (&m_lstItem[i]) Item(store(items[i]));
+        }
+    }
+
+    void CustomerOrder::release() {
+        // Arena storage goes away with RunArena::reset
+        ::operator delete(m_heapBlock);
+        m_heapBlock = nullptr;
+        m_lstItem = nullptr;
+        m_cntItem = 0;
     }
 
     CustomerOrder::CustomerOrder(CustomerOrder&& customer) noexcept {
@@ -34,18 +105,23 @@ namespace seneca
 
     CustomerOrder& CustomerOrder::operator=(CustomerOrder&& customer) noexcept{
         if(this != &customer) {
-            for(size_t i = 0;i < m_cntItem;i++) {
-                delete m_lstItem[i];
-            }
-
-            delete[] m_lstItem;
+            release();
 
-            m_name = std::move(customer.m_name);
-            m_product = std::move(customer.m_product);
+            m_name = customer.m_name;
+            m_product = customer.m_product;
             m_cntItem = customer.m_cntItem;
-            m_lstItem = std::move(customer.m_lstItem);
-
+            m_lstItem = customer.m_lstItem;
+            m_heapBlock = customer.m_heapBlock;
+            m_entryTick = customer.m_entryTick;
+            m_retireTick = customer.m_retireTick;
+            m_entryTimeNs = customer.m_entryTimeNs;
+            m_retireTimeNs = customer.m_retireTimeNs;
+            m_retired = customer.m_retired;
+
+            customer.m_name = {};
+            customer.m_product = {};
             customer.m_lstItem = nullptr;
+            customer.m_heapBlock = nullptr;
             customer.m_cntItem = 0;
         }
         return *this;
@@ -53,7 +129,7 @@ namespace seneca
 
     bool CustomerOrder::isOrderFilled() const {
         for(size_t i = 0;i < m_cntItem;i++) {
-            if(!m_lstItem[i]->m_isFilled) {
+            if(!m_lstItem[i].m_isFilled) {
                 return false;
             }
         }
@@ -62,7 +138,7 @@ namespace seneca
 
     bool CustomerOrder::isItemFilled(const std::string& itemName) const {
         for(size_t i = 0; i < m_cntItem; i++) {
-            if(m_lstItem[i]->m_itemName == itemName && !m_lstItem[i]->m_isFilled) {
+            if(m_lstItem[i].m_itemName == itemName && !m_lstItem[i].m_isFilled) {
                 return false;
             }
         }
@@ -70,46 +146,42 @@ namespace seneca
         return true;
     }
 
-    void CustomerOrder::fillItem(Station &station, std::ostream &os)
+    bool CustomerOrder::fillItem(Station &station, std::ostream &os)
     {
         for (size_t i = 0; i < m_cntItem; i++)
         {
-            if (m_lstItem[i]->m_itemName == station.getItemName() && !m_lstItem[i]->m_isFilled)
+            if (m_lstItem[i].m_itemName == station.getItemName() && !m_lstItem[i].m_isFilled)
             {
-                if (station.getQuantity() > 0)
+                if (station.takeUnit(m_lstItem[i].m_serialNumber))
                 {
-                    station.updateQuantity();
-                    m_lstItem[i]->m_serialNumber = station.getNextSerialNumber();
-                    m_lstItem[i]->m_isFilled = true;
-                    os << "    Filled " << m_name << ", " << m_product << " [" << m_lstItem[i]->m_itemName << "]\n";
-                    return;
+                    m_lstItem[i].m_isFilled = true;
+                    os << "    Filled " << m_name << ", " << m_product << " [" << m_lstItem[i].m_itemName << "]\n";
+                    return true;
                 }
                 else
                 {
-                    os << "    Unable to fill " << m_name << ", " << m_product << " [" << m_lstItem[i]->m_itemName << "]\n";
+                    os << "    Unable to fill " << m_name << ", " << m_product << " [" << m_lstItem[i].m_itemName << "]\n";
                 }
             }
         }
+        return false;
     }
 
     void CustomerOrder::display(std::ostream &os) const
     {
         os << m_name << " - " << m_product << "\n";
+        const size_t width = SimulationContext::current().orderWidth();
         for (size_t i = 0; i < m_cntItem; ++i)
         {
-            os << "[" << std::right << std::setw(6) << std::setfill('0') << m_lstItem[i]->m_serialNumber << "] "
-               << std::setw(m_widthField) << std::setfill(' ') << std::left << m_lstItem[i]->m_itemName << " - "
-               << (m_lstItem[i]->m_isFilled ? "FILLED" : "TO BE FILLED") << "\n";
+            os << "[" << std::right << std::setw(6) << std::setfill('0') << m_lstItem[i].m_serialNumber << "] "
+               << std::setw(width) << std::setfill(' ') << std::left << m_lstItem[i].m_itemName << " - "
+               << (m_lstItem[i].m_isFilled ? "FILLED" : "TO BE FILLED") << "\n";
         }
     }
 
     CustomerOrder::~CustomerOrder()
     {
-        for (size_t i = 0; i < m_cntItem; i++)
-        {
-            delete m_lstItem[i];
-        }
-        delete[] m_lstItem;
+        release();
     }
 
     CustomerOrder::CustomerOrder(const CustomerOrder& customer) {
@@ -117,13 +189,43 @@ namespace seneca
         throw "This is an error!";
     }
 
+    void CustomerOrder::setItemFilled(size_t i, size_t serialNumber) {
+        m_lstItem[i].m_serialNumber = serialNumber;
+        m_lstItem[i].m_isFilled = true;
+    }
+
     size_t CustomerOrder::getFilledItemCount() const {
         size_t filled = 0;
         for (size_t i = 0; i < m_cntItem; i++) {
-            if (m_lstItem[i]->m_isFilled) {
+            if (m_lstItem[i].m_isFilled) {
                 filled++;
             }
         }
         return filled;
     }
+
+    static int64_t steadyNowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void CustomerOrder::markEntry(size_t tick) {
+        m_entryTick = tick;
+        m_entryTimeNs = steadyNowNs();
+        m_retired = false;
+    }
+
+    void CustomerOrder::markRetired(size_t tick) {
+        m_retireTick = tick;
+        m_retireTimeNs = steadyNowNs();
+        m_retired = true;
+    }
+
+    void CustomerOrder::restoreStamps(size_t entryTick, int64_t entryTimeNs, size_t retireTick, int64_t retireTimeNs, bool retired) {
+        m_entryTick = entryTick;
+        m_entryTimeNs = entryTimeNs;
+        m_retireTick = retireTick;
+        m_retireTimeNs = retireTimeNs;
+        m_retired = retired;
+    }
 } // namespace seneca
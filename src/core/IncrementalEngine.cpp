@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <string_view>
+#include <unordered_set>
+#include "seneca/IncrementalEngine.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+namespace seneca
+{
+    IncrementalEngine::IncrementalEngine(const Scenario& scenario) : m_scenario(scenario)
+    {
+        const auto& stations = scenario.getStations();
+        const auto& orders = scenario.getOrders();
+
+        m_quantity.reserve(stations.size());
+        for (const auto& station : stations)
+        {
+            m_quantity.push_back(station.getQuantity());
+        }
+
+        // One supply per item name on the chain, its stations in chain order
+        m_supplyOf.assign(stations.size(), NO_SUPPLY);
+        std::unordered_map<std::string_view, uint32_t> supplyByName;
+        for (size_t station : resolveChain())
+        {
+            auto it = supplyByName.emplace(stations[station].getItemName(), uint32_t(m_supplies.size())).first;
+            if (it->second == m_supplies.size())
+            {
+                m_supplies.emplace_back();
+            }
+            m_supplies[it->second].m_stations.push_back(station);
+            m_supplies[it->second].m_total += m_quantity[station];
+            m_supplyOf[station] = it->second;
+        }
+
+        // Every ordered unit takes the next rank in its supply's demand
+        m_itemOffset.reserve(orders.size() + 1);
+        m_missing.reserve(orders.size());
+        for (size_t order = 0; order < orders.size(); order++)
+        {
+            uint32_t missing = 0;
+            for (const auto& itemName : orders[order].m_items)
+            {
+                auto it = supplyByName.find(itemName);
+                uint32_t supply = it != supplyByName.end() ? it->second : NO_SUPPLY;
+                uint32_t rank = 0;
+                if (supply != NO_SUPPLY)
+                {
+                    std::vector<uint32_t>& demand = m_supplies[supply].m_demand;
+                    rank = uint32_t(demand.size());
+                    demand.push_back(uint32_t(order));
+                }
+                m_itemSupply.push_back(supply);
+                m_itemRank.push_back(rank);
+                missing += !isFilled(m_itemSupply.size() - 1);
+            }
+            m_itemOffset.push_back(m_itemSupply.size());
+            m_missing.push_back(missing);
+            m_completed += missing == 0;
+        }
+
+        LOG_INFO("Incremental engine: " + std::to_string(orders.size()) + " orders, " +
+                 std::to_string(m_itemSupply.size()) + " items, " + std::to_string(m_completed) + " complete");
+    }
+
+    std::vector<size_t> IncrementalEngine::resolveChain() const
+    {
+        // Same resolution as LineManager: names bind to the first station
+        // carrying them, the line starts at the first station no link
+        // points to. A station linked to two successors forks the line,
+        // which the rank model below cannot represent
+        const auto& stations = m_scenario.getStations();
+        std::unordered_map<std::string_view, size_t> byName;
+        for (size_t i = 0; i < stations.size(); i++)
+        {
+            byName.emplace(stations[i].getItemName(), i);
+        }
+        auto lookup = [&byName](const std::string& name)
+        {
+            auto it = byName.find(name);
+            return it != byName.end() ? it->second : npos;
+        };
+
+        std::vector<size_t> next(stations.size(), npos);
+        std::unordered_set<std::string_view> successors;
+        for (const auto& link : m_scenario.getLinks())
+        {
+            size_t current = lookup(link.first);
+            size_t following = lookup(link.second);
+            if (current != npos && following != npos)
+            {
+                if (next[current] != npos && next[current] != following)
+                {
+                    throw ValidationException("Incremental engine models a single chain; station " +
+                                              stations[current].getItemName() + " forks");
+                }
+                next[current] = following;
+            }
+            successors.insert(link.second);
+        }
+
+        size_t first = npos;
+        for (size_t i = 0; i < stations.size() && first == npos; i++)
+        {
+            if (!successors.count(stations[i].getItemName()))
+            {
+                first = i;
+            }
+        }
+
+        std::vector<size_t> chain;
+        std::vector<bool> visited(stations.size(), false);
+        for (size_t station = first; station != npos; station = next[station])
+        {
+            if (visited[station])
+            {
+                throw ValidationException("Assembly line contains a cycle at station: " + stations[station].getItemName());
+            }
+            visited[station] = true;
+            chain.push_back(station);
+        }
+        return chain;
+    }
+
+    bool IncrementalEngine::isFilled(uint64_t item) const
+    {
+        uint32_t supply = m_itemSupply[item];
+        return supply != NO_SUPPLY && m_itemRank[item] < m_supplies[supply].m_total;
+    }
+
+    size_t IncrementalEngine::itemSerial(size_t order, size_t i) const
+    {
+        uint64_t item = m_itemOffset[order] + i;
+        if (!isFilled(item))
+        {
+            return 0;
+        }
+
+        // Units are handed out station by station along the chain
+        size_t rank = m_itemRank[item];
+        for (size_t station : m_supplies[m_itemSupply[item]].m_stations)
+        {
+            if (rank < m_quantity[station])
+            {
+                return m_scenario.getStations()[station].getSerialNumber() + rank;
+            }
+            rank -= m_quantity[station];
+        }
+        return 0;
+    }
+
+    size_t IncrementalEngine::remainingQuantity(size_t station) const
+    {
+        if (m_supplyOf[station] == NO_SUPPLY)
+        {
+            return m_quantity[station];
+        }
+
+        const Supply& supply = m_supplies[m_supplyOf[station]];
+        size_t demand = supply.m_demand.size();
+        for (size_t s : supply.m_stations)
+        {
+            if (s == station)
+            {
+                return m_quantity[station] - std::min(demand, m_quantity[station]);
+            }
+            demand -= std::min(demand, m_quantity[s]);
+        }
+        return m_quantity[station];
+    }
+
+    size_t IncrementalEngine::findStation(const std::string& itemName) const
+    {
+        const auto& stations = m_scenario.getStations();
+        for (size_t i = 0; i < stations.size(); i++)
+        {
+            if (stations[i].getItemName() == itemName)
+            {
+                return i;
+            }
+        }
+        return npos;
+    }
+
+    OutcomeDiff IncrementalEngine::setQuantity(size_t station, size_t quantity)
+    {
+        OutcomeDiff diff;
+        size_t previous = m_quantity[station];
+        m_quantity[station] = quantity;
+        if (m_supplyOf[station] == NO_SUPPLY)
+        {
+            return diff;   // Off the line: no order ever reaches it
+        }
+
+        // Only demand ranks between the old and the new total change state
+        Supply& supply = m_supplies[m_supplyOf[station]];
+        size_t oldTotal = supply.m_total;
+        size_t newTotal = oldTotal - previous + quantity;
+        supply.m_total = newTotal;
+
+        size_t demand = supply.m_demand.size();
+        for (size_t rank = oldTotal; rank < std::min(newTotal, demand); rank++)
+        {
+            uint32_t order = supply.m_demand[rank];
+            diff.m_itemsFilled++;
+            if (--m_missing[order] == 0)
+            {
+                diff.m_completed.push_back(order);
+                m_completed++;
+            }
+        }
+        for (size_t rank = newTotal; rank < std::min(oldTotal, demand); rank++)
+        {
+            uint32_t order = supply.m_demand[rank];
+            diff.m_itemsUnfilled++;
+            if (m_missing[order]++ == 0)
+            {
+                diff.m_incomplete.push_back(order);
+                m_completed--;
+            }
+        }
+        return diff;
+    }
+} // namespace seneca
@@ -0,0 +1,188 @@
+#include <iomanip>
+#include <algorithm>
+#include <cmath>
+#include "seneca/LatencyHistogram.h"
+
+namespace seneca
+{
+    namespace
+    {
+        constexpr uint64_t SUB_BUCKETS = uint64_t(1) << LatencyHistogram::SUB_BUCKET_BITS;
+        constexpr uint64_t HALF = SUB_BUCKETS / 2;
+
+        unsigned highestBit(uint64_t value)
+        {
+            unsigned bit = 0;
+            while (value >>= 1)
+            {
+                bit++;
+            }
+            return bit;
+        }
+    }
+
+    // Values below SUB_BUCKETS get one bucket each. Above that, the value is
+    // shifted until it has SUB_BUCKET_BITS significant bits; the shift picks
+    // the power-of-two range and the remaining bits the sub-bucket in it.
+    size_t LatencyHistogram::bucketIndex(uint64_t value)
+    {
+        if (value < SUB_BUCKETS)
+        {
+            return size_t(value);
+        }
+        unsigned shift = highestBit(value) - (SUB_BUCKET_BITS - 1);
+        return size_t(shift * HALF + (value >> shift));
+    }
+
+    uint64_t LatencyHistogram::bucketLowest(size_t index)
+    {
+        if (index < SUB_BUCKETS)
+        {
+            return index;
+        }
+        uint64_t shift = index / HALF - 1;
+        return (index - shift * HALF) << shift;
+    }
+
+    uint64_t LatencyHistogram::bucketHighest(size_t index)
+    {
+        if (index < SUB_BUCKETS)
+        {
+            return index;
+        }
+        uint64_t shift = index / HALF - 1;
+        return bucketLowest(index) + ((uint64_t(1) << shift) - 1);
+    }
+
+    void LatencyHistogram::record(uint64_t value, uint64_t count)
+    {
+        size_t index = bucketIndex(value);
+        if (index >= m_counts.size())
+        {
+            m_counts.resize(index + 1, 0);
+        }
+        m_counts[index] += count;
+        m_total += count;
+        m_min = std::min(m_min, value);
+        m_max = std::max(m_max, value);
+        m_sum += (long double)value * count;
+    }
+
+    void LatencyHistogram::merge(const LatencyHistogram& other)
+    {
+        if (other.m_counts.size() > m_counts.size())
+        {
+            m_counts.resize(other.m_counts.size(), 0);
+        }
+        for (size_t i = 0; i < other.m_counts.size(); i++)
+        {
+            m_counts[i] += other.m_counts[i];
+        }
+        m_total += other.m_total;
+        m_min = std::min(m_min, other.m_min);
+        m_max = std::max(m_max, other.m_max);
+        m_sum += other.m_sum;
+    }
+
+    void LatencyHistogram::reset()
+    {
+        *this = LatencyHistogram();
+    }
+
+    uint64_t LatencyHistogram::percentile(double q) const
+    {
+        if (m_total == 0)
+        {
+            return 0;
+        }
+        q = std::min(1.0, std::max(0.0, q));
+        uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(q * double(m_total))));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < m_counts.size(); i++)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+            {
+                return std::min(bucketHighest(i), m_max);
+            }
+        }
+        return m_max;
+    }
+
+    void LatencyRecorder::record(const CustomerOrder& order, bool completed)
+    {
+        if (!order.hasRetired())
+        {
+            return;
+        }
+        uint64_t ticks = order.getRetireTick() - order.getEntryTick();
+        uint64_t wallUs = uint64_t(order.getRetireTimeNs() - order.getEntryTimeNs()) / 1000;
+
+        for (const std::string& product : {std::string(order.getProduct()), std::string("*")})
+        {
+            Group& group = m_groups[{product, completed}];
+            group.m_ticks.record(ticks);
+            group.m_wallUs.record(wallUs);
+        }
+    }
+
+    void LatencyRecorder::recordAll(const OrderQueue& orders, bool completed)
+    {
+        for (const auto& order : orders)
+        {
+            record(order, completed);
+        }
+    }
+
+    std::vector<LatencySummary> LatencyRecorder::summarize() const
+    {
+        std::vector<LatencySummary> summaries;
+        for (const auto& entry : m_groups)
+        {
+            const Group& group = entry.second;
+            for (const auto* metric : {"ticks", "wall_us"})
+            {
+                const LatencyHistogram& h = std::string(metric) == "ticks" ? group.m_ticks : group.m_wallUs;
+                LatencySummary s;
+                s.m_product = entry.first.first;
+                s.m_completed = entry.first.second;
+                s.m_metric = metric;
+                s.m_count = h.count();
+                s.m_mean = h.mean();
+                s.m_p50 = h.percentile(0.50);
+                s.m_p90 = h.percentile(0.90);
+                s.m_p99 = h.percentile(0.99);
+                s.m_p999 = h.percentile(0.999);
+                s.m_max = h.max();
+                summaries.push_back(s);
+            }
+        }
+        return summaries;
+    }
+
+    void LatencyRecorder::report(std::ostream& os) const
+    {
+        size_t width = 7;
+        for (const auto& entry : m_groups)
+        {
+            width = std::max(width, entry.first.first.length());
+        }
+
+        os << std::left << std::setw(int(width)) << "Product" << "  "
+           << std::setw(12) << "Outcome" << std::setw(8) << "Metric"
+           << std::right << std::setw(9) << "Count" << std::setw(11) << "Mean"
+           << std::setw(9) << "p50" << std::setw(9) << "p90" << std::setw(9) << "p99"
+           << std::setw(9) << "p999" << std::setw(9) << "Max" << "\n";
+        for (const auto& s : summarize())
+        {
+            os << std::left << std::setw(int(width)) << s.m_product << "  "
+               << std::setw(12) << (s.m_completed ? "complete" : "incomplete")
+               << std::setw(8) << s.m_metric
+               << std::right << std::setw(9) << s.m_count
+               << std::setw(11) << std::fixed << std::setprecision(1) << s.m_mean
+               << std::setw(9) << s.m_p50 << std::setw(9) << s.m_p90 << std::setw(9) << s.m_p99
+               << std::setw(9) << s.m_p999 << std::setw(9) << s.m_max << "\n";
+        }
+        os.unsetf(std::ios::floatfield);
+    }
+} // namespace seneca
@@ -1,9 +1,45 @@
 #include "seneca/LineManager.h"
 #include "seneca/Logger.h"
 #include "seneca/Exceptions.h"
+#include "seneca/EventPublisher.h"
+#include "seneca/Checkpoint.h"
+#include "seneca/ThreadPool.h"
+#include <sstream>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace seneca
 {
+    // The replicas of one station: the registry's workstation first, then
+    // the copies the line owns
+    struct ReplicaGroup
+    {
+        SharedInventory m_inventory;
+        std::vector<Workstation *> m_lanes;
+        std::vector<std::unique_ptr<Workstation>> m_copies;
+    };
+
+    namespace
+    {
+        // Below this many stations per worker a fill phase is not worth
+        // handing to the pool
+        constexpr size_t MIN_STATIONS_PER_TASK = 64;
+
+        // The i-th successor of a station in link order, nullptr past the last
+        Workstation *successor(const Workstation *ws, size_t i)
+        {
+            if (const ForkRoutes *fork = ws->getFork())
+            {
+                return i < fork->m_successors.size() ? fork->m_successors[i] : nullptr;
+            }
+            return i == 0 ? ws->getNextStation() : nullptr;
+        }
+    }
+
     LineManager::LineManager(const std::string &file, const std::vector<Workstation *> &stations)
         : m_cntCustomerOrder(0), m_firstStation(nullptr)
     {
@@ -20,6 +56,12 @@ namespace seneca
 
         while (std::getline(inputFile, record))
         {
+            // A blank line links nothing; it must not read as a station
+            // with an empty name
+            if (record.find_first_not_of(" \t\r") == std::string::npos)
+            {
+                continue;
+            }
             Utilities util;
             size_t next_pos = 0;
             bool more = true;
@@ -30,47 +72,134 @@ namespace seneca
             stationLinks.emplace_back(stationName, nextStationName);
         }
 
+        linkStations(stationLinks, stations);
+    }
+
+    LineManager::LineManager(const std::vector<std::pair<std::string, std::string>> &stationLinks,
+                             const std::vector<Workstation *> &stations)
+        : m_cntCustomerOrder(0), m_firstStation(nullptr)
+    {
+        linkStations(stationLinks, stations);
+    }
+
+    void LineManager::linkStations(const std::vector<std::pair<std::string, std::string>> &stationLinks,
+                                   const std::vector<Workstation *> &stations)
+    {
+        auto started = std::chrono::steady_clock::now();
+
+        // Item name -> index in stations; the first station with a name
+        // wins, as a front-to-back search would
+        constexpr size_t npos = static_cast<size_t>(-1);
+        std::unordered_map<std::string_view, size_t> byName;
+        byName.reserve(stations.size());
+        for (size_t i = 0; i < stations.size(); i++)
+        {
+            byName.emplace(stations[i]->getItemName(), i);
+        }
+        auto lookup = [&byName](const std::string &name)
+        {
+            auto it = byName.find(name);
+            return it != byName.end() ? it->second : npos;
+        };
+
+        // A station's first link sets its next station; a later link to
+        // another station makes it a fork, whose successors are kept in
+        // link order, each once
         std::vector<Workstation *> activeStations;
+        activeStations.reserve(stationLinks.size());
+        std::vector<bool> linked(stations.size(), false);
+        std::unordered_map<Workstation *, std::vector<Workstation *>> forks;
+        std::unordered_set<std::string_view> successors;
+        successors.reserve(stationLinks.size());
 
         for (const auto &link : stationLinks)
         {
-            const std::string& stationName = link.first;
-            const std::string& nextStationName = link.second;
-            
-            auto current = std::find_if(stations.begin(), stations.end(),
-                                        [stationName](Workstation *ws)
-                                        { return ws->getItemName() == stationName; });
+            size_t index = lookup(link.first);
+            size_t nextIndex = lookup(link.second);
+            Workstation *current = index != npos ? stations[index] : nullptr;
+            Workstation *next = nextIndex != npos ? stations[nextIndex] : nullptr;
+            successors.insert(link.second);
 
-            auto next = std::find_if(stations.begin(), stations.end(),
-                                     [nextStationName](Workstation *ws)
-                                     { return ws->getItemName() == nextStationName; });
-
-            if (current != stations.end())
+            if (current && !linked[index])
             {
-                (*current)->setNextStation(next != stations.end() ? *next : nullptr);
-                activeStations.push_back(*current);
+                linked[index] = true;
+                current->setNextStation(next);
+                activeStations.push_back(current);
+            }
+            else if (current && next && current->getNextStation() != next)
+            {
+                std::vector<Workstation *> &out = forks[current];
+                if (!current->getNextStation())
+                {
+                    current->setNextStation(next);
+                }
+                else if (out.empty())
+                {
+                    out = {current->getNextStation(), next};
+                }
+                else if (std::find(out.begin(), out.end(), next) == out.end())
+                {
+                    out.push_back(next);
+                }
+            }
+            if (!current || (!next && !link.second.empty()))
+            {
+                throw ValidationException("Assembly line link names an unknown station: " +
+                                          (current ? link.second : link.first));
             }
         }
 
-        auto it = std::find_if(stations.begin(), stations.end(),
-                               [&stationLinks](Workstation *ws)
-                               {
-                                   return std::none_of(stationLinks.begin(), stationLinks.end(),
-                                                       [&ws](const std::pair<std::string, std::string> &link)
-                                                       {
-                                                           return ws->getItemName() == link.second;
-                                                       });
-                               });
+        for (size_t i = 0; i < activeStations.size() && !forks.empty(); i++)
+        {
+            Workstation *ws = activeStations[i];
+            auto fork = forks.find(ws);
+            if (fork != forks.end() && fork->second.size() > 1)
+            {
+                m_forks.push_back(std::make_unique<ForkRoutes>());
+                m_forks.back()->m_station = ws;
+                m_forks.back()->m_successors = std::move(fork->second);
+                ws->setFork(m_forks.back().get());
+            }
+        }
+        for (auto &fork : m_forks)
+        {
+            mapBranches(*fork);
+        }
 
-        if (it != stations.end())
+        // The line starts at the first station nothing links to
+        for (Workstation *ws : stations)
         {
-            m_firstStation = *it;
+            if (!successors.count(ws->getItemName()))
+            {
+                m_firstStation = ws;
+                break;
+            }
         }
 
         m_activeLine = activeStations;
-        m_cntCustomerOrder = g_pending.size();
-        
-        LOG_INFO("LineManager initialized with " + std::to_string(m_activeLine.size()) + " stations");
+        m_cntCustomerOrder = m_context->pending().size();
+        m_retiredCompleted = m_context->completed().size();
+        m_retiredIncomplete = m_context->incomplete().size();
+
+        try
+        {
+            validateTopology(stations);
+        }
+        catch (...)
+        {
+            // No destructor runs for a half-built line: unhook the forks
+            // the stations would otherwise keep pointing at
+            for (auto &fork : m_forks)
+            {
+                fork->m_station->setFork(nullptr);
+            }
+            throw;
+        }
+
+        auto elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        LOG_INFO("LineManager initialized with " + std::to_string(m_activeLine.size()) + " stations (topology resolved in " +
+                 std::to_string(elapsedUs) + " us)");
         LOG_INFO("Pending orders: " + std::to_string(m_cntCustomerOrder));
         if (m_firstStation)
         {
@@ -78,15 +207,225 @@ namespace seneca
         }
     }
 
+    void LineManager::mapBranches(ForkRoutes &fork) const
+    {
+        fork.m_reach.assign(fork.m_successors.size(), {});
+        for (size_t s = 0; s < fork.m_successors.size(); s++)
+        {
+            auto &reach = fork.m_reach[s];
+            std::unordered_set<const Workstation *> seen{fork.m_successors[s]};
+            std::vector<Workstation *> stack{fork.m_successors[s]};
+            while (!stack.empty())
+            {
+                Workstation *ws = stack.back();
+                stack.pop_back();
+                reach[ws->getItemName()].push_back(ws);
+                for (size_t i = 0; Workstation *next = successor(ws, i); i++)
+                {
+                    if (seen.insert(next).second)
+                    {
+                        stack.push_back(next);
+                    }
+                }
+            }
+        }
+    }
+
+    LineManager::~LineManager()
+    {
+        for (auto &fork : m_forks)
+        {
+            fork->m_station->setFork(nullptr);
+        }
+        for (auto &group : m_replicas)
+        {
+            for (Workstation *lane : group->m_lanes)
+            {
+                lane->shareInventory(nullptr);
+                lane->setLanes(nullptr);
+            }
+        }
+    }
+
+    void LineManager::replicateStation(const std::string &itemName, size_t lanes)
+    {
+        auto it = std::find_if(m_activeLine.begin(), m_activeLine.end(),
+                               [&itemName](const Workstation *ws) { return ws->getItemName() == itemName; });
+        if (it == m_activeLine.end())
+        {
+            throw ValidationException("Cannot replicate " + itemName + ": not a station on the assembly line");
+        }
+        Workstation *primary = *it;
+        if (primary->getLanes())
+        {
+            throw ValidationException("Station " + itemName + " is already replicated");
+        }
+        if (lanes < 1)
+        {
+            throw ValidationException("Station " + itemName + " needs at least one replica");
+        }
+        if (lanes == 1)
+        {
+            return;
+        }
+
+        auto group = std::make_unique<ReplicaGroup>();
+        group->m_inventory.m_quantity.store(primary->getQuantity(), std::memory_order_relaxed);
+        group->m_inventory.m_nextSerial.store(primary->getSerialNumber(), std::memory_order_relaxed);
+        group->m_lanes.push_back(primary);
+        for (size_t i = 1; i < lanes; i++)
+        {
+            group->m_copies.push_back(std::make_unique<Workstation>(static_cast<const Station &>(*primary)));
+            Workstation *copy = group->m_copies.back().get();
+            copy->setNextStation(primary->getNextStation());
+            copy->setFork(primary->getFork());
+            group->m_lanes.push_back(copy);
+        }
+        for (Workstation *lane : group->m_lanes)
+        {
+            lane->shareInventory(&group->m_inventory);
+            lane->setLanes(&group->m_lanes);
+        }
+
+        m_activeLine.insert(it + 1, group->m_lanes.begin() + 1, group->m_lanes.end());
+        m_replicas.push_back(std::move(group));
+        LOG_INFO("Station " + itemName + " runs on " + std::to_string(lanes) + " replicas");
+    }
+
+    void LineManager::setThreads(size_t threads)
+    {
+        m_pool = threads > 1 ? std::make_unique<ThreadPool>(threads) : nullptr;
+        m_traces.clear();
+    }
+
+    void LineManager::validateTopology(const std::vector<Workstation *> &stations) const
+    {
+        if (!m_firstStation)
+        {
+            if (!stations.empty())
+            {
+                throw ValidationException("Assembly line has no first station: every station is linked to from another");
+            }
+            return;
+        }
+
+        // Depth-first walk from the head; a station met again while it is
+        // still on the walk's path closes a cycle
+        enum class Mark : char { ON_PATH, DONE };
+        std::unordered_map<const Workstation *, Mark> onLine;
+        onLine.reserve(stations.size());
+        onLine.emplace(m_firstStation, Mark::ON_PATH);
+        std::vector<std::pair<const Workstation *, size_t>> path{{m_firstStation, 0}};
+        while (!path.empty())
+        {
+            const Workstation *ws = path.back().first;
+            const Workstation *next = successor(ws, path.back().second++);
+            if (!next)
+            {
+                onLine[ws] = Mark::DONE;
+                path.pop_back();
+                continue;
+            }
+            auto entry = onLine.emplace(next, Mark::ON_PATH);
+            if (entry.second)
+            {
+                path.emplace_back(next, 0);
+            }
+            else if (entry.first->second == Mark::ON_PATH)
+            {
+                throw ValidationException("Assembly line contains a cycle at station: " + next->getItemName());
+            }
+        }
+
+        size_t unreachable = 0;
+        for (const Workstation *ws : m_activeLine)
+        {
+            unreachable += !onLine.count(ws);
+        }
+        size_t orphans = 0;
+        for (const Workstation *ws : stations)
+        {
+            orphans += !onLine.count(ws);
+        }
+        orphans -= std::min(orphans, unreachable);
+
+        if (unreachable)
+        {
+            LOG_WARN(std::to_string(unreachable) + " linked station(s) are not reachable from " +
+                     m_firstStation->getItemName());
+        }
+        if (orphans)
+        {
+            LOG_WARN(std::to_string(orphans) + " station(s) are not on the assembly line");
+        }
+    }
+
     void LineManager::reorderStations()
     {
         std::vector<Workstation *> reorderedLine;
-        Workstation *currentStation = m_firstStation;
+        auto append = [&reorderedLine](Workstation *ws)
+        {
+            if (const auto *lanes = ws->getLanes())
+            {
+                reorderedLine.insert(reorderedLine.end(), lanes->begin(), lanes->end());
+            }
+            else
+            {
+                reorderedLine.push_back(ws);
+            }
+        };
 
-        while (currentStation)
+        if (m_forks.empty())
         {
-            reorderedLine.push_back(currentStation);
-            currentStation = currentStation->getNextStation();
+            for (Workstation *ws = m_firstStation; ws; ws = ws->getNextStation())
+            {
+                append(ws);
+            }
+            m_activeLine = reorderedLine;
+            return;
+        }
+
+        // Topological order of the stations reachable from the head, so an
+        // order can still cross several stations in one move phase. Of the
+        // stations ready at the same time, the one a breadth-first walk from
+        // the head meets first goes first.
+        std::vector<Workstation *> reached{m_firstStation};
+        std::unordered_map<const Workstation *, size_t> rank{{m_firstStation, 0}};
+        for (size_t r = 0; r < reached.size(); r++)
+        {
+            for (size_t i = 0; Workstation *next = successor(reached[r], i); i++)
+            {
+                if (rank.emplace(next, reached.size()).second)
+                {
+                    reached.push_back(next);
+                }
+            }
+        }
+
+        std::vector<size_t> inDegree(reached.size(), 0);
+        for (Workstation *ws : reached)
+        {
+            for (size_t i = 0; Workstation *next = successor(ws, i); i++)
+            {
+                inDegree[rank[next]]++;
+            }
+        }
+
+        std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> ready;
+        ready.push(0);
+        while (!ready.empty())
+        {
+            Workstation *ws = reached[ready.top()];
+            ready.pop();
+            append(ws);
+            for (size_t i = 0; Workstation *next = successor(ws, i); i++)
+            {
+                size_t r = rank[next];
+                if (--inDegree[r] == 0)
+                {
+                    ready.push(r);
+                }
+            }
         }
 
         m_activeLine = reorderedLine;
@@ -94,35 +433,450 @@ namespace seneca
 
     bool LineManager::run(std::ostream &os)
     {
-        static size_t iterationCount = 0;
-        iterationCount++;
-        LOG_DEBUG("Running iteration " + std::to_string(iterationCount));
-        os << "Line Manager Iteration: " << iterationCount << std::endl;
+        m_iterationCount++;
+        LOG_DEBUG("Running iteration " + std::to_string(m_iterationCount));
+        os << "Line Manager Iteration: " << m_iterationCount << std::endl;
 
-        if (!g_pending.empty())
+        OrderQueue& pending = m_context->pending();
+        OrderQueue& completed = m_context->completed();
+        OrderQueue& incomplete = m_context->incomplete();
+
+        if (!pending.empty())
         {
-            *m_firstStation += std::move(g_pending.front());
-            g_pending.pop_front();
+            pending.front().markEntry(m_iterationCount);
+            *m_firstStation->pickLane() += pending.frontHandle();
+            pending.pop_front();
         }
 
-        std::for_each(m_activeLine.begin(), m_activeLine.end(),
-                      [&os](Workstation *ws)
-                      { ws->fill(os); });
+        m_fillsSinceFrame += fillStations(os);
 
         std::for_each(m_activeLine.begin(), m_activeLine.end(),
                       [](Workstation *ws)
                       { ws->attemptToMoveOrder(); });
 
-        bool allProcessed = (g_completed.size() + g_incomplete.size() == m_cntCustomerOrder);
+        // Orders retired this iteration are the new tails of the output queues
+        for (size_t i = m_retiredCompleted; i < completed.size(); i++)
+        {
+            completed[i].markRetired(m_iterationCount);
+        }
+        for (size_t i = m_retiredIncomplete; i < incomplete.size(); i++)
+        {
+            incomplete[i].markRetired(m_iterationCount);
+        }
+        m_retiredCompleted = completed.size();
+        m_retiredIncomplete = incomplete.size();
+
+        bool allProcessed = (completed.size() + incomplete.size() == m_cntCustomerOrder);
+
+        static EventPublisher& events = EventPublisher::getInstance();
+        if (events.frameDue() || (allProcessed && events.isActive()))
+        {
+            publishProgress(allProcessed);
+        }
+
         if (allProcessed)
         {
-            LOG_INFO("All orders processed. Completed: " + std::to_string(g_completed.size()) + 
-                     ", Incomplete: " + std::to_string(g_incomplete.size()));
+            LOG_INFO("All orders processed. Completed: " + std::to_string(completed.size()) + 
+                     ", Incomplete: " + std::to_string(incomplete.size()));
         }
         
         return allProcessed;
     }
 
+    size_t LineManager::fillStations(std::ostream &os)
+    {
+        size_t tasks = m_pool ? std::min(m_pool->size(), m_activeLine.size() / MIN_STATIONS_PER_TASK) : 0;
+        if (tasks < 2)
+        {
+            size_t fills = 0;
+            for (Workstation *ws : m_activeLine)
+            {
+                fills += ws->fill(os);
+            }
+            return fills;
+        }
+
+        // Every station fills only its own front order, so the ranges share
+        // nothing but the inventories of replicated stations, which are
+        // atomic. Each range writes its trace to its own buffer.
+        bool tracing = os.rdbuf() != nullptr;
+        m_traces.resize(tasks);
+        std::vector<size_t> fills(tasks, 0);
+        for (size_t t = 0; t < tasks; t++)
+        {
+            m_pool->submit([this, t, tasks, tracing, &fills](size_t)
+            {
+                std::ostream discard(nullptr);
+                std::ostream &trace = tracing ? static_cast<std::ostream &>(m_traces[t]) : discard;
+                size_t begin = m_activeLine.size() * t / tasks;
+                size_t end = m_activeLine.size() * (t + 1) / tasks;
+                for (size_t i = begin; i < end; i++)
+                {
+                    fills[t] += m_activeLine[i]->fill(trace);
+                }
+            });
+        }
+        m_pool->wait();
+
+        size_t total = 0;
+        for (size_t t = 0; t < tasks; t++)
+        {
+            if (tracing)
+            {
+                os << m_traces[t].str();
+                m_traces[t].str("");
+            }
+            total += fills[t];
+        }
+        return total;
+    }
+
+    void LineManager::fastForward()
+    {
+        if (!m_replicas.empty())
+        {
+            throw StationException("fastForward() cannot model replicated stations");
+        }
+        if (!m_forks.empty())
+        {
+            throw StationException("fastForward() cannot model forked lines");
+        }
+
+        // Orders travel the chain from the first station in arrival order and
+        // every station serves its queue FIFO, so each station sees the orders
+        // in pending order. At a station the front order takes one unit per
+        // matching unfilled item, in item order, until the item is filled or
+        // the station runs dry. The outcome is therefore fixed by that order
+        // alone: walking the orders once and sending each item to the first
+        // station with its name that still has stock reproduces run().
+        struct Supply
+        {
+            std::vector<Workstation *> m_stations;  // Chain order
+            size_t m_next{};                        // First one that may still have stock
+        };
+        std::unordered_map<std::string_view, Supply> supplies;
+
+        for (Workstation *ws = m_firstStation; ws; ws = ws->getNextStation())
+        {
+            if (ws->getOrderCount())
+            {
+                throw StationException("fastForward() needs a line with no orders in progress");
+            }
+            supplies[ws->getItemName()].m_stations.push_back(ws);
+        }
+
+        OrderQueue &pending = m_context->pending();
+        OrderQueue &completed = m_context->completed();
+        OrderQueue &incomplete = m_context->incomplete();
+
+        while (!pending.empty())
+        {
+            CustomerOrder &order = pending.front();
+            for (size_t i = 0; i < order.getItemCount(); i++)
+            {
+                const Item &item = order.getItem(i);
+                if (item.m_isFilled)
+                {
+                    continue;
+                }
+                auto it = supplies.find(item.m_itemName);
+                if (it == supplies.end())
+                {
+                    continue;
+                }
+
+                Supply &supply = it->second;
+                while (supply.m_next < supply.m_stations.size() && supply.m_stations[supply.m_next]->getQuantity() == 0)
+                {
+                    supply.m_next++;
+                }
+                if (supply.m_next < supply.m_stations.size())
+                {
+                    Workstation *station = supply.m_stations[supply.m_next];
+                    station->updateQuantity();
+                    order.setItemFilled(i, station->getNextSerialNumber());
+                }
+            }
+
+            OrderHandle handle = pending.frontHandle();
+            (order.isOrderFilled() ? completed : incomplete).push_back(handle);
+            pending.pop_front();
+        }
+
+        m_retiredCompleted = completed.size();
+        m_retiredIncomplete = incomplete.size();
+        LOG_INFO("Fast-forwarded all orders. Completed: " + std::to_string(completed.size()) +
+                 ", Incomplete: " + std::to_string(incomplete.size()));
+    }
+
+    ShardStats LineManager::runSharded(const ShardOptions &options)
+    {
+        if (!m_replicas.empty() || !m_forks.empty())
+        {
+            throw StationException("runSharded() needs a single chain without replicated stations");
+        }
+        if (!m_firstStation)
+        {
+            throw StationException("runSharded() needs a line with stations");
+        }
+
+        std::vector<Workstation *> chain;
+        for (Workstation *ws = m_firstStation; ws; ws = ws->getNextStation())
+        {
+            if (ws->getOrderCount())
+            {
+                throw StationException("runSharded() needs a line with no orders in progress");
+            }
+            chain.push_back(ws);
+        }
+
+        ShardStats stats = seneca::runSharded(chain, *m_context, options);
+        m_retiredCompleted = m_context->completed().size();
+        m_retiredIncomplete = m_context->incomplete().size();
+        return stats;
+    }
+
+    TimedStats LineManager::runTimed(const TimedOptions &options)
+    {
+        if (!m_firstStation)
+        {
+            throw StationException("runTimed() needs a line with stations");
+        }
+        for (const Workstation *ws : m_activeLine)
+        {
+            if (ws->getOrderCount())
+            {
+                throw StationException("runTimed() needs a line with no orders in progress");
+            }
+        }
+
+        TimedStats stats = seneca::runTimed(m_activeLine, m_firstStation, *m_context, options);
+        m_retiredCompleted = m_context->completed().size();
+        m_retiredIncomplete = m_context->incomplete().size();
+        LOG_INFO("Timed run finished at t=" + std::to_string(stats.m_makespan) + " after " +
+                 std::to_string(stats.m_events) + " events. Completed: " + std::to_string(m_retiredCompleted) +
+                 ", Incomplete: " + std::to_string(m_retiredIncomplete));
+        return stats;
+    }
+
+    void LineManager::publishProgress(bool done)
+    {
+        std::ostringstream ss;
+        ss << "{\"iteration\":" << m_iterationCount
+           << ",\"pending\":" << m_context->pending().size()
+           << ",\"completed\":" << m_context->completed().size()
+           << ",\"incomplete\":" << m_context->incomplete().size()
+           << ",\"fills\":" << m_fillsSinceFrame
+           << ",\"done\":" << (done ? "true" : "false")
+           << ",\"stations\":[";
+        for (size_t i = 0; i < m_activeLine.size(); ++i)
+        {
+            ss << (i ? "," : "")
+               << "{\"name\":\"" << escapeJson(m_activeLine[i]->getItemName())
+               << "\",\"queue\":" << m_activeLine[i]->getOrderCount()
+               << ",\"inventory\":" << m_activeLine[i]->getQuantity() << "}";
+        }
+        ss << "]}";
+
+        m_fillsSinceFrame = 0;
+        EventPublisher::getInstance().publish(done ? "complete" : "progress", ss.str());
+    }
+
+    void LineManager::saveCheckpoint(const std::string &path) const
+    {
+        auto started = std::chrono::steady_clock::now();
+        CheckpointWriter writer(m_iterationCount, m_cntCustomerOrder);
+
+        size_t orderCount = m_context->pending().size() + m_context->completed().size() + m_context->incomplete().size();
+        for (const Workstation *ws : m_activeLine)
+        {
+            orderCount += ws->getOrderCount();
+        }
+        writer.reserve(m_activeLine.size(), orderCount, orderCount * 4);
+
+        uint32_t items = 0;
+        auto addQueue = [&writer, &items](const OrderQueue &queue)
+        {
+            for (const CustomerOrder &order : queue)
+            {
+                CheckpointOrder &record = writer.addOrder();
+                record.m_name = writer.addUniqueString(order.getCustomerName());
+                record.m_product = writer.addString(order.getProduct());
+                record.m_firstItem = items;
+                record.m_itemCount = uint32_t(order.getItemCount());
+                record.m_entryTick = order.getEntryTick();
+                record.m_retireTick = order.getRetireTick();
+                record.m_entryTimeNs = order.getEntryTimeNs();
+                record.m_retireTimeNs = order.getRetireTimeNs();
+                record.m_retired = order.hasRetired();
+                for (size_t i = 0; i < order.getItemCount(); i++)
+                {
+                    const Item &item = order.getItem(i);
+                    CheckpointItem &itemRecord = writer.addItem();
+                    itemRecord.m_name = writer.addString(item.m_itemName);
+                    itemRecord.m_serialNumber = item.m_serialNumber;
+                    itemRecord.m_filled = item.m_isFilled;
+                }
+                items += uint32_t(order.getItemCount());
+            }
+        };
+
+        for (const Workstation *ws : m_activeLine)
+        {
+            StationStats stats = ws->getMetrics().snapshot();
+            CheckpointStation &record = writer.addStation();
+            record.m_name = writer.addString(ws->getItemName());
+            record.m_queued = uint32_t(ws->getOrderCount());
+            record.m_serialNumber = ws->getSerialNumber();
+            record.m_quantity = ws->getQuantity();
+            record.m_fills = stats.m_fills;
+            record.m_failedFills = stats.m_failedFills;
+            record.m_ordersPassed = stats.m_ordersPassed;
+            record.m_maxQueueDepth = stats.m_maxQueueDepth;
+            record.m_queueDepthSum = stats.m_queueDepthSum;
+            record.m_busyTicks = stats.m_busyTicks;
+            record.m_idleTicks = stats.m_idleTicks;
+        }
+
+        addQueue(m_context->pending());
+        for (const Workstation *ws : m_activeLine)
+        {
+            addQueue(ws->getOrders());
+        }
+        addQueue(m_context->completed());
+        addQueue(m_context->incomplete());
+
+        writer.header().m_pending = uint32_t(m_context->pending().size());
+        writer.header().m_completed = uint32_t(m_context->completed().size());
+        writer.header().m_incomplete = uint32_t(m_context->incomplete().size());
+        writer.write(path);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+        LOG_INFO("Checkpoint written to " + path + " at iteration " + std::to_string(m_iterationCount) +
+                 " (" + std::to_string(elapsed.count()) + " us)");
+    }
+
+    void LineManager::restoreCheckpoint(const std::string &path)
+    {
+        auto started = std::chrono::steady_clock::now();
+        CheckpointReader reader(path);
+        const CheckpointHeader &header = reader.header();
+
+        // Check everything before touching the line, so a bad file leaves it as it was
+        if (header.m_stationCount != m_activeLine.size())
+        {
+            throw ValidationException("Checkpoint " + path + " has " + std::to_string(header.m_stationCount) +
+                                      " stations on the line, this line has " + std::to_string(m_activeLine.size()));
+        }
+        auto validString = [&header](CheckpointString ref)
+        {
+            return uint64_t(ref.m_offset) + ref.m_length <= header.m_stringBytes;
+        };
+        uint64_t queued = uint64_t(header.m_pending) + header.m_completed + header.m_incomplete;
+        for (size_t i = 0; i < m_activeLine.size(); i++)
+        {
+            const CheckpointStation &record = reader.station(i);
+            if (!validString(record.m_name) || reader.string(record.m_name) != m_activeLine[i]->getItemName())
+            {
+                throw ValidationException("Checkpoint " + path + " does not match this line at station " +
+                                          std::to_string(i + 1) + " (" + m_activeLine[i]->getItemName() + ")");
+            }
+            queued += record.m_queued;
+        }
+        bool consistent = queued == header.m_orderCount;
+        for (size_t i = 0; i < header.m_orderCount && consistent; i++)
+        {
+            const CheckpointOrder &record = reader.order(i);
+            consistent = validString(record.m_name) && validString(record.m_product) &&
+                         uint64_t(record.m_firstItem) + record.m_itemCount <= header.m_itemCount;
+            for (size_t k = 0; k < record.m_itemCount && consistent; k++)
+            {
+                consistent = validString(reader.item(record.m_firstItem + k).m_name);
+            }
+        }
+        if (!consistent)
+        {
+            throw FileException("Checkpoint " + path + " is inconsistent");
+        }
+
+        OrderQueue &pending = m_context->pending();
+        OrderQueue &completed = m_context->completed();
+        OrderQueue &incomplete = m_context->incomplete();
+        pending.clear();
+        completed.clear();
+        incomplete.clear();
+
+        std::vector<std::string> items;
+        auto load = [&reader, &items](size_t i)
+        {
+            const CheckpointOrder &record = reader.order(i);
+            items.resize(record.m_itemCount);
+            for (size_t k = 0; k < record.m_itemCount; k++)
+            {
+                items[k].assign(reader.string(reader.item(record.m_firstItem + k).m_name));
+            }
+            CustomerOrder order(std::string(reader.string(record.m_name)), std::string(reader.string(record.m_product)), items);
+            for (size_t k = 0; k < record.m_itemCount; k++)
+            {
+                const CheckpointItem &item = reader.item(record.m_firstItem + k);
+                if (item.m_filled)
+                {
+                    order.setItemFilled(k, item.m_serialNumber);
+                }
+            }
+            order.restoreStamps(record.m_entryTick, record.m_entryTimeNs, record.m_retireTick,
+                                record.m_retireTimeNs, record.m_retired);
+            return order;
+        };
+
+        size_t next = 0;
+        for (size_t i = 0; i < header.m_pending; i++)
+        {
+            pending.push_back(load(next++));
+        }
+        for (size_t s = 0; s < m_activeLine.size(); s++)
+        {
+            const CheckpointStation &record = reader.station(s);
+            Workstation *ws = m_activeLine[s];
+            ws->clearOrders();
+            ws->setQuantity(record.m_quantity);
+            ws->setSerialNumber(record.m_serialNumber);
+
+            StationStats stats;
+            stats.m_fills = record.m_fills;
+            stats.m_failedFills = record.m_failedFills;
+            stats.m_ordersPassed = record.m_ordersPassed;
+            stats.m_maxQueueDepth = record.m_maxQueueDepth;
+            stats.m_queueDepthSum = record.m_queueDepthSum;
+            stats.m_busyTicks = record.m_busyTicks;
+            stats.m_idleTicks = record.m_idleTicks;
+            ws->restoreMetrics(stats);
+
+            for (size_t i = 0; i < record.m_queued; i++)
+            {
+                *ws += load(next++);
+            }
+        }
+        for (size_t i = 0; i < header.m_completed; i++)
+        {
+            completed.push_back(load(next++));
+        }
+        for (size_t i = 0; i < header.m_incomplete; i++)
+        {
+            incomplete.push_back(load(next++));
+        }
+
+        m_iterationCount = header.m_iteration;
+        m_cntCustomerOrder = header.m_orderTotal;
+        m_retiredCompleted = completed.size();
+        m_retiredIncomplete = incomplete.size();
+        m_fillsSinceFrame = 0;
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+        LOG_INFO("Restored checkpoint " + path + " at iteration " + std::to_string(m_iterationCount) + ": " +
+                 std::to_string(header.m_orderCount) + " orders (" + std::to_string(elapsed.count()) + " us)");
+    }
+
     void LineManager::display(std::ostream &os) const
     {
         std::for_each(m_activeLine.begin(), m_activeLine.end(),
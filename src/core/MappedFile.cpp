@@ -0,0 +1,128 @@
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "seneca/MappedFile.h"
+#include "seneca/Exceptions.h"
+
+namespace seneca
+{
+    MappedFile::MappedFile(const std::string& path)
+    {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            throw FileException("Cannot open " + path + ": " + std::strerror(errno));
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0)
+        {
+            int error = errno;
+            ::close(fd);
+            throw FileException("Cannot stat " + path + ": " + std::strerror(error));
+        }
+        m_size = size_t(info.st_size);
+        if (m_size == 0)
+        {
+            ::close(fd);
+            return;     // mmap rejects empty mappings; an empty file maps to nothing
+        }
+        void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        int error = errno;
+        ::close(fd);
+        if (mapping == MAP_FAILED)
+        {
+            throw FileException("Cannot map " + path + ": " + std::strerror(error));
+        }
+        m_data = static_cast<const char*>(mapping);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        if (m_data)
+        {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+    {
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_data)
+            {
+                ::munmap(const_cast<char*>(m_data), m_size);
+            }
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    void writeFileAtomically(const std::string& path, const std::vector<FileSection>& sections)
+    {
+        std::string temp = path + ".tmp";
+        int fd = ::open(temp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+        {
+            throw FileException("Cannot write " + temp + ": " + std::strerror(errno));
+        }
+        auto writeAll = [fd](const char* data, size_t bytes)
+        {
+            while (bytes > 0)
+            {
+                ssize_t written = ::write(fd, data, bytes);
+                if (written < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (written <= 0)
+                {
+                    return false;
+                }
+                data += written;
+                bytes -= size_t(written);
+            }
+            return true;
+        };
+
+        bool ok = true;
+        for (const auto& section : sections)
+        {
+            ok = ok && writeAll(section.first, section.second);
+        }
+        ok = ok && ::fsync(fd) == 0;
+        int error = errno;
+        ::close(fd);
+        if (!ok || ::rename(temp.c_str(), path.c_str()) != 0)
+        {
+            error = ok ? errno : error;
+            ::unlink(temp.c_str());
+            throw FileException("Cannot write " + path + ": " + std::strerror(error));
+        }
+    }
+
+    uint64_t checksum64(const char* data, size_t size, uint64_t seed)
+    {
+        uint64_t hash = seed;
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            hash = (hash ^ word) * 1099511628211ULL;
+        }
+        for (; i < size; i++)
+        {
+            hash = (hash ^ uint8_t(data[i])) * 1099511628211ULL;
+        }
+        return hash;
+    }
+} // namespace seneca
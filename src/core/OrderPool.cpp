@@ -0,0 +1,53 @@
+#include "seneca/OrderPool.h"
+#include "seneca/Exceptions.h"
+
+namespace seneca
+{
+    OrderHandle OrderPool::acquire(CustomerOrder&& order)
+    {
+        OrderHandle handle;
+        if (!m_free.empty())
+        {
+            handle = m_free.back();
+            m_free.pop_back();
+        }
+        else
+        {
+            if (m_next == UINT32_MAX)
+            {
+                throw OrderException("Order pool exhausted");
+            }
+            handle = m_next++;
+            if ((handle >> CHUNK_BITS) >= m_chunks.size())
+            {
+                m_chunks.emplace_back(new CustomerOrder[CHUNK_SIZE]);
+            }
+        }
+
+        get(handle) = std::move(order);
+        return handle;
+    }
+
+    void OrderPool::release(OrderHandle handle)
+    {
+        // Drop the order's items now rather than when the slot is reused
+        get(handle) = CustomerOrder();
+        m_free.push_back(handle);
+    }
+
+    void OrderPool::clear()
+    {
+        m_chunks.clear();
+        m_free.clear();
+        m_next = 0;
+    }
+
+    void OrderQueue::clear()
+    {
+        for (OrderHandle handle : m_handles)
+        {
+            m_pool->release(handle);
+        }
+        m_handles.clear();
+    }
+} // namespace seneca
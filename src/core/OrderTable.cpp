@@ -0,0 +1,229 @@
+#include <algorithm>
+#include "seneca/OrderTable.h"
+
+namespace seneca
+{
+    namespace
+    {
+        inline unsigned popcount64(uint64_t word)
+        {
+#if defined(__GNUC__)
+            return unsigned(__builtin_popcountll(word));
+#else
+            unsigned bits = 0;
+            for (; word; word &= word - 1)
+            {
+                bits++;
+            }
+            return bits;
+#endif
+        }
+
+        // Bits set in [first, last) of a packed bitmap
+        size_t countBits(const std::vector<uint64_t>& bits, uint64_t first, uint64_t last)
+        {
+            if (first >= last)
+            {
+                return 0;
+            }
+            uint64_t firstWord = first >> 6;
+            uint64_t lastWord = (last - 1) >> 6;
+            uint64_t headMask = ~uint64_t(0) << (first & 63);
+            uint64_t tailMask = ~uint64_t(0) >> (63 - ((last - 1) & 63));
+
+            if (firstWord == lastWord)
+            {
+                return popcount64(bits[firstWord] & headMask & tailMask);
+            }
+            size_t count = popcount64(bits[firstWord] & headMask);
+            for (uint64_t w = firstWord + 1; w < lastWord; w++)
+            {
+                count += popcount64(bits[w]);
+            }
+            return count + popcount64(bits[lastWord] & tailMask);
+        }
+
+        void appendCsvField(std::string& row, std::string_view field)
+        {
+            if (field.find_first_of(",\"\n") == std::string::npos)
+            {
+                row += field;
+                return;
+            }
+            row += '"';
+            for (char ch : field)
+            {
+                if (ch == '"')
+                {
+                    row += '"';
+                }
+                row += ch;
+            }
+            row += '"';
+        }
+
+        const char* outcomeName(OrderOutcome outcome)
+        {
+            switch (outcome)
+            {
+                case OrderOutcome::COMPLETED: return "completed";
+                case OrderOutcome::INCOMPLETE: return "incomplete";
+                default: return "pending";
+            }
+        }
+    }
+
+    uint32_t StringTable::intern(std::string_view str)
+    {
+        auto it = m_ids.find(str);
+        if (it != m_ids.end())
+        {
+            return it->second;
+        }
+        uint32_t id = uint32_t(m_strings.size());
+        m_strings.emplace_back(str);
+        m_ids.emplace(m_strings.back(), id);
+        return id;
+    }
+
+    void StringTable::clear()
+    {
+        m_ids.clear();
+        m_strings.clear();
+    }
+
+    void OrderTable::reserve(size_t orders, size_t items)
+    {
+        m_customerOffset.reserve(orders + 1);
+        m_product.reserve(orders);
+        m_outcome.reserve(orders);
+        m_entryTick.reserve(orders);
+        m_retireTick.reserve(orders);
+        m_itemOffset.reserve(orders + 1);
+        m_itemName.reserve(items);
+        m_serial.reserve(items);
+        m_fillBits.reserve((items + 63) / 64);
+    }
+
+    void OrderTable::append(const CustomerOrder& order, OrderOutcome outcome)
+    {
+        m_customerChars += order.getCustomerName();
+        m_customerOffset.push_back(m_customerChars.size());
+        m_product.push_back(m_names.intern(order.getProduct()));
+        m_outcome.push_back(outcome);
+        m_entryTick.push_back(order.getEntryTick());
+        m_retireTick.push_back(order.hasRetired() ? order.getRetireTick() : 0);
+
+        for (size_t i = 0; i < order.getItemCount(); i++)
+        {
+            const Item& item = order.getItem(i);
+            uint64_t bit = m_itemName.size();
+            if ((bit >> 6) >= m_fillBits.size())
+            {
+                m_fillBits.push_back(0);
+            }
+            if (item.m_isFilled)
+            {
+                m_fillBits[bit >> 6] |= uint64_t(1) << (bit & 63);
+            }
+            m_itemName.push_back(m_names.intern(item.m_itemName));
+            m_serial.push_back(item.m_serialNumber);
+        }
+        m_itemOffset.push_back(m_itemName.size());
+    }
+
+    void OrderTable::appendAll(const OrderQueue& orders, OrderOutcome outcome)
+    {
+        for (const auto& order : orders)
+        {
+            append(order, outcome);
+        }
+    }
+
+    void OrderTable::clear()
+    {
+        m_names.clear();
+        m_customerChars.clear();
+        m_customerOffset.assign(1, 0);
+        m_product.clear();
+        m_outcome.clear();
+        m_entryTick.clear();
+        m_retireTick.clear();
+        m_itemOffset.assign(1, 0);
+        m_itemName.clear();
+        m_serial.clear();
+        m_fillBits.clear();
+    }
+
+    size_t OrderTable::filledItemCount(size_t order) const
+    {
+        return countBits(m_fillBits, m_itemOffset[order], m_itemOffset[order + 1]);
+    }
+
+    size_t OrderTable::count(OrderOutcome outcome) const
+    {
+        // Byte compare over one column: the compiler vectorizes this loop
+        return size_t(std::count(m_outcome.begin(), m_outcome.end(), outcome));
+    }
+
+    size_t OrderTable::filledItemCount() const
+    {
+        size_t count = 0;
+        for (uint64_t word : m_fillBits)
+        {
+            count += popcount64(word);
+        }
+        return count;
+    }
+
+    std::vector<ProductSummary> OrderTable::summarizeByProduct() const
+    {
+        // Product ids are dense in the string table, so the aggregation is a
+        // direct-indexed array instead of a hash map
+        std::vector<ProductSummary> byId(m_names.size());
+        for (size_t i = 0; i < m_product.size(); i++)
+        {
+            ProductSummary& s = byId[m_product[i]];
+            s.m_orders++;
+            s.m_completed += m_outcome[i] == OrderOutcome::COMPLETED;
+            s.m_items += m_itemOffset[i + 1] - m_itemOffset[i];
+            s.m_filledItems += countBits(m_fillBits, m_itemOffset[i], m_itemOffset[i + 1]);
+        }
+
+        std::vector<ProductSummary> summaries;
+        for (uint32_t id = 0; id < byId.size(); id++)
+        {
+            if (byId[id].m_orders)
+            {
+                byId[id].m_product = id;
+                summaries.push_back(byId[id]);
+            }
+        }
+        return summaries;
+    }
+
+    void OrderTable::exportCsv(std::ostream& os) const
+    {
+        os << "customer,product,outcome,filled_items,total_items,entry_tick,retire_tick\n";
+        std::string row;
+        for (size_t i = 0; i < size(); i++)
+        {
+            row.clear();
+            appendCsvField(row, customerName(i));
+            row += ',';
+            appendCsvField(row, productName(i));
+            row += ',';
+            row += outcomeName(m_outcome[i]);
+            row += ',';
+            row += std::to_string(filledItemCount(i));
+            row += ',';
+            row += std::to_string(orderItemCount(i));
+            row += ',';
+            row += std::to_string(m_entryTick[i]);
+            row += ',';
+            row += std::to_string(m_retireTick[i]);
+            row += '\n';
+            os << row;
+        }
+    }
+} // namespace seneca
@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "seneca/ParameterSweep.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/RunArena.h"
+#include "seneca/StationRegistry.h"
+#include "seneca/LineManager.h"
+#include "seneca/ThreadPool.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+namespace seneca
+{
+    namespace
+    {
+        // Counter-based draw: the same (seed, variant, axis) always gives
+        // the same value, independent of which thread asks
+        uint64_t mix(uint64_t seed, uint64_t variant, uint64_t axis)
+        {
+            uint64_t z = seed + 0x9E3779B97F4A7C15ull * (variant + 1) + 0xBF58476D1CE4E5B9ull * (axis + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        std::string trim(const std::string& str)
+        {
+            size_t first = str.find_first_not_of(" \t\r");
+            if (first == std::string::npos)
+            {
+                return "";
+            }
+            size_t last = str.find_last_not_of(" \t\r");
+            return str.substr(first, last - first + 1);
+        }
+
+        std::vector<std::string> splitFields(const std::string& line)
+        {
+            std::vector<std::string> fields;
+            std::string field;
+            std::istringstream in(line);
+            while (std::getline(in, field, '|'))
+            {
+                fields.push_back(trim(field));
+            }
+            return fields;
+        }
+
+        std::string csvField(const std::string& field)
+        {
+            if (field.find_first_of(",\"\n") == std::string::npos)
+            {
+                return field;
+            }
+            std::string quoted = "\"";
+            for (char ch : field)
+            {
+                quoted += ch;
+                if (ch == '"')
+                {
+                    quoted += '"';
+                }
+            }
+            return quoted + "\"";
+        }
+    }
+
+    ParameterSweep::ParameterSweep(const Scenario& scenario, const std::string& specFile)
+        : m_scenario(scenario)
+    {
+        std::ifstream spec(specFile);
+        if (!spec)
+        {
+            throw FileException("Unable to open sweep spec: " + specFile);
+        }
+        parse(spec);
+        LOG_INFO("Sweep spec " + specFile + ": " + std::to_string(m_axes.size()) + " stations, " +
+                 std::to_string(m_variants) + " variants");
+    }
+
+    ParameterSweep::ParameterSweep(const Scenario& scenario, std::istream& spec)
+        : m_scenario(scenario)
+    {
+        parse(spec);
+    }
+
+    void ParameterSweep::parse(std::istream& spec)
+    {
+        const auto& stations = m_scenario.getStations();
+        std::unordered_map<std::string, size_t> stationIndex;
+        for (size_t i = 0; i < stations.size(); i++)
+        {
+            stationIndex.emplace(stations[i].getItemName(), i);
+        }
+
+        std::vector<bool> swept(stations.size(), false);
+        bool haveWildcard = false;
+        SweepAxis wildcard;
+
+        std::string line;
+        size_t lineNo = 0;
+        while (std::getline(spec, line))
+        {
+            lineNo++;
+            std::string content = trim(line.substr(0, line.find('#')));
+            if (content.empty())
+            {
+                continue;
+            }
+
+            std::vector<std::string> fields = splitFields(content);
+            auto fail = [lineNo](const std::string& message)
+            {
+                return ValidationException("Sweep spec line " + std::to_string(lineNo) + ": " + message);
+            };
+            auto number = [&fail](const std::string& field) -> size_t
+            {
+                if (field.empty() || field.find_first_not_of("0123456789") != std::string::npos)
+                {
+                    throw fail("expected a non-negative integer, got '" + field + "'");
+                }
+                try
+                {
+                    return std::stoull(field);
+                }
+                catch (const std::out_of_range&)
+                {
+                    throw fail("'" + field + "' is out of range");
+                }
+            };
+
+            if (fields[0] == "@engine")
+            {
+                if (fields.size() != 2 || (fields[1] != "fast" && fields[1] != "simulate" && fields[1] != "timed"))
+                {
+                    throw fail("@engine is 'fast', 'simulate' or 'timed'");
+                }
+                m_engine = fields[1] == "fast" ? Engine::FAST : fields[1] == "timed" ? Engine::TIMED : Engine::SIMULATE;
+                continue;
+            }
+            if (fields[0] == "@interarrival")
+            {
+                if (fields.size() != 2 || !ServiceTime::parse(fields[1], m_interarrival))
+                {
+                    throw fail("@interarrival takes one service time, e.g. 2 or exp:2");
+                }
+                continue;
+            }
+            if (fields[0] == "@seed" || fields[0] == "@samples")
+            {
+                if (fields.size() != 2)
+                {
+                    throw fail(fields[0] + " takes one value");
+                }
+                if (fields[0] == "@seed")
+                {
+                    m_seed = number(fields[1]);
+                }
+                else if ((m_samples = number(fields[1])) == 0)
+                {
+                    throw fail("@samples must be at least 1");
+                }
+                continue;
+            }
+
+            SweepAxis axis;
+            if (fields.size() >= 2 && fields[1] == "range" && (fields.size() == 4 || fields.size() == 5))
+            {
+                axis.m_kind = SweepAxis::Kind::RANGE;
+                axis.m_step = fields.size() == 5 ? number(fields[4]) : 1;
+                if (axis.m_step == 0)
+                {
+                    throw fail("range step must be at least 1");
+                }
+            }
+            else if (fields.size() == 4 && fields[1] == "random")
+            {
+                axis.m_kind = SweepAxis::Kind::RANDOM;
+            }
+            else
+            {
+                throw fail("expected '<station> | range | min | max [| step]' or '<station> | random | min | max'");
+            }
+            axis.m_min = number(fields[2]);
+            axis.m_max = number(fields[3]);
+            if (axis.m_min > axis.m_max)
+            {
+                throw fail("min is greater than max");
+            }
+            // Also keeps valueCount() from wrapping on a range over every size_t
+            if (axis.m_kind == SweepAxis::Kind::RANGE && (axis.m_max - axis.m_min) / axis.m_step >= MAX_VARIANTS)
+            {
+                throw fail("range has more than " + std::to_string(MAX_VARIANTS) + " values");
+            }
+
+            if (fields[0] == "*")
+            {
+                haveWildcard = true;
+                wildcard = axis;
+                continue;
+            }
+
+            auto it = stationIndex.find(fields[0]);
+            if (it == stationIndex.end())
+            {
+                throw fail("unknown station '" + fields[0] + "'");
+            }
+            if (swept[it->second])
+            {
+                throw fail("station '" + fields[0] + "' is swept twice");
+            }
+            swept[it->second] = true;
+            axis.m_station = it->second;
+            m_axes.push_back(axis);
+        }
+
+        if (haveWildcard)
+        {
+            for (size_t i = 0; i < stations.size(); i++)
+            {
+                if (!swept[i])
+                {
+                    wildcard.m_station = i;
+                    m_axes.push_back(wildcard);
+                }
+            }
+        }
+
+        m_variants = m_samples;
+        for (const auto& axis : m_axes)
+        {
+            if (axis.valueCount() > MAX_VARIANTS / m_variants)
+            {
+                throw ValidationException("Sweep has more than " + std::to_string(MAX_VARIANTS) + " variants");
+            }
+            m_variants *= axis.valueCount();
+        }
+    }
+
+    std::vector<size_t> ParameterSweep::quantities(size_t variant) const
+    {
+        // Range axes are the digits of variant / samples in mixed radix,
+        // first axis fastest
+        size_t combination = variant / m_samples;
+        std::vector<size_t> values(m_axes.size());
+        for (size_t a = 0; a < m_axes.size(); a++)
+        {
+            const SweepAxis& axis = m_axes[a];
+            if (axis.m_kind == SweepAxis::Kind::RANGE)
+            {
+                size_t count = axis.valueCount();
+                values[a] = axis.m_min + (combination % count) * axis.m_step;
+                combination /= count;
+            }
+            else
+            {
+                // A span over every size_t has no count that fits one
+                size_t span = axis.m_max - axis.m_min;
+                uint64_t draw = mix(m_seed, variant, a);
+                values[a] = axis.m_min + size_t(span == SIZE_MAX ? draw : draw % (span + 1));
+            }
+        }
+        return values;
+    }
+
+    SweepResult ParameterSweep::runVariant(size_t variant) const
+    {
+        // Reused across the variants a thread runs
+        thread_local SimulationContext context;
+        thread_local RunArena arena;
+
+        auto start = std::chrono::steady_clock::now();
+        SimulationContext::Scope contextScope(context);
+        RunArena::Scope arenaScope(arena);
+
+        SweepResult result;
+        result.m_variant = variant;
+        result.m_quantities = quantities(variant);
+        {
+            StationRegistry registry = m_scenario.createStations();
+            for (size_t a = 0; a < m_axes.size(); a++)
+            {
+                registry[registry.slotOf(m_axes[a].m_station)].setQuantity(result.m_quantities[a]);
+            }
+            for (const auto& station : registry)
+            {
+                result.m_totalInventory += station.getQuantity();
+            }
+
+            m_scenario.enqueueOrders();
+            LineManager lm(m_scenario.getLinks(), registry.stations());
+            if (m_engine == Engine::FAST)
+            {
+                lm.fastForward();
+            }
+            else if (m_engine == Engine::TIMED)
+            {
+                TimedOptions options;
+                options.m_interarrival = m_interarrival;
+                options.m_seed = m_seed;
+                TimedStats stats = lm.runTimed(options);
+                result.m_makespan = stats.m_makespan;
+                result.m_throughput = stats.m_throughput;
+            }
+            else
+            {
+                std::ostream discard(nullptr);
+                while (!lm.run(discard));
+            }
+
+            result.m_iterations = lm.getIterationCount();
+            result.m_completed = context.completed().size();
+            result.m_incomplete = context.incomplete().size();
+        }
+        context.clearOrders();
+        arena.reset();
+
+        result.m_elapsedMs = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    std::vector<SweepResult> ParameterSweep::run(size_t threads) const
+    {
+        std::vector<SweepResult> results(m_variants);
+        ThreadPool pool(threads);
+        for (size_t variant = 0; variant < m_variants; variant++)
+        {
+            pool.submit([this, &results, variant](size_t)
+            {
+                results[variant] = runVariant(variant);
+            });
+        }
+        pool.wait();
+        return results;
+    }
+
+    void ParameterSweep::writeCsv(std::ostream& os, const std::vector<SweepResult>& results) const
+    {
+        const auto& stations = m_scenario.getStations();
+        const bool timed = m_engine == Engine::TIMED;
+        os << "variant,completed,incomplete,iterations,total_inventory,elapsed_ms";
+        if (timed)
+        {
+            os << ",makespan,throughput";
+        }
+        for (const auto& axis : m_axes)
+        {
+            os << ',' << csvField(stations[axis.m_station].getItemName());
+        }
+        os << '\n';
+
+        std::string row;
+        for (const auto& result : results)
+        {
+            row = std::to_string(result.m_variant) + ',' + std::to_string(result.m_completed) + ',' +
+                  std::to_string(result.m_incomplete) + ',' + std::to_string(result.m_iterations) + ',' +
+                  std::to_string(result.m_totalInventory) + ',' + std::to_string(result.m_elapsedMs);
+            if (timed)
+            {
+                row += ',' + std::to_string(result.m_makespan) + ',' + std::to_string(result.m_throughput);
+            }
+            for (size_t quantity : result.m_quantities)
+            {
+                row += ',';
+                row += std::to_string(quantity);
+            }
+            row += '\n';
+            os << row;
+        }
+    }
+
+    const SweepResult* ParameterSweep::cheapestComplete(const std::vector<SweepResult>& results)
+    {
+        const SweepResult* best = nullptr;
+        for (const auto& result : results)
+        {
+            if (result.m_incomplete == 0 && (!best || result.m_totalInventory < best->m_totalInventory))
+            {
+                best = &result;
+            }
+        }
+        return best;
+    }
+} // namespace seneca
@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <initializer_list>
+#include "seneca/RecordParser.h"
+
+namespace seneca
+{
+    namespace
+    {
+        // std::stoul without the exceptions: leading space, a sign and
+        // trailing text are accepted the same way
+        bool toNumber(const std::string& token, size_t& value)
+        {
+            const char* begin = token.c_str();
+            char* end = nullptr;
+            errno = 0;
+            unsigned long number = std::strtoul(begin, &end, 10);
+            if (end == begin || errno == ERANGE)
+            {
+                return false;
+            }
+            value = number;
+            return true;
+        }
+    }
+
+    ParseStatus parseStation(const std::string& record, char delimiter, StationFields& fields)
+    {
+        Utilities ut(delimiter);
+        size_t next_pos = 0;
+        bool more = false;
+        std::string token;
+
+        ParseStatus status = ut.nextToken(record, next_pos, more, fields.m_name);
+        for (size_t* number : {&fields.m_serialNumber, &fields.m_quantity})
+        {
+            if (status != ParseStatus::OK || !more)
+            {
+                break;
+            }
+            status = ut.nextToken(record, next_pos, more, token);
+            if (status == ParseStatus::OK && !toNumber(token, *number))
+            {
+                status = ParseStatus::BAD_NUMBER;
+            }
+        }
+        if (status != ParseStatus::OK)
+        {
+            return status;
+        }
+
+        // Measured before the description, as the Station constructor does
+        fields.m_fieldWidth = ut.getFieldWidth();
+        fields.m_description.clear();
+        fields.m_service = ServiceTime{};
+        if (more && (status = ut.nextToken(record, next_pos, more, fields.m_description)) != ParseStatus::OK)
+        {
+            return status;
+        }
+        // A malformed field after the description is ignored, as by the
+        // Station constructor, unless it claims to be a service time
+        if (more && ut.nextToken(record, next_pos, more, token) == ParseStatus::OK &&
+            !parseServiceField(token, fields.m_service))
+        {
+            return ParseStatus::BAD_SERVICE;
+        }
+        return ParseStatus::OK;
+    }
+
+    ParseStatus parseOrder(const std::string& record, char delimiter, OrderSpec& spec)
+    {
+        Utilities ut(delimiter);
+        size_t next_pos = 0;
+        bool more = true;
+
+        ParseStatus status = ut.nextToken(record, next_pos, more, spec.m_name);
+        if (status == ParseStatus::OK)
+        {
+            status = ut.nextToken(record, next_pos, more, spec.m_product);
+        }
+        spec.m_items.clear();
+        while (status == ParseStatus::OK && more)
+        {
+            spec.m_items.emplace_back();
+            status = ut.nextToken(record, next_pos, more, spec.m_items.back());
+        }
+        return status;
+    }
+
+    ParseStatus parseLink(const std::string& record, char delimiter, StationLink& link)
+    {
+        Utilities ut(delimiter);
+        size_t next_pos = 0;
+        bool more = true;
+
+        ParseStatus status = ut.nextToken(record, next_pos, more, link.first);
+        link.second.clear();
+        if (status == ParseStatus::OK && more)
+        {
+            status = ut.nextToken(record, next_pos, more, link.second);
+        }
+        return status;
+    }
+
+    void ParseReport::reject(const std::string& file, size_t line, ParseStatus status, const std::string& record)
+    {
+        m_diagnostics.push_back({file, line, status, record});
+    }
+
+    void ParseReport::merge(ParseReport&& other, size_t lineOffset)
+    {
+        m_accepted += other.m_accepted;
+        m_diagnostics.reserve(m_diagnostics.size() + other.m_diagnostics.size());
+        for (auto& diagnostic : other.m_diagnostics)
+        {
+            diagnostic.m_line += lineOffset;
+            m_diagnostics.push_back(std::move(diagnostic));
+        }
+        other.m_diagnostics.clear();
+        other.m_accepted = 0;
+    }
+
+    void ParseReport::print(std::ostream& os, size_t limit) const
+    {
+        size_t shown = limit == 0 ? m_diagnostics.size() : std::min(limit, m_diagnostics.size());
+        for (size_t i = 0; i < shown; i++)
+        {
+            const ParseDiagnostic& d = m_diagnostics[i];
+            os << d.m_file << ':' << d.m_line << ": " << toString(d.m_status) << ": " << d.m_record << '\n';
+        }
+        if (shown < m_diagnostics.size())
+        {
+            os << "... " << m_diagnostics.size() - shown << " more\n";
+        }
+        os << m_accepted << " records accepted, " << m_diagnostics.size() << " skipped\n";
+    }
+} // namespace seneca
@@ -0,0 +1,99 @@
+#include <algorithm>
+#include <cstring>
+#include "seneca/RunArena.h"
+
+namespace seneca
+{
+    namespace
+    {
+        thread_local RunArena* t_current = nullptr;
+    }
+
+    void* RunArena::CountingResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        m_bytes += bytes;
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void RunArena::CountingResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+    {
+        m_upstream->deallocate(p, bytes, alignment);
+    }
+
+    bool RunArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    RunArena::RunArena(size_t initialSize) : m_highWater(initialSize)
+    {
+        rebuild();
+    }
+
+    void RunArena::rebuild()
+    {
+        // Grow the retained buffer to the high-water mark plus headroom for
+        // alignment padding and the monotonic resource's own bookkeeping
+        if (m_highWater > m_capacity)
+        {
+            m_capacity = m_highWater + m_highWater / 4;
+            m_buffer.reset(new std::byte[m_capacity]);
+        }
+        m_resource.emplace(m_buffer.get(), m_capacity);
+        m_counting.emplace(&*m_resource, m_bytes);
+        m_interned.emplace(&*m_counting);
+    }
+
+    void* RunArena::allocate(size_t bytes, size_t alignment)
+    {
+        return m_counting->allocate(bytes, alignment);
+    }
+
+    std::string_view RunArena::intern(std::string_view str)
+    {
+        auto it = m_interned->find(str);
+        if (it != m_interned->end())
+        {
+            return *it;
+        }
+
+        std::string_view stored = copy(str);
+        m_interned->insert(stored);
+        return stored;
+    }
+
+    std::string_view RunArena::copy(std::string_view str)
+    {
+        char* chars = static_cast<char*>(allocate(str.size() + 1, 1));
+        std::memcpy(chars, str.data(), str.size());
+        chars[str.size()] = '\0';
+        return std::string_view(chars, str.size());
+    }
+
+    void RunArena::reset()
+    {
+        // The intern set lives in the arena too: drop it before the memory
+        // goes away and rebuild it on the fresh arena
+        m_interned.reset();
+        m_counting.reset();
+        m_resource.reset();
+        m_highWater = std::max(m_highWater, m_bytes);
+        m_bytes = 0;
+        rebuild();
+    }
+
+    RunArena* RunArena::current()
+    {
+        return t_current;
+    }
+
+    RunArena::Scope::Scope(RunArena& arena) : m_previous(t_current)
+    {
+        t_current = &arena;
+    }
+
+    RunArena::Scope::~Scope()
+    {
+        t_current = m_previous;
+    }
+} // namespace seneca
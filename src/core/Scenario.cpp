@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include "seneca/Scenario.h"
+#include "seneca/RecordParser.h"
+#include "seneca/ScenarioFile.h"
+#include "seneca/ThreadPool.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+namespace seneca
+{
+    namespace
+    {
+        std::ifstream openFile(const std::string& filename)
+        {
+            std::ifstream file(filename);
+            if (!file)
+            {
+                throw FileException("Unable to open file: " + filename);
+            }
+            return file;
+        }
+
+        // Records are checked as they are parsed: a bad one is noted in the
+        // file's report and skipped, or, unless the load is lenient, ends
+        // the file there; the first noted error is thrown once every file
+        // has been parsed
+        bool keep(ParseStatus status, bool lenient, const std::string& filename, size_t line,
+                  const std::string& record, ParseReport& report, bool& stop)
+        {
+            if (status == ParseStatus::OK)
+            {
+                report.accept();
+                return true;
+            }
+            report.reject(filename, line, status, record);
+            stop = !lenient;
+            return false;
+        }
+
+        void loadStations(std::ifstream& file, const std::string& filename, char delimiter, bool lenient,
+                          std::vector<Station>& stations, ParseReport& report)
+        {
+            std::string record;
+            StationFields fields;
+            size_t line = 0;
+            bool stop = false;
+            while (!stop && std::getline(file, record))
+            {
+                line++;
+                if (!record.empty() &&
+                    keep(parseStation(record, delimiter, fields), lenient, filename, line, record, report, stop))
+                {
+                    stations.emplace_back(fields.m_name, fields.m_serialNumber, fields.m_quantity,
+                                          fields.m_description, fields.m_fieldWidth, fields.m_service);
+                }
+            }
+        }
+
+        // Orders files are split by size alone, never by the machine, so
+        // every load of a file parses the same chunks
+        constexpr size_t MIN_ORDER_CHUNK = 64 * 1024;
+        constexpr size_t MAX_ORDER_CHUNKS = 16;
+
+        struct OrderChunk
+        {
+            std::vector<OrderSpec> m_orders{};
+            ParseReport m_report{};
+            size_t m_lines{};
+        };
+
+        // Parses the lines in text[begin, end), which starts at the beginning
+        // of a line and ends just past a '\n' or at the end of the text; a
+        // last line without '\n' still counts. Line numbers are relative to
+        // the chunk.
+        void parseOrders(const std::string& text, size_t begin, size_t end, const std::string& filename,
+                         bool lenient, OrderChunk& chunk)
+        {
+            std::string record;
+            OrderSpec spec;
+            bool stop = false;
+            while (!stop && begin < end)
+            {
+                size_t eol = std::min(text.find('\n', begin), end);
+                record.assign(text, begin, eol - begin);
+                begin = eol + 1;
+                chunk.m_lines++;
+
+                if (!record.empty() &&
+                    keep(parseOrder(record, '|', spec), lenient, filename, chunk.m_lines, record, chunk.m_report, stop))
+                {
+                    chunk.m_orders.push_back(std::move(spec));
+                }
+            }
+        }
+
+        void loadLinks(std::ifstream& file, const std::string& filename, bool lenient,
+                       std::vector<StationLink>& links, ParseReport& report)
+        {
+            std::string record;
+            StationLink link;
+            size_t line = 0;
+            bool stop = false;
+            while (!stop && std::getline(file, record))
+            {
+                line++;
+                if (keep(parseLink(record, '|', link), lenient, filename, line, record, report, stop))
+                {
+                    links.push_back(std::move(link));
+                }
+            }
+        }
+    }
+
+    Scenario::Scenario(const std::string& stationFile1, const std::string& stationFile2,
+                       const std::string& orderFile, const std::string& lineFile)
+    {
+        ParseReport report;
+        load(stationFile1, stationFile2, orderFile, lineFile, false, report);
+        if (!report.clean())
+        {
+            const ParseDiagnostic& first = report.diagnostics().front();
+            throw ValidationException(first.m_file + " line " + std::to_string(first.m_line) + ": " +
+                                      toString(first.m_status) + ": " + first.m_record);
+        }
+    }
+
+    Scenario::Scenario(const std::string& stationFile1, const std::string& stationFile2,
+                       const std::string& orderFile, const std::string& lineFile, ParseReport& report)
+    {
+        load(stationFile1, stationFile2, orderFile, lineFile, true, report);
+        if (!report.clean())
+        {
+            LOG_WARN("Scenario load skipped " + std::to_string(report.rejected()) + " malformed records");
+        }
+    }
+
+    void Scenario::load(const std::string& stationFile1, const std::string& stationFile2,
+                        const std::string& orderFile, const std::string& lineFile, bool lenient, ParseReport& report)
+    {
+        // Opened in order so a missing file is reported exactly as before
+        std::ifstream stations1 = openFile(stationFile1);
+        std::ifstream stations2 = openFile(stationFile2);
+        std::ifstream orders = openFile(orderFile);
+        std::ifstream line = openFile(lineFile);
+
+        // Orders and links are parsed on the pool while this thread parses
+        // the stations, which must stay here: their ids and field widths
+        // come from the current SimulationContext. Every parser has its own
+        // delimiter and its own report, so nothing is shared between them;
+        // the reports are merged in file order afterwards. The order file is
+        // read and split here, so every task is submitted from outside the
+        // pool and orderChunks is sized before any of them runs.
+        std::string orderText;
+        {
+            std::ostringstream text;
+            text << orders.rdbuf();
+            orderText = text.str();
+        }
+        std::vector<OrderChunk> orderChunks(std::max<size_t>(1, std::min(MAX_ORDER_CHUNKS,
+                                                                         orderText.size() / MIN_ORDER_CHUNK)));
+        ParseReport stationReport;
+        ParseReport linkReport;
+        {
+            ThreadPool pool(std::min<size_t>(4, std::max(1u, std::thread::hardware_concurrency())));
+            size_t chunks = orderChunks.size();
+            size_t begin = 0;
+            for (size_t c = 0; c < chunks; c++)
+            {
+                size_t end = orderText.size();
+                if (c + 1 < chunks)
+                {
+                    end = std::min(orderText.find('\n', std::max(orderText.size() * (c + 1) / chunks, begin)),
+                                   orderText.size() - 1) + 1;
+                }
+                pool.submit([&, c, begin, end](size_t)
+                {
+                    parseOrders(orderText, begin, end, orderFile, lenient, orderChunks[c]);
+                });
+                begin = end;
+            }
+            pool.submit([&](size_t)
+            {
+                loadLinks(line, lineFile, lenient, m_links, linkReport);
+            });
+
+            // Same delimiter convention as the command line tool: ',' for the
+            // first station file, '|' for the second one and for orders/links
+            loadStations(stations1, stationFile1, ',', lenient, m_stations, stationReport);
+            if (lenient || stationReport.clean())
+            {
+                loadStations(stations2, stationFile2, '|', lenient, m_stations, stationReport);
+            }
+            pool.wait();
+        }
+
+        report.merge(std::move(stationReport), 0);
+        size_t total = 0;
+        size_t lines = 0;
+        for (auto& chunk : orderChunks)
+        {
+            total += chunk.m_orders.size();
+            report.merge(std::move(chunk.m_report), lines);
+            lines += chunk.m_lines;
+        }
+        report.merge(std::move(linkReport), 0);
+
+        m_orders.reserve(total);
+        for (auto& chunk : orderChunks)
+        {
+            std::move(chunk.m_orders.begin(), chunk.m_orders.end(), std::back_inserter(m_orders));
+        }
+
+        LOG_INFO("Scenario loaded: " + std::to_string(m_stations.size()) + " stations, " +
+                 std::to_string(m_orders.size()) + " orders, " +
+                 std::to_string(m_links.size()) + " links");
+    }
+
+    Scenario::Scenario(std::vector<Station>&& stations, std::vector<OrderSpec>&& orders,
+                       std::vector<StationLink>&& links)
+        : m_stations(std::move(stations)), m_orders(std::move(orders)), m_links(std::move(links))
+    {
+    }
+
+    Scenario::Scenario(std::vector<Station>&& stations, std::shared_ptr<const CompiledOrders> orders,
+                       std::vector<StationLink>&& links)
+        : m_stations(std::move(stations)), m_links(std::move(links)), m_compiled(std::move(orders))
+    {
+    }
+
+    const std::vector<OrderSpec>& Scenario::getOrders() const
+    {
+        return m_compiled ? m_compiled->specs() : m_orders;
+    }
+
+    size_t Scenario::getOrderCount() const
+    {
+        return m_compiled ? m_compiled->size() : m_orders.size();
+    }
+
+    StationRegistry Scenario::createStations() const
+    {
+        // Stations on the line first, in line order, then any the line
+        // never references
+        std::unordered_map<std::string, size_t> firstIndex;
+        for (size_t i = 0; i < m_stations.size(); i++)
+        {
+            firstIndex.emplace(m_stations[i].getItemName(), i);
+        }
+
+        std::vector<size_t> layout;
+        std::vector<bool> placed(m_stations.size(), false);
+        layout.reserve(m_stations.size());
+        for (const auto& link : m_links)
+        {
+            auto it = firstIndex.find(link.first);
+            if (it != firstIndex.end() && !placed[it->second])
+            {
+                placed[it->second] = true;
+                layout.push_back(it->second);
+            }
+        }
+        for (size_t i = 0; i < m_stations.size(); i++)
+        {
+            if (!placed[i])
+            {
+                layout.push_back(i);
+            }
+        }
+
+        return StationRegistry(m_stations, layout);
+    }
+
+    void Scenario::enqueueOrders() const
+    {
+        OrderQueue& pending = SimulationContext::current().pending();
+        if (m_compiled)
+        {
+            m_compiled->enqueue(pending);
+            return;
+        }
+        for (const auto& spec : m_orders)
+        {
+            pending.push_back(CustomerOrder(spec.m_name, spec.m_product, spec.m_items));
+        }
+    }
+} // namespace seneca
@@ -0,0 +1,272 @@
+#include <chrono>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "seneca/ScenarioFile.h"
+#include "seneca/MappedFile.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+namespace seneca
+{
+    namespace
+    {
+        // Interned string table under construction
+        class StringTable {
+            std::string m_text{};
+            std::unordered_map<std::string_view, ScenarioFileString> m_refs{};
+
+            public:
+                ScenarioFileString add(std::string_view text)
+                {
+                    auto it = m_refs.find(text);
+                    if (it != m_refs.end())
+                    {
+                        return it->second;
+                    }
+                    ScenarioFileString ref{uint32_t(m_text.size()), uint32_t(text.size())};
+                    m_text.append(text);
+                    m_refs.emplace(text, ref);
+                    return ref;
+                }
+
+                // Pad to a multiple of 8 bytes and hand the table over
+                std::string release()
+                {
+                    m_text.resize((m_text.size() + 7) & ~size_t(7), '\0');
+                    return std::move(m_text);
+                }
+        };
+
+        template <typename Record>
+        FileSection section(const std::vector<Record>& records)
+        {
+            return {reinterpret_cast<const char*>(records.data()), records.size() * sizeof(Record)};
+        }
+    }
+
+    void ScenarioFile::write(const Scenario& scenario, const std::string& path)
+    {
+        // Views into the scenario stay valid until the file is written
+        StringTable strings;
+
+        std::vector<ScenarioFileStation> stations;
+        stations.reserve(scenario.getStations().size());
+        for (const Station& station : scenario.getStations())
+        {
+            ScenarioFileStation record{};
+            record.m_name = strings.add(station.getItemName());
+            record.m_description = strings.add(station.getDescription());
+            record.m_serialNumber = station.getSerialNumber();
+            record.m_quantity = station.getQuantity();
+            record.m_fieldWidth = station.getFieldWidth();
+            record.m_serviceKind = uint32_t(station.getServiceTime().m_kind);
+            record.m_serviceA = station.getServiceTime().m_a;
+            record.m_serviceB = station.getServiceTime().m_b;
+            stations.push_back(record);
+        }
+
+        std::vector<ScenarioFileLink> links;
+        links.reserve(scenario.getLinks().size());
+        for (const StationLink& link : scenario.getLinks())
+        {
+            links.push_back({strings.add(link.first), strings.add(link.second)});
+        }
+
+        std::vector<ScenarioFileOrder> orders;
+        std::vector<ScenarioFileString> items;
+        orders.reserve(scenario.getOrderCount());
+        for (const OrderSpec& spec : scenario.getOrders())
+        {
+            ScenarioFileOrder record{};
+            record.m_name = strings.add(spec.m_name);
+            record.m_product = strings.add(spec.m_product);
+            record.m_firstItem = uint32_t(items.size());
+            record.m_itemCount = uint32_t(spec.m_items.size());
+            for (const std::string& item : spec.m_items)
+            {
+                items.push_back(strings.add(item));
+            }
+            orders.push_back(record);
+        }
+        std::string text = strings.release();
+
+        ScenarioFileHeader header{};
+        header.m_magic = SCENARIO_FILE_MAGIC;
+        header.m_version = SCENARIO_FILE_VERSION;
+        header.m_byteOrder = SCENARIO_FILE_BYTE_ORDER;
+        header.m_stationCount = uint32_t(stations.size());
+        header.m_linkCount = uint32_t(links.size());
+        header.m_orderCount = uint32_t(orders.size());
+        header.m_itemCount = uint32_t(items.size());
+        header.m_stringBytes = uint32_t(text.size());
+
+        std::vector<FileSection> sections = {
+            {reinterpret_cast<const char*>(&header), sizeof(header)},
+            section(stations), section(links), section(orders), section(items),
+            {text.data(), text.size()},
+        };
+        uint64_t checksum = CHECKSUM_SEED;
+        for (size_t i = 0; i < sections.size(); i++)
+        {
+            header.m_fileSize += sections[i].second;
+            checksum = i ? checksum64(sections[i].first, sections[i].second, checksum) : checksum;
+        }
+        header.m_checksum = checksum64(reinterpret_cast<const char*>(&header), sizeof(header), checksum);
+
+        writeFileAtomically(path, sections);
+    }
+
+    Scenario ScenarioFile::read(const std::string& path)
+    {
+        auto started = std::chrono::steady_clock::now();
+        MappedFile file(path);
+        const char* data = file.data();
+        if (file.size() < sizeof(ScenarioFileHeader))
+        {
+            throw FileException("Compiled scenario " + path + " is truncated");
+        }
+
+        const ScenarioFileHeader& header = *reinterpret_cast<const ScenarioFileHeader*>(data);
+        if (header.m_magic != SCENARIO_FILE_MAGIC)
+        {
+            throw FileException(path + " is not a compiled scenario");
+        }
+        if (header.m_byteOrder != SCENARIO_FILE_BYTE_ORDER)
+        {
+            throw FileException("Compiled scenario " + path + " was written with a different byte order");
+        }
+        if (header.m_version != SCENARIO_FILE_VERSION)
+        {
+            throw FileException("Compiled scenario " + path + " has version " + std::to_string(header.m_version) +
+                                ", expected " + std::to_string(SCENARIO_FILE_VERSION) + "; recompile it");
+        }
+        if (header.m_fileSize != file.size() ||
+            file.size() != sizeof(ScenarioFileHeader) + uint64_t(header.m_stationCount) * sizeof(ScenarioFileStation) +
+                           uint64_t(header.m_linkCount) * sizeof(ScenarioFileLink) +
+                           uint64_t(header.m_orderCount) * sizeof(ScenarioFileOrder) +
+                           uint64_t(header.m_itemCount) * sizeof(ScenarioFileString) + header.m_stringBytes)
+        {
+            throw FileException("Compiled scenario " + path + " is truncated");
+        }
+        ScenarioFileHeader unsignedHeader = header;
+        unsignedHeader.m_checksum = 0;
+        uint64_t checksum = checksum64(data + sizeof(header), file.size() - sizeof(header));
+        if (checksum64(reinterpret_cast<const char*>(&unsignedHeader), sizeof(unsignedHeader), checksum) != header.m_checksum)
+        {
+            throw FileException("Compiled scenario " + path + " is corrupt (checksum mismatch)");
+        }
+
+        const char* cursor = data + sizeof(header);
+        auto* stationRecords = reinterpret_cast<const ScenarioFileStation*>(cursor);
+        cursor += header.m_stationCount * sizeof(ScenarioFileStation);
+        auto* linkRecords = reinterpret_cast<const ScenarioFileLink*>(cursor);
+        cursor += header.m_linkCount * sizeof(ScenarioFileLink);
+        auto* orderRecords = reinterpret_cast<const ScenarioFileOrder*>(cursor);
+        cursor += header.m_orderCount * sizeof(ScenarioFileOrder);
+        auto* itemRecords = reinterpret_cast<const ScenarioFileString*>(cursor);
+        cursor += header.m_itemCount * sizeof(ScenarioFileString);
+        const char* text = cursor;
+
+        auto string = [&](ScenarioFileString ref)
+        {
+            if (uint64_t(ref.m_offset) + ref.m_length > header.m_stringBytes)
+            {
+                throw FileException("Compiled scenario " + path + " is inconsistent");
+            }
+            return std::string_view(text + ref.m_offset, ref.m_length);
+        };
+
+        std::vector<Station> stations;
+        stations.reserve(header.m_stationCount);
+        for (size_t i = 0; i < header.m_stationCount; i++)
+        {
+            const ScenarioFileStation& record = stationRecords[i];
+            ServiceTime service;
+            service.m_kind = ServiceTime::Kind(record.m_serviceKind);
+            service.m_a = record.m_serviceA;
+            service.m_b = record.m_serviceB;
+            if (record.m_serviceKind > uint32_t(ServiceTime::Kind::NORMAL) ||
+                !ServiceTime::parse(service.toString(), service))
+            {
+                throw FileException("Compiled scenario " + path + " has a bad service time");
+            }
+            stations.emplace_back(std::string(string(record.m_name)), record.m_serialNumber, record.m_quantity,
+                                  std::string(string(record.m_description)), record.m_fieldWidth, service);
+        }
+
+        std::vector<StationLink> links;
+        links.reserve(header.m_linkCount);
+        for (size_t i = 0; i < header.m_linkCount; i++)
+        {
+            links.emplace_back(string(linkRecords[i].m_from), string(linkRecords[i].m_to));
+        }
+
+        // Orders stay in the mapping; check every reference once here so
+        // building them later needs no checks
+        for (size_t i = 0; i < header.m_orderCount; i++)
+        {
+            const ScenarioFileOrder& record = orderRecords[i];
+            if (uint64_t(record.m_firstItem) + record.m_itemCount > header.m_itemCount)
+            {
+                throw FileException("Compiled scenario " + path + " is inconsistent");
+            }
+            string(record.m_name);
+            string(record.m_product);
+        }
+        for (size_t i = 0; i < header.m_itemCount; i++)
+        {
+            string(itemRecords[i]);
+        }
+        auto orders = std::make_shared<const CompiledOrders>(std::move(file), orderRecords, itemRecords, text,
+                                                             header.m_orderCount);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started);
+        LOG_INFO("Compiled scenario " + path + " loaded in " + std::to_string(elapsed.count()) + " us: " +
+                 std::to_string(stations.size()) + " stations, " + std::to_string(header.m_orderCount) + " orders, " +
+                 std::to_string(links.size()) + " links");
+        return Scenario(std::move(stations), std::move(orders), std::move(links));
+    }
+
+    CompiledOrders::CompiledOrders(MappedFile&& file, const ScenarioFileOrder* orders, const ScenarioFileString* items,
+                                   const char* strings, size_t count)
+        : m_file(std::move(file)), m_orders(orders), m_items(items), m_strings(strings), m_count(count)
+    {
+    }
+
+    void CompiledOrders::enqueue(OrderQueue& pending) const
+    {
+        std::vector<std::string_view> items;
+        for (size_t i = 0; i < m_count; i++)
+        {
+            const ScenarioFileOrder& record = m_orders[i];
+            items.clear();
+            for (size_t k = 0; k < record.m_itemCount; k++)
+            {
+                items.push_back(string(m_items[record.m_firstItem + k]));
+            }
+            pending.push_back(CustomerOrder(string(record.m_name), string(record.m_product), items));
+        }
+    }
+
+    const std::vector<OrderSpec>& CompiledOrders::specs() const
+    {
+        std::call_once(m_specsOnce, [this]()
+        {
+            m_specs.resize(m_count);
+            for (size_t i = 0; i < m_count; i++)
+            {
+                const ScenarioFileOrder& record = m_orders[i];
+                OrderSpec& spec = m_specs[i];
+                spec.m_name = string(record.m_name);
+                spec.m_product = string(record.m_product);
+                spec.m_items.reserve(record.m_itemCount);
+                for (size_t k = 0; k < record.m_itemCount; k++)
+                {
+                    spec.m_items.emplace_back(string(m_items[record.m_firstItem + k]));
+                }
+            }
+        });
+        return m_specs;
+    }
+} // namespace seneca
@@ -0,0 +1,383 @@
+#include <fstream>
+#include <cmath>
+#include <algorithm>
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+namespace seneca
+{
+    namespace
+    {
+        // Independent random streams, so each value depends only on
+        // (seed, stream, index) and not on how many values came before it
+        enum Stream : uint64_t
+        {
+            STREAM_PERMUTATION = 1,
+            STREAM_ITEM_COUNT,
+            STREAM_ITEM,
+            STREAM_ORDER,
+            STREAM_SERIAL,
+            STREAM_LINE,
+            STREAM_LINE_FILE
+        };
+
+        uint64_t splitmix64(uint64_t x)
+        {
+            x += 0x9e3779b97f4a7c15ULL;
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        uint64_t hash(uint64_t seed, uint64_t stream, uint64_t index)
+        {
+            return splitmix64(splitmix64(seed ^ (stream << 56)) ^ index);
+        }
+
+        // Uniform double in [0, 1) from the top 53 bits
+        double unit(uint64_t h)
+        {
+            return double(h >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        size_t below(uint64_t h, size_t n)
+        {
+            return std::min(n - 1, size_t(unit(h) * double(n)));
+        }
+
+        // Fisher-Yates driven by the hash stream
+        std::vector<uint32_t> permutation(size_t n, uint64_t seed, uint64_t stream)
+        {
+            std::vector<uint32_t> perm(n);
+            for (size_t i = 0; i < n; i++)
+            {
+                perm[i] = uint32_t(i);
+            }
+            for (size_t i = n; i > 1; i--)
+            {
+                std::swap(perm[i - 1], perm[below(hash(seed, stream, i), i)]);
+            }
+            return perm;
+        }
+
+        // Batches small writes into large ones; the order file can run to
+        // hundreds of megabytes
+        class BufferedWriter
+        {
+            std::ostream& m_os;
+            std::string m_buffer;
+
+        public:
+            explicit BufferedWriter(std::ostream& os) : m_os(os) { m_buffer.reserve(1 << 20); }
+            ~BufferedWriter() { flush(); }
+
+            BufferedWriter& operator<<(const std::string& str)
+            {
+                m_buffer += str;
+                if (m_buffer.size() >= (1 << 20))
+                {
+                    flush();
+                }
+                return *this;
+            }
+
+            void flush()
+            {
+                m_os.write(m_buffer.data(), std::streamsize(m_buffer.size()));
+                m_buffer.clear();
+            }
+        };
+
+        std::string numbered(const char* prefix, size_t n, int digits)
+        {
+            std::string number = std::to_string(n);
+            if (number.size() < size_t(digits))
+            {
+                number.insert(0, size_t(digits) - number.size(), '0');
+            }
+            return prefix + number;
+        }
+
+        int digitsFor(size_t n)
+        {
+            int digits = 1;
+            while (n >= 10)
+            {
+                n /= 10;
+                digits++;
+            }
+            return std::max(digits, 4);
+        }
+
+        void openForWrite(std::ofstream& file, const std::string& filename)
+        {
+            file.open(filename, std::ios::out | std::ios::trunc | std::ios::binary);
+            if (!file)
+            {
+                throw FileException("Unable to create file: " + filename);
+            }
+        }
+    }
+
+    ScenarioGenerator::ScenarioGenerator(const GeneratorOptions& options) : m_options(options)
+    {
+        if (m_options.m_stations == 0)
+        {
+            throw ValidationException("Scenario needs at least one station");
+        }
+        if (m_options.m_stations > UINT32_MAX)
+        {
+            throw ValidationException("Too many stations: " + std::to_string(m_options.m_stations));
+        }
+        if (m_options.m_products == 0)
+        {
+            throw ValidationException("Scenario needs at least one product");
+        }
+        if (m_options.m_minItems == 0 || m_options.m_minItems > m_options.m_maxItems)
+        {
+            throw ValidationException("Items per product must satisfy 1 <= min <= max");
+        }
+        if (m_options.m_scarcity < 0.0)
+        {
+            throw ValidationException("Scarcity must not be negative");
+        }
+        ServiceTime service;
+        if (!m_options.m_serviceTime.empty() && !ServiceTime::parse(m_options.m_serviceTime, service))
+        {
+            throw ValidationException("Bad service time: " + m_options.m_serviceTime);
+        }
+
+        buildCatalogue();
+    }
+
+    void ScenarioGenerator::buildCatalogue()
+    {
+        const GeneratorOptions& opt = m_options;
+        const uint64_t seed = opt.m_seed;
+        const int digits = digitsFor(opt.m_stations);
+
+        m_itemNames.reserve(opt.m_stations);
+        for (size_t i = 0; i < opt.m_stations; i++)
+        {
+            m_itemNames.push_back(numbered("Part-", i + 1, digits));
+        }
+
+        // Popularity rank -> item. Shuffled so hot items are spread along
+        // the line instead of sitting at its head.
+        std::vector<uint32_t> byRank = permutation(opt.m_stations, seed, STREAM_PERMUTATION);
+
+        std::vector<double> cdf;
+        if (opt.m_distribution == ItemDistribution::ZIPF)
+        {
+            cdf.resize(opt.m_stations);
+            double total = 0.0;
+            for (size_t r = 0; r < opt.m_stations; r++)
+            {
+                total += 1.0 / std::pow(double(r + 1), opt.m_zipfExponent);
+                cdf[r] = total;
+            }
+            for (auto& c : cdf)
+            {
+                c /= total;
+            }
+        }
+
+        m_productItems.resize(opt.m_products);
+        uint64_t draw = 0;
+        for (size_t p = 0; p < opt.m_products; p++)
+        {
+            size_t span = opt.m_maxItems - opt.m_minItems + 1;
+            size_t count = opt.m_minItems + below(hash(seed, STREAM_ITEM_COUNT, p), span);
+            auto& items = m_productItems[p];
+            items.reserve(count);
+            for (size_t k = 0; k < count; k++)
+            {
+                uint64_t h = hash(seed, STREAM_ITEM, draw++);
+                size_t rank = cdf.empty()
+                    ? below(h, opt.m_stations)
+                    : std::min(size_t(std::upper_bound(cdf.begin(), cdf.end(), unit(h)) - cdf.begin()),
+                               opt.m_stations - 1);
+                items.push_back(byRank[rank]);
+            }
+        }
+
+        // Inventory follows the exact demand of the order stream, scaled by
+        // the scarcity factor (1.0 = every order can complete)
+        std::vector<uint64_t> productCount(opt.m_products, 0);
+        for (uint64_t o = 0; o < opt.m_orders; o++)
+        {
+            productCount[pickProduct(o)]++;
+        }
+        std::vector<uint64_t> demand(opt.m_stations, 0);
+        for (size_t p = 0; p < opt.m_products; p++)
+        {
+            for (uint32_t item : m_productItems[p])
+            {
+                demand[item] += productCount[p];
+            }
+        }
+        m_inventory.resize(opt.m_stations);
+        for (size_t i = 0; i < opt.m_stations; i++)
+        {
+            m_inventory[i] = size_t(std::ceil(double(demand[i]) * opt.m_scarcity - 1e-9));
+        }
+
+        m_lineOrder = permutation(opt.m_stations, seed, STREAM_LINE);
+    }
+
+    size_t ScenarioGenerator::pickProduct(uint64_t order) const
+    {
+        return below(hash(m_options.m_seed, STREAM_ORDER, order), m_options.m_products);
+    }
+
+    void ScenarioGenerator::writeStations(std::ostream& os, char delimiter, size_t first, size_t last) const
+    {
+        BufferedWriter out(os);
+        const std::string sep = std::string(" ") + delimiter + " ";
+        const std::string service = m_options.m_serviceTime.empty() ? "" : sep + "service=" + m_options.m_serviceTime;
+        last = std::min(last, m_itemNames.size());
+        for (size_t i = first; i < last; i++)
+        {
+            size_t serial = 100000 + below(hash(m_options.m_seed, STREAM_SERIAL, i), 900000);
+            out << m_itemNames[i] + sep + std::to_string(serial) + sep + std::to_string(m_inventory[i])
+                   + sep + "Synthetic station " + std::to_string(i + 1) + service + "\n";
+        }
+    }
+
+    void ScenarioGenerator::writeOrders(std::ostream& os) const
+    {
+        BufferedWriter out(os);
+        const int customerDigits = digitsFor(m_options.m_orders);
+        const int productDigits = digitsFor(m_options.m_products);
+        std::string line;
+        for (uint64_t o = 0; o < m_options.m_orders; o++)
+        {
+            size_t p = pickProduct(o);
+            line = numbered("Customer ", size_t(o + 1), customerDigits);
+            line += " | ";
+            line += numbered("Product ", p + 1, productDigits);
+            line += " | ";
+            const auto& items = m_productItems[p];
+            for (size_t k = 0; k < items.size(); k++)
+            {
+                if (k)
+                {
+                    line += '|';
+                }
+                line += m_itemNames[items[k]];
+            }
+            line += '\n';
+            out << line;
+        }
+    }
+
+    std::vector<uint32_t> ScenarioGenerator::lineFileOrder() const
+    {
+        // Record k describes the k-th station of the line; the file lists
+        // the records in a shuffled order unless asked not to
+        if (m_options.m_shuffleLines)
+        {
+            return permutation(m_lineOrder.size(), m_options.m_seed, STREAM_LINE_FILE);
+        }
+        std::vector<uint32_t> order(m_lineOrder.size());
+        for (size_t k = 0; k < order.size(); k++)
+        {
+            order[k] = uint32_t(k);
+        }
+        return order;
+    }
+
+    StationLink ScenarioGenerator::lineRecord(size_t k) const
+    {
+        return StationLink(m_itemNames[m_lineOrder[k]],
+                           k + 1 < m_lineOrder.size() ? m_itemNames[m_lineOrder[k + 1]] : "");
+    }
+
+    void ScenarioGenerator::writeLine(std::ostream& os) const
+    {
+        BufferedWriter out(os);
+        for (uint32_t k : lineFileOrder())
+        {
+            StationLink link = lineRecord(k);
+            out << (link.second.empty() ? link.first : link.first + "|" + link.second) + "\n";
+        }
+    }
+
+    void ScenarioGenerator::writeFiles(const std::string& directory) const
+    {
+        const std::string base = directory.empty() || directory.back() == '/' ? directory : directory + "/";
+        const size_t half = (m_itemNames.size() + 1) / 2;
+
+        std::ofstream file;
+        openForWrite(file, base + "Stations1.txt");
+        writeStations(file, ',', 0, half);
+        file.close();
+
+        openForWrite(file, base + "Stations2.txt");
+        writeStations(file, '|', half, m_itemNames.size());
+        file.close();
+
+        openForWrite(file, base + "AssemblyLine.txt");
+        writeLine(file);
+        file.close();
+
+        openForWrite(file, base + "CustomerOrders.txt");
+        writeOrders(file);
+        file.close();
+        if (!file)
+        {
+            throw FileException("Error writing scenario files to: " + directory);
+        }
+
+        LOG_INFO("Generated scenario in " + directory + ": " + std::to_string(m_options.m_stations) +
+                 " stations, " + std::to_string(m_options.m_orders) + " orders");
+    }
+
+    Scenario ScenarioGenerator::build() const
+    {
+        std::vector<Station> stations;
+        stations.reserve(m_itemNames.size());
+        const std::string service = m_options.m_serviceTime.empty() ? "" : ",service=" + m_options.m_serviceTime;
+        for (size_t i = 0; i < m_itemNames.size(); i++)
+        {
+            size_t serial = 100000 + below(hash(m_options.m_seed, STREAM_SERIAL, i), 900000);
+            stations.emplace_back(m_itemNames[i] + "," + std::to_string(serial) + "," +
+                                  std::to_string(m_inventory[i]) + ",Synthetic station " + std::to_string(i + 1) +
+                                  service, ',');
+        }
+
+        std::vector<OrderSpec> orders;
+        orders.reserve(m_options.m_orders);
+        const int customerDigits = digitsFor(m_options.m_orders);
+        const int productDigits = digitsFor(m_options.m_products);
+        for (uint64_t o = 0; o < m_options.m_orders; o++)
+        {
+            size_t p = pickProduct(o);
+            OrderSpec spec;
+            spec.m_name = numbered("Customer ", size_t(o + 1), customerDigits);
+            spec.m_product = numbered("Product ", p + 1, productDigits);
+            for (uint32_t item : m_productItems[p])
+            {
+                spec.m_items.push_back(m_itemNames[item]);
+            }
+            orders.push_back(std::move(spec));
+        }
+
+        std::vector<StationLink> links;
+        links.reserve(m_lineOrder.size());
+        for (uint32_t k : lineFileOrder())
+        {
+            links.push_back(lineRecord(k));
+        }
+
+        return Scenario(std::move(stations), std::move(orders), std::move(links));
+    }
+
+    ItemDistribution ScenarioGenerator::parseDistribution(const std::string& name)
+    {
+        if (name == "uniform") return ItemDistribution::UNIFORM;
+        if (name == "zipf") return ItemDistribution::ZIPF;
+        throw ValidationException("Unknown item distribution: " + name + " (expected uniform or zipf)");
+    }
+} // namespace seneca
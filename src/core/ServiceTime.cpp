@@ -0,0 +1,146 @@
+#include <charconv>
+#include <cmath>
+#include <vector>
+#include "seneca/ServiceTime.h"
+
+namespace seneca
+{
+    namespace
+    {
+        constexpr double PI = 3.14159265358979323846;
+
+        uint64_t splitmix64(uint64_t& state)
+        {
+            uint64_t x = (state += 0x9e3779b97f4a7c15ULL);
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        // Uniform double in [0, 1) from the top 53 bits
+        double unit(uint64_t& state)
+        {
+            return double(splitmix64(state) >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+        bool toDouble(const std::string& token, double& value)
+        {
+            const char* end = token.data() + token.size();
+            auto result = std::from_chars(token.data(), end, value);
+            return result.ec == std::errc() && result.ptr == end && std::isfinite(value) && value >= 0;
+        }
+
+        std::string format(double value)
+        {
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            return std::string(buffer, result.ptr);
+        }
+    }
+
+    bool ServiceTime::parse(const std::string& spec, ServiceTime& time)
+    {
+        std::vector<std::string> parts;
+        size_t begin = 0;
+        for (size_t colon; (colon = spec.find(':', begin)) != std::string::npos; begin = colon + 1)
+        {
+            parts.push_back(spec.substr(begin, colon - begin));
+        }
+        parts.push_back(spec.substr(begin));
+
+        ServiceTime parsed;
+        size_t parameters = 1;
+        if (parts.size() == 1)
+        {
+            return toDouble(parts[0], parsed.m_a) && (time = parsed, true);
+        }
+        if (parts[0] == "const")
+        {
+            parsed.m_kind = Kind::CONSTANT;
+        }
+        else if (parts[0] == "exp")
+        {
+            parsed.m_kind = Kind::EXPONENTIAL;
+        }
+        else if (parts[0] == "uniform" || parts[0] == "normal")
+        {
+            parsed.m_kind = parts[0] == "uniform" ? Kind::UNIFORM : Kind::NORMAL;
+            parameters = 2;
+        }
+        else
+        {
+            return false;
+        }
+
+        if (parts.size() != parameters + 1 || !toDouble(parts[1], parsed.m_a) ||
+            (parameters == 2 && !toDouble(parts[2], parsed.m_b)) ||
+            (parsed.m_kind == Kind::UNIFORM && parsed.m_b < parsed.m_a))
+        {
+            return false;
+        }
+        time = parsed;
+        return true;
+    }
+
+    bool parseServiceField(const std::string& field, ServiceTime& time)
+    {
+        static const std::string prefix = "service=";
+        return field.compare(0, prefix.size(), prefix) != 0 || ServiceTime::parse(field.substr(prefix.size()), time);
+    }
+
+    std::string ServiceTime::toString() const
+    {
+        switch (m_kind)
+        {
+            case Kind::CONSTANT: return format(m_a);
+            case Kind::UNIFORM: return "uniform:" + format(m_a) + ":" + format(m_b);
+            case Kind::EXPONENTIAL: return "exp:" + format(m_a);
+            case Kind::NORMAL: return "normal:" + format(m_a) + ":" + format(m_b);
+        }
+        return format(m_a);
+    }
+
+    double ServiceTime::mean() const
+    {
+        switch (m_kind)
+        {
+            case Kind::UNIFORM:
+                return (m_a + m_b) / 2;
+            case Kind::NORMAL:
+            {
+                if (m_b == 0)
+                {
+                    return m_a;
+                }
+                // E[max(0, X)] for X ~ N(a, b^2)
+                double z = m_a / m_b;
+                return m_a * 0.5 * std::erfc(-z / std::sqrt(2.0)) + m_b * std::exp(-z * z / 2) / std::sqrt(2 * PI);
+            }
+            default:
+                return m_a;
+        }
+    }
+
+    double ServiceTime::sample(uint64_t& state) const
+    {
+        switch (m_kind)
+        {
+            case Kind::CONSTANT:
+                return m_a;
+            case Kind::UNIFORM:
+                return m_a + (m_b - m_a) * unit(state);
+            case Kind::EXPONENTIAL:
+                // 1 - u is in (0, 1], so the log is finite
+                return -m_a * std::log(1.0 - unit(state));
+            case Kind::NORMAL:
+            {
+                // Box-Muller, one of the pair
+                double u = 1.0 - unit(state);
+                double v = unit(state);
+                double x = m_a + m_b * std::sqrt(-2.0 * std::log(u)) * std::cos(2 * PI * v);
+                return x > 0 ? x : 0;
+            }
+        }
+        return m_a;
+    }
+} // namespace seneca
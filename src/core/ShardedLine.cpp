@@ -0,0 +1,744 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "seneca/ShardedLine.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+namespace seneca
+{
+    namespace
+    {
+        enum class FrameType : uint32_t { SEGMENT = 1, ORDERS, CREDIT, STATE, END };
+
+        constexpr uint32_t NO_NAME = UINT32_MAX;
+        constexpr uint32_t MAX_FRAME_BYTES = 1u << 30;
+
+        struct FrameHeader
+        {
+            uint32_t m_length;          // Payload bytes
+            uint32_t m_type;
+        };
+
+        struct WireStation
+        {
+            uint32_t m_name;
+            uint32_t m_reserved;
+            uint64_t m_quantity;
+            uint64_t m_serialNumber;
+        };
+
+        // Leads SEGMENT and STATE payloads, followed by m_stationCount WireStations
+        struct WireSegment
+        {
+            uint32_t m_segment;
+            uint32_t m_stationCount;
+            uint64_t m_bytes;           // STATE only: what the worker wrote
+            uint64_t m_stalls;
+        };
+
+        // Leads an ORDERS payload; each order is a WireOrder and its WireItems
+        struct WireBatch
+        {
+            uint32_t m_orderCount;
+            uint32_t m_reserved;
+        };
+
+        struct WireOrder
+        {
+            uint32_t m_itemCount;
+            uint32_t m_reserved;
+        };
+
+        struct WireItem
+        {
+            uint32_t m_name;
+            uint32_t m_filled;
+            uint64_t m_serialNumber;
+        };
+
+        struct Frame
+        {
+            FrameType m_type{};
+            std::vector<char> m_payload{};
+
+            // False, leaving value alone, if the payload ends before the
+            // value does: frames come off a socket and may be short or garbled
+            template <typename T>
+            bool get(size_t offset, T &value) const
+            {
+                if (offset > m_payload.size() || m_payload.size() - offset < sizeof(T))
+                {
+                    return false;
+                }
+                std::memcpy(&value, m_payload.data() + offset, sizeof(T));
+                return true;
+            }
+
+            // A header followed by exactly `count` records of `record` bytes
+            bool holds(size_t header, size_t count, size_t record) const
+            {
+                return m_payload.size() >= header && (m_payload.size() - header) / record >= count &&
+                       m_payload.size() == header + count * record;
+            }
+
+            template <typename T>
+            void set(size_t offset, const T &value)
+            {
+                std::memcpy(m_payload.data() + offset, &value, sizeof(T));
+            }
+        };
+
+        template <typename T>
+        void append(std::vector<char> &bytes, const T &value)
+        {
+            const char *raw = reinterpret_cast<const char *>(&value);
+            bytes.insert(bytes.end(), raw, raw + sizeof(T));
+        }
+
+        void appendFrame(std::vector<char> &bytes, FrameType type, const std::vector<char> &payload)
+        {
+            append(bytes, FrameHeader{uint32_t(payload.size()), uint32_t(type)});
+            bytes.insert(bytes.end(), payload.begin(), payload.end());
+        }
+
+        // Blocking socket I/O; false once the peer is gone
+        bool writeAll(int fd, const char *data, size_t size)
+        {
+            while (size)
+            {
+                ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    return false;
+                }
+                data += n;
+                size -= size_t(n);
+            }
+            return true;
+        }
+
+        bool readAll(int fd, char *data, size_t size)
+        {
+            while (size)
+            {
+                ssize_t n = ::recv(fd, data, size, 0);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    return false;
+                }
+                data += n;
+                size -= size_t(n);
+            }
+            return true;
+        }
+
+        bool readFrame(int fd, Frame &frame)
+        {
+            FrameHeader header;
+            if (!readAll(fd, reinterpret_cast<char *>(&header), sizeof(header)) || header.m_length > MAX_FRAME_BYTES)
+            {
+                return false;
+            }
+            frame.m_type = FrameType(header.m_type);
+            frame.m_payload.resize(header.m_length);
+            return readAll(fd, frame.m_payload.data(), header.m_length);
+        }
+
+        bool writeFrame(int fd, FrameType type, const std::vector<char> &payload, uint64_t &bytes)
+        {
+            FrameHeader header{uint32_t(payload.size()), uint32_t(type)};
+            bytes += sizeof(header) + payload.size();
+            return writeAll(fd, reinterpret_cast<const char *>(&header), sizeof(header)) &&
+                   writeAll(fd, payload.data(), payload.size());
+        }
+
+        // Credits owed upstream for batches passed on. A sender reads credits
+        // between its own frames, so a blocking credit write could wait on a
+        // sender that is itself blocked writing to us: credits go out without
+        // blocking, and whatever the socket will not take yet is folded into
+        // one CREDIT frame at the next flush.
+        struct CreditReturn
+        {
+            uint32_t m_owed{};
+            std::vector<char> m_outbox{};
+            size_t m_flushed{};
+            bool m_closed{};            // The sender has gone (it exits after END)
+
+            bool pending() const { return !m_closed && (m_owed > 0 || !m_outbox.empty()); }
+
+            void flush(int fd, uint64_t &bytes)
+            {
+                if (m_closed)
+                {
+                    return;
+                }
+                if (m_outbox.empty() && m_owed > 0)
+                {
+                    std::vector<char> payload;
+                    append(payload, m_owed);
+                    appendFrame(m_outbox, FrameType::CREDIT, payload);
+                    m_owed = 0;
+                }
+                while (m_flushed < m_outbox.size())
+                {
+                    ssize_t n = ::send(fd, m_outbox.data() + m_flushed, m_outbox.size() - m_flushed,
+                                       MSG_NOSIGNAL | MSG_DONTWAIT);
+                    if (n < 0 && errno == EINTR)
+                    {
+                        continue;
+                    }
+                    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                    {
+                        return;
+                    }
+                    if (n <= 0)
+                    {
+                        m_closed = true;
+                        return;
+                    }
+                    bytes += uint64_t(n);
+                    m_flushed += size_t(n);
+                }
+                m_outbox.clear();
+                m_flushed = 0;
+            }
+        };
+
+        // The stations of one segment with the name index they serve
+        struct Segment
+        {
+            struct Supply
+            {
+                std::vector<size_t> m_stations;     // Chain order
+                size_t m_next{};                    // First one that may still have stock
+            };
+
+            uint32_t m_index{};
+            std::vector<WireStation> m_stations{};
+            std::unordered_map<uint32_t, Supply> m_supplies{};
+
+            // False if the frame is not a whole segment
+            bool load(const Frame &frame)
+            {
+                WireSegment header;
+                if (!frame.get(0, header) || !frame.holds(sizeof(WireSegment), header.m_stationCount, sizeof(WireStation)))
+                {
+                    return false;
+                }
+                m_index = header.m_segment;
+                m_stations.resize(header.m_stationCount);
+                for (size_t i = 0; i < m_stations.size(); i++)
+                {
+                    frame.get(sizeof(WireSegment) + i * sizeof(WireStation), m_stations[i]);
+                    m_supplies[m_stations[i].m_name].m_stations.push_back(i);
+                }
+                return true;
+            }
+
+            // Every unfilled item goes to the first of its stations with
+            // stock, as the orders would visit them in chain order. False if
+            // the frame ends before the orders it declares do; the fills made
+            // up to that point are moot, since the worker gives up.
+            bool fill(Frame &frame)
+            {
+                WireBatch batch;
+                if (!frame.get(0, batch))
+                {
+                    return false;
+                }
+                size_t offset = sizeof(WireBatch);
+                for (uint32_t o = 0; o < batch.m_orderCount; o++)
+                {
+                    WireOrder order;
+                    if (!frame.get(offset, order))
+                    {
+                        return false;
+                    }
+                    offset += sizeof(WireOrder);
+                    for (uint32_t i = 0; i < order.m_itemCount; i++, offset += sizeof(WireItem))
+                    {
+                        WireItem item;
+                        if (!frame.get(offset, item))
+                        {
+                            return false;
+                        }
+                        auto it = item.m_filled ? m_supplies.end() : m_supplies.find(item.m_name);
+                        if (it == m_supplies.end())
+                        {
+                            continue;
+                        }
+                        Supply &supply = it->second;
+                        while (supply.m_next < supply.m_stations.size() &&
+                               m_stations[supply.m_stations[supply.m_next]].m_quantity == 0)
+                        {
+                            supply.m_next++;
+                        }
+                        if (supply.m_next < supply.m_stations.size())
+                        {
+                            WireStation &station = m_stations[supply.m_stations[supply.m_next]];
+                            station.m_quantity--;
+                            item.m_filled = 1;
+                            item.m_serialNumber = station.m_serialNumber++;
+                            frame.set(offset, item);
+                        }
+                    }
+                }
+                return offset == frame.m_payload.size();
+            }
+        };
+
+        // Body of a forked worker: serves one segment until END and returns
+        // the exit status. Touches nothing inherited from the coordinator.
+        int runWorker(int upstream, int downstream, size_t credits)
+        {
+            Segment segment;
+            bool loaded = false;
+            bool holding = false;           // A filled batch waiting for credit
+            uint64_t bytes = 0;
+            uint64_t stalls = 0;
+            CreditReturn returned;
+            Frame frame;
+            Frame reply;
+
+            for (;;)
+            {
+                if (holding && credits > 0)
+                {
+                    credits--;
+                    holding = false;
+                    if (!writeFrame(downstream, FrameType::ORDERS, frame.m_payload, bytes))
+                    {
+                        return 1;
+                    }
+                    returned.m_owed++;
+                }
+                returned.flush(upstream, bytes);
+
+                // Credits are read whenever they arrive, so downstream never
+                // waits to hand them over; upstream is left alone while a
+                // batch is held
+                short watched = short((holding ? 0 : POLLIN) | (returned.pending() ? POLLOUT : 0));
+                pollfd fds[2] = {{watched ? upstream : -1, watched, 0}, {downstream, POLLIN, 0}};
+                if (::poll(fds, 2, -1) < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return 1;
+                }
+                if (fds[1].revents & (POLLIN | POLLHUP | POLLERR))
+                {
+                    uint32_t granted = 0;
+                    if (!readFrame(downstream, reply) || reply.m_type != FrameType::CREDIT || !reply.get(0, granted))
+                    {
+                        return 1;
+                    }
+                    credits += granted;
+                }
+                if (holding || !(fds[0].revents & (POLLIN | POLLHUP | POLLERR)))
+                {
+                    continue;
+                }
+                if (!readFrame(upstream, frame))
+                {
+                    return 1;
+                }
+
+                switch (frame.m_type)
+                {
+                case FrameType::SEGMENT:
+                    if (loaded)
+                    {
+                        if (!writeFrame(downstream, frame.m_type, frame.m_payload, bytes))
+                        {
+                            return 1;
+                        }
+                        break;
+                    }
+                    if (!segment.load(frame))
+                    {
+                        return 1;
+                    }
+                    loaded = true;
+                    break;
+
+                case FrameType::ORDERS:
+                    if (!segment.fill(frame))
+                    {
+                        return 1;
+                    }
+                    // Passed on at the top of the loop once credit allows
+                    stalls += credits == 0;
+                    holding = true;
+                    break;
+
+                case FrameType::STATE:
+                    if (!writeFrame(downstream, frame.m_type, frame.m_payload, bytes))
+                    {
+                        return 1;
+                    }
+                    break;
+
+                case FrameType::END:
+                {
+                    std::vector<char> state;
+                    // Counts the STATE and END frames about to be written
+                    bytes += 2 * sizeof(FrameHeader) + sizeof(WireSegment) + segment.m_stations.size() * sizeof(WireStation);
+                    append(state, WireSegment{segment.m_index, uint32_t(segment.m_stations.size()), bytes, stalls});
+                    for (const WireStation &station : segment.m_stations)
+                    {
+                        append(state, station);
+                    }
+                    uint64_t ignored = 0;
+                    return writeFrame(downstream, FrameType::STATE, state, ignored) &&
+                           writeFrame(downstream, FrameType::END, {}, ignored) ? 0 : 1;
+                }
+
+                default:
+                    return 1;
+                }
+            }
+        }
+
+        // The worker processes and the coordinator's socket ends. Whatever
+        // has not been reaped by the time the run ends is killed.
+        struct Workers
+        {
+            std::vector<pid_t> m_pids{};
+            std::vector<int> m_fds{};
+
+            ~Workers()
+            {
+                for (int fd : m_fds)
+                {
+                    ::close(fd);
+                }
+                for (pid_t pid : m_pids)
+                {
+                    ::kill(pid, SIGKILL);
+                    ::waitpid(pid, nullptr, 0);
+                }
+            }
+
+            // Waits for every worker; false if any of them failed
+            bool reap()
+            {
+                bool ok = true;
+                for (pid_t pid : m_pids)
+                {
+                    int status = 0;
+                    ok &= ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                }
+                m_pids.clear();
+                return ok;
+            }
+        };
+    }
+
+    ShardStats runSharded(const std::vector<Workstation *> &chain, SimulationContext &context,
+                          const ShardOptions &options)
+    {
+        auto started = std::chrono::steady_clock::now();
+        ShardStats stats;
+        stats.m_segments = std::max<size_t>(1, std::min(options.m_segments, chain.size()));
+        size_t batchOrders = std::max<size_t>(1, options.m_batchOrders);
+        size_t credits = std::max<size_t>(1, options.m_credits);
+
+        std::unordered_map<std::string_view, uint32_t> names;
+        for (const Workstation *ws : chain)
+        {
+            names.emplace(ws->getItemName(), uint32_t(names.size()));
+        }
+
+        // Hop k joins segment k - 1 (or the coordinator) to segment k (or
+        // the coordinator again); [0] is the upstream end, [1] the downstream
+        Workers workers;
+        std::vector<std::array<int, 2>> hops(stats.m_segments + 1);
+        for (auto &hop : hops)
+        {
+            if (::socketpair(AF_UNIX, SOCK_STREAM, 0, hop.data()) != 0)
+            {
+                throw StationException("Cannot create shard socket: " + std::string(std::strerror(errno)));
+            }
+            workers.m_fds.insert(workers.m_fds.end(), hop.begin(), hop.end());
+        }
+        for (size_t s = 0; s < stats.m_segments; s++)
+        {
+            pid_t pid = ::fork();
+            if (pid < 0)
+            {
+                throw StationException("Cannot start shard worker: " + std::string(std::strerror(errno)));
+            }
+            if (pid == 0)
+            {
+                int upstream = hops[s][1];
+                int downstream = hops[s + 1][0];
+                for (int fd : workers.m_fds)
+                {
+                    if (fd != upstream && fd != downstream)
+                    {
+                        ::close(fd);
+                    }
+                }
+                ::_exit(runWorker(upstream, downstream, credits));
+            }
+            workers.m_pids.push_back(pid);
+        }
+        int out = hops.front()[0];
+        int in = hops.back()[1];
+        for (int &fd : workers.m_fds)
+        {
+            if (fd != out && fd != in)
+            {
+                ::close(fd);
+                fd = -1;
+            }
+        }
+        workers.m_fds.erase(std::remove(workers.m_fds.begin(), workers.m_fds.end(), -1), workers.m_fds.end());
+
+        auto segmentBegin = [&chain, &stats](size_t s) { return chain.size() * s / stats.m_segments; };
+        auto workerFailed = []() { return StationException("Shard worker stopped before the run ended"); };
+
+        // Segments go out first, in line order, so each worker takes its own
+        for (size_t s = 0; s < stats.m_segments; s++)
+        {
+            std::vector<char> payload;
+            append(payload, WireSegment{uint32_t(s), uint32_t(segmentBegin(s + 1) - segmentBegin(s)), 0, 0});
+            for (size_t i = segmentBegin(s); i < segmentBegin(s + 1); i++)
+            {
+                append(payload, WireStation{names.at(chain[i]->getItemName()), 0, chain[i]->getQuantity(),
+                                            chain[i]->getSerialNumber()});
+            }
+            if (!writeFrame(out, FrameType::SEGMENT, payload, stats.m_bytes))
+            {
+                throw workerFailed();
+            }
+        }
+
+        // Orders go out as credit allows, through a non-blocking outbox, so
+        // the coordinator always keeps draining the last segment
+        OrderQueue &pending = context.pending();
+        size_t total = pending.size();
+        size_t sent = 0;
+        size_t received = 0;
+        std::vector<char> outbox;
+        size_t flushed = 0;
+        bool endQueued = false;
+        bool stalled = false;
+        bool done = false;
+        CreditReturn returned;
+        Frame frame;
+        std::vector<char> payload;
+
+        while (!done)
+        {
+            returned.flush(in, stats.m_bytes);
+            while (credits > 0 && sent < total)
+            {
+                size_t count = std::min(batchOrders, total - sent);
+                payload.clear();
+                append(payload, WireBatch{uint32_t(count), 0});
+                for (size_t o = sent; o < sent + count; o++)
+                {
+                    const CustomerOrder &order = pending[o];
+                    append(payload, WireOrder{uint32_t(order.getItemCount()), 0});
+                    for (size_t i = 0; i < order.getItemCount(); i++)
+                    {
+                        const Item &item = order.getItem(i);
+                        auto it = names.find(item.m_itemName);
+                        append(payload, WireItem{it != names.end() ? it->second : NO_NAME, item.m_isFilled,
+                                                 item.m_serialNumber});
+                    }
+                }
+                appendFrame(outbox, FrameType::ORDERS, payload);
+                sent += count;
+                credits--;
+                stats.m_batches++;
+                stalled = false;
+            }
+            if (sent == total && !endQueued)
+            {
+                appendFrame(outbox, FrameType::END, {});
+                endQueued = true;
+            }
+            if (credits == 0 && sent < total && !stalled)
+            {
+                stats.m_stalls++;
+                stalled = true;
+            }
+
+            while (flushed < outbox.size())
+            {
+                ssize_t n = ::send(out, outbox.data() + flushed, outbox.size() - flushed, MSG_NOSIGNAL | MSG_DONTWAIT);
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    break;
+                }
+                if (n <= 0)
+                {
+                    throw workerFailed();
+                }
+                stats.m_bytes += uint64_t(n);
+                flushed += size_t(n);
+            }
+            if (flushed == outbox.size())
+            {
+                outbox.clear();
+                flushed = 0;
+            }
+
+            // The first segment hangs up once it has passed END on, so its
+            // socket is only watched while something is left to send
+            bool sending = sent < total || !outbox.empty();
+            pollfd fds[2] = {{sending ? out : -1, short((sent < total ? POLLIN : 0) | (outbox.empty() ? 0 : POLLOUT)), 0},
+                             {in, short(POLLIN | (returned.pending() ? POLLOUT : 0)), 0}};
+            if (::poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw StationException("Shard coordinator poll failed: " + std::string(std::strerror(errno)));
+            }
+            if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL))
+            {
+                throw workerFailed();
+            }
+            if (fds[0].revents & POLLIN)
+            {
+                uint32_t granted = 0;
+                if (!readFrame(out, frame) || frame.m_type != FrameType::CREDIT || !frame.get(0, granted))
+                {
+                    throw workerFailed();
+                }
+                credits += granted;
+            }
+            if (!(fds[1].revents & (POLLIN | POLLHUP | POLLERR)))
+            {
+                continue;
+            }
+            if (!readFrame(in, frame))
+            {
+                throw workerFailed();
+            }
+
+            if (frame.m_type == FrameType::ORDERS)
+            {
+                // The batch is walked by the counts it declares, which must
+                // match the orders it stands for, and checked whole before any
+                // fill is applied
+                WireBatch batch;
+                if (!frame.get(0, batch) || batch.m_orderCount > total - received)
+                {
+                    throw workerFailed();
+                }
+                size_t offset = sizeof(WireBatch);
+                for (uint32_t o = 0; o < batch.m_orderCount; o++)
+                {
+                    WireOrder order;
+                    if (!frame.get(offset, order) || order.m_itemCount != pending[received + o].getItemCount() ||
+                        (frame.m_payload.size() - offset - sizeof(WireOrder)) / sizeof(WireItem) < order.m_itemCount)
+                    {
+                        throw workerFailed();
+                    }
+                    offset += sizeof(WireOrder) + size_t(order.m_itemCount) * sizeof(WireItem);
+                }
+                if (offset != frame.m_payload.size())
+                {
+                    throw workerFailed();
+                }
+
+                offset = sizeof(WireBatch);
+                for (uint32_t o = 0; o < batch.m_orderCount; o++, received++)
+                {
+                    CustomerOrder &order = pending[received];
+                    offset += sizeof(WireOrder);
+                    for (size_t i = 0; i < order.getItemCount(); i++, offset += sizeof(WireItem))
+                    {
+                        WireItem item;
+                        frame.get(offset, item);
+                        if (item.m_filled && !order.getItem(i).m_isFilled)
+                        {
+                            order.setItemFilled(i, item.m_serialNumber);
+                        }
+                    }
+                }
+                returned.m_owed++;
+            }
+            else if (frame.m_type == FrameType::STATE)
+            {
+                WireSegment state;
+                if (!frame.get(0, state) || state.m_segment >= stats.m_segments ||
+                    state.m_stationCount != segmentBegin(state.m_segment + 1) - segmentBegin(state.m_segment) ||
+                    !frame.holds(sizeof(WireSegment), state.m_stationCount, sizeof(WireStation)))
+                {
+                    throw workerFailed();
+                }
+                for (size_t i = 0; i < state.m_stationCount; i++)
+                {
+                    WireStation station;
+                    frame.get(sizeof(WireSegment) + i * sizeof(WireStation), station);
+                    Workstation *ws = chain[segmentBegin(state.m_segment) + i];
+                    ws->setQuantity(station.m_quantity);
+                    ws->setSerialNumber(station.m_serialNumber);
+                }
+                stats.m_bytes += state.m_bytes;
+                stats.m_stalls += state.m_stalls;
+            }
+            else if (frame.m_type == FrameType::END)
+            {
+                done = true;
+            }
+            else
+            {
+                throw workerFailed();
+            }
+        }
+
+        if (received != total || !workers.reap())
+        {
+            throw workerFailed();
+        }
+
+        OrderQueue &completed = context.completed();
+        OrderQueue &incomplete = context.incomplete();
+        while (!pending.empty())
+        {
+            OrderHandle handle = pending.frontHandle();
+            (pending.front().isOrderFilled() ? completed : incomplete).push_back(handle);
+            pending.pop_front();
+        }
+
+        auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - started).count();
+        LOG_INFO("Sharded run: " + std::to_string(total) + " orders through " + std::to_string(stats.m_segments) +
+                 " worker processes in " + std::to_string(elapsedMs) + " ms (" + std::to_string(stats.m_batches) +
+                 " batches, " + std::to_string(stats.m_bytes) + " bytes, " + std::to_string(stats.m_stalls) +
+                 " credit stalls)");
+        return stats;
+    }
+} // namespace seneca
@@ -0,0 +1,44 @@
+#include "seneca/SimulationContext.h"
+#include "seneca/Workstation.h"
+
+namespace seneca
+{
+    namespace
+    {
+        SimulationContext s_defaultContext{};
+        thread_local SimulationContext* t_current = nullptr;
+    }
+
+    // The default context's pool and queues under their historical names
+    OrderPool& g_orderPool = s_defaultContext.pool();
+    OrderQueue& g_pending = s_defaultContext.pending();
+    OrderQueue& g_completed = s_defaultContext.completed();
+    OrderQueue& g_incomplete = s_defaultContext.incomplete();
+
+    void SimulationContext::clearOrders()
+    {
+        m_pending.clear();
+        m_completed.clear();
+        m_incomplete.clear();
+    }
+
+    SimulationContext& SimulationContext::current()
+    {
+        return t_current ? *t_current : s_defaultContext;
+    }
+
+    SimulationContext& SimulationContext::defaultContext()
+    {
+        return s_defaultContext;
+    }
+
+    SimulationContext::Scope::Scope(SimulationContext& context) : m_previous(t_current)
+    {
+        t_current = &context;
+    }
+
+    SimulationContext::Scope::~Scope()
+    {
+        t_current = m_previous;
+    }
+} // namespace seneca
@@ -1,18 +1,22 @@
 #include "seneca/Station.h"
+#include "seneca/SimulationContext.h"
 
 namespace seneca
 {
-    size_t Station::id_generator = 0;
-    size_t Station::m_widthField = 0;
+    Station::Station(const std::string &name) : Station(name, Utilities::getDelimiter())
+    {
+    }
 
-    Station::Station(const std::string &name)
+    Station::Station(const std::string &name, char delimiter)
     {
         //std::cout << name << std::endl;
-        Utilities ut;
+        Utilities ut(delimiter);
         size_t next_pos = 0;
         bool more = false;
 
-        m_id = ++id_generator;
+        auto info = std::make_shared<StationInfo>();
+        SimulationContext& context = SimulationContext::current();
+        info->m_id = int(context.nextStationId());
         try
         {
             m_name = ut.extractToken(name, next_pos, more);
@@ -22,25 +26,42 @@ namespace seneca
 
             if(more) m_itemQuantity = std::stoul(ut.extractToken(name, next_pos, more));
 
-            if (m_widthField < ut.getFieldWidth())
-            {
-                m_widthField = ut.getFieldWidth();
-            }
+            info->m_fieldWidth = ut.getFieldWidth();
+            context.raiseStationWidth(info->m_fieldWidth);
+
+            if(more) info->m_description = ut.extractToken(name, next_pos, more);
 
-            if(more) m_description = ut.extractToken(name, next_pos, more);
+            std::string service;
+            if(more && ut.nextToken(name, next_pos, more, service) == ParseStatus::OK &&
+               !parseServiceField(service, info->m_service))
+                throw std::runtime_error("Bad service time '" + service + "'");
         }
         catch (const std::exception &e)
         {
             throw std::runtime_error("Error constructing Station: " + name + " | " + e.what());
         }
+        m_info = std::move(info);
 
         // std::cout << "m_name: " << m_name << std::endl;
         // std::cout << "m_serialNumber: " << m_serialNumber << std::endl;
         // std::cout << "m_itemQuantity: " << m_itemQuantity << std::endl;
-        // std::cout << "m_widthField: " << m_widthField << std::endl;
         // std::cout << "m_description: " << m_description << std::endl;
     }
 
+    Station::Station(const std::string &name, size_t serialNumber, size_t quantity,
+                     const std::string &description, size_t fieldWidth, const ServiceTime &service)
+        : m_name(name), m_serialNumber(serialNumber), m_itemQuantity(quantity)
+    {
+        auto info = std::make_shared<StationInfo>();
+        SimulationContext& context = SimulationContext::current();
+        info->m_id = int(context.nextStationId());
+        info->m_description = description;
+        info->m_fieldWidth = fieldWidth;
+        info->m_service = service;
+        context.raiseStationWidth(fieldWidth);
+        m_info = std::move(info);
+    }
+
     const std::string &Station::getItemName() const
     {
         return m_name;
@@ -48,20 +69,92 @@ namespace seneca
 
     size_t Station::getNextSerialNumber()
     {
+        if (m_shared)
+        {
+            return m_shared->m_nextSerial.fetch_add(1, std::memory_order_relaxed);
+        }
         return m_serialNumber++;
     }
 
+    size_t Station::getSerialNumber() const
+    {
+        return m_shared ? m_shared->m_nextSerial.load(std::memory_order_relaxed) : m_serialNumber;
+    }
+
+    void Station::setSerialNumber(size_t serialNumber)
+    {
+        if (m_shared)
+        {
+            m_shared->m_nextSerial.store(serialNumber, std::memory_order_relaxed);
+        }
+        m_serialNumber = serialNumber;
+    }
+
     size_t Station::getQuantity() const
     {
-        return m_itemQuantity;
+        return m_shared ? m_shared->m_quantity.load(std::memory_order_relaxed) : m_itemQuantity;
     }
 
     void Station::updateQuantity()
     {
-        if (m_itemQuantity > 0)
+        if (m_shared)
+        {
+            size_t quantity = m_shared->m_quantity.load(std::memory_order_relaxed);
+            while (quantity > 0 &&
+                   !m_shared->m_quantity.compare_exchange_weak(quantity, quantity - 1, std::memory_order_relaxed))
+            {
+            }
+        }
+        else if (m_itemQuantity > 0)
+        {
+            m_itemQuantity--;
+        }
+    }
+
+    void Station::setQuantity(size_t quantity)
+    {
+        if (m_shared)
+        {
+            m_shared->m_quantity.store(quantity, std::memory_order_relaxed);
+        }
+        m_itemQuantity = quantity;
+    }
+
+    bool Station::takeUnit(size_t &serialNumber)
+    {
+        if (!m_shared)
         {
+            if (m_itemQuantity == 0)
+            {
+                return false;
+            }
             m_itemQuantity--;
+            serialNumber = m_serialNumber++;
+            return true;
+        }
+
+        // Reserve the unit first: a replica that loses the race for the
+        // last one must not consume a serial number
+        size_t quantity = m_shared->m_quantity.load(std::memory_order_relaxed);
+        do
+        {
+            if (quantity == 0)
+            {
+                return false;
+            }
+        } while (!m_shared->m_quantity.compare_exchange_weak(quantity, quantity - 1, std::memory_order_relaxed));
+        serialNumber = m_shared->m_nextSerial.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void Station::shareInventory(SharedInventory *inventory)
+    {
+        if (m_shared)
+        {
+            m_itemQuantity = m_shared->m_quantity.load(std::memory_order_relaxed);
+            m_serialNumber = m_shared->m_nextSerial.load(std::memory_order_relaxed);
         }
+        m_shared = inventory;
     }
 
     void Station::display(std::ostream &os, bool full) const
@@ -71,14 +164,14 @@ namespace seneca
         // std::cout << m_serialNumber << std::endl;
         // std::cout << m_itemQuantity << std::endl;
         
-        os << std::right << std::setw(3) << std::setfill('0') << m_id << " | "
-           << std::setw(m_widthField) << std::setfill(' ') << std::left << m_name << " | "
-           << std::setw(6) << std::setfill('0') << std::right << m_serialNumber << " | ";
+        os << std::right << std::setw(3) << std::setfill('0') << m_info->m_id << " | "
+           << std::setw(SimulationContext::current().stationWidth()) << std::setfill(' ') << std::left << m_name << " | "
+           << std::setw(6) << std::setfill('0') << std::right << getSerialNumber() << " | ";
 
         if (full)
         {
-            os << std::setw(4) << std::setfill(' ') << m_itemQuantity << " | "
-               << m_description;
+            os << std::setw(4) << std::setfill(' ') << getQuantity() << " | "
+               << m_info->m_description;
         }
         os << std::endl;
     }
@@ -0,0 +1,110 @@
+#include <new>
+#include <utility>
+#include "seneca/StationRegistry.h"
+#include "seneca/Exceptions.h"
+
+namespace seneca
+{
+    namespace
+    {
+        constexpr std::align_val_t STATION_ALIGN{alignof(Workstation)};
+    }
+
+    StationRegistry::StationRegistry(const std::vector<Station>& stations, const std::vector<size_t>& layout)
+    {
+        if (!layout.empty() && layout.size() != stations.size())
+        {
+            throw ValidationException("Station layout covers " + std::to_string(layout.size()) +
+                                      " of " + std::to_string(stations.size()) + " stations");
+        }
+
+        m_stations = static_cast<Workstation*>(
+            ::operator new(sizeof(Workstation) * stations.size(), STATION_ALIGN));
+        m_slotOf.assign(stations.size(), npos);
+        m_index.reserve(stations.size());
+        try
+        {
+            for (size_t slot = 0; slot < stations.size(); slot++)
+            {
+                size_t index = layout.empty() ? slot : layout[slot];
+                if (index >= stations.size() || m_slotOf[index] != npos)
+                {
+                    throw ValidationException("Station layout is not a permutation");
+                }
+                new (m_stations + slot) Workstation(stations[index]);
+                m_count++;
+                m_slotOf[index] = slot;
+            }
+            // Duplicate names resolve to the first in input order, like
+            // LineManager's own lookup
+            for (size_t index = 0; index < stations.size(); index++)
+            {
+                m_index.emplace(stations[index].getItemName(), m_slotOf[index]);
+            }
+        }
+        catch (...)
+        {
+            destroy();
+            throw;
+        }
+    }
+
+    StationRegistry::StationRegistry(StationRegistry&& other) noexcept
+        : m_stations(other.m_stations), m_count(other.m_count),
+          m_slotOf(std::move(other.m_slotOf)), m_index(std::move(other.m_index))
+    {
+        other.m_stations = nullptr;
+        other.m_count = 0;
+    }
+
+    StationRegistry& StationRegistry::operator=(StationRegistry&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            m_stations = std::exchange(other.m_stations, nullptr);
+            m_count = std::exchange(other.m_count, 0);
+            m_slotOf = std::move(other.m_slotOf);
+            m_index = std::move(other.m_index);
+        }
+        return *this;
+    }
+
+    StationRegistry::~StationRegistry()
+    {
+        destroy();
+    }
+
+    void StationRegistry::destroy()
+    {
+        for (size_t i = m_count; i > 0; i--)
+        {
+            m_stations[i - 1].~Workstation();
+        }
+        if (m_stations)
+        {
+            ::operator delete(m_stations, STATION_ALIGN);
+        }
+        m_stations = nullptr;
+        m_count = 0;
+        m_slotOf.clear();
+        m_index.clear();
+    }
+
+    size_t StationRegistry::find(const std::string& itemName) const
+    {
+        auto it = m_index.find(itemName);
+        return it != m_index.end() ? it->second : npos;
+    }
+
+    std::vector<Workstation*> StationRegistry::stations()
+    {
+        std::vector<Workstation*> stations;
+        stations.reserve(m_slotOf.size());
+        for (size_t slot : m_slotOf)
+        {
+            stations.push_back(m_stations + slot);
+        }
+        return stations;
+    }
+} // namespace seneca
@@ -0,0 +1,275 @@
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+#include "seneca/TimedEngine.h"
+#include "seneca/CalendarQueue.h"
+#include "seneca/Exceptions.h"
+
+namespace seneca
+{
+    namespace
+    {
+        enum EventKind : uint32_t
+        {
+            EVENT_RELEASE,
+            EVENT_DONE
+        };
+
+        constexpr uint32_t NO_STATION = std::numeric_limits<uint32_t>::max();
+
+        uint64_t streamSeed(uint64_t seed, uint64_t stream)
+        {
+            uint64_t x = seed ^ (stream * 0xd1342543de82ef95ULL);
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+            return x ^ (x >> 31);
+        }
+
+        // A first calendar width: the mean time a station takes per unit
+        double initialWidth(const std::vector<Workstation*>& line)
+        {
+            double total = 0;
+            size_t timed = 0;
+            for (const Workstation* ws : line)
+            {
+                double mean = ws->getServiceTime().mean();
+                total += mean;
+                timed += mean > 0;
+            }
+            return timed ? total / double(timed) : 1.0;
+        }
+
+        class TimedRun {
+            const std::vector<Workstation*>& m_line;
+            Workstation* m_first;
+            SimulationContext& m_context;
+            const TimedOptions& m_options;
+            CalendarQueue m_calendar;
+            std::unordered_map<const Workstation*, uint32_t> m_index{};
+            std::vector<uint32_t> m_next{};         // Where every order leaving a station goes, if fixed
+            std::vector<char> m_busy{};
+            std::vector<uint64_t> m_streams{};      // Per station, then the release stream last
+            std::vector<double> m_released{};       // By order handle
+            double m_now{};
+            double m_flowTime{};
+            TimedStats m_stats{};
+
+            bool start(uint32_t s, CustomerOrder& order);
+            void arrive(OrderHandle handle, uint32_t s);
+            void leave(OrderHandle handle, uint32_t s);
+            void retire(OrderHandle handle, const CustomerOrder& order);
+            void serveQueue(uint32_t s);
+
+            public:
+                TimedRun(const std::vector<Workstation*>& line, Workstation* first, SimulationContext& context,
+                         const TimedOptions& options);
+                TimedStats run();
+        };
+
+        TimedRun::TimedRun(const std::vector<Workstation*>& line, Workstation* first, SimulationContext& context,
+                           const TimedOptions& options)
+            : m_line(line), m_first(first), m_context(context), m_options(options),
+              m_calendar(initialWidth(line))
+        {
+            if (line.size() >= NO_STATION)
+            {
+                throw StationException("runTimed() supports at most " + std::to_string(NO_STATION - 1) + " stations");
+            }
+
+            m_index.reserve(line.size());
+            for (uint32_t s = 0; s < line.size(); s++)
+            {
+                m_index.emplace(line[s], s);
+            }
+            m_next.assign(line.size(), NO_STATION);
+            m_stats.m_stations.resize(line.size());
+            for (uint32_t s = 0; s < line.size(); s++)
+            {
+                const Workstation* next = line[s]->getNextStation();
+                if (next && !line[s]->getFork() && !next->getLanes())
+                {
+                    m_next[s] = m_index.at(next);
+                }
+                m_stats.m_stations[s].m_station = line[s];
+                m_streams.push_back(streamSeed(options.m_seed, s));
+            }
+            m_streams.push_back(streamSeed(options.m_seed, line.size()));
+            m_busy.assign(line.size(), 0);
+
+            OrderHandle last = 0;
+            const OrderQueue& pending = context.pending();
+            for (auto it = pending.begin(); it != pending.end(); ++it)
+            {
+                last = std::max(last, it.handle());
+            }
+            m_released.assign(size_t(last) + 1, 0.0);
+        }
+
+        // Takes the station's units for the order; true if that takes time,
+        // in which case the station is busy until the scheduled completion
+        bool TimedRun::start(uint32_t s, CustomerOrder& order)
+        {
+            Workstation* ws = m_line[s];
+            const std::string& name = ws->getItemName();
+            const ServiceTime& service = ws->getServiceTime();
+            uint64_t units = 0;
+            double duration = 0;
+            for (size_t i = 0; i < order.getItemCount(); i++)
+            {
+                const Item& item = order.getItem(i);
+                if (item.m_isFilled || item.m_itemName != name)
+                {
+                    continue;
+                }
+                size_t serial;
+                if (!ws->takeUnit(serial))
+                {
+                    break;
+                }
+                order.setItemFilled(i, serial);
+                duration += service.sample(m_streams[s]);
+                units++;
+            }
+            if (units == 0)
+            {
+                return false;
+            }
+
+            StationTimes& times = m_stats.m_stations[s];
+            times.m_services++;
+            times.m_units += units;
+            times.m_busy += duration;
+            m_stats.m_coalesced += units - 1;
+            if (duration == 0)
+            {
+                return false;
+            }
+            m_busy[s] = 1;
+            m_calendar.push(m_now + duration, s, EVENT_DONE);
+            m_stats.m_peakEvents = std::max<uint64_t>(m_stats.m_peakEvents, m_calendar.size());
+            return true;
+        }
+
+        // The order reaches station s. It waits its turn behind a busy
+        // station or a queue; otherwise it is served, or passes through
+        // without touching the station's queue, at once.
+        void TimedRun::arrive(OrderHandle handle, uint32_t s)
+        {
+            CustomerOrder& order = m_context.pool().get(handle);
+            for (;;)
+            {
+                Workstation* ws = m_line[s];
+                if (m_busy[s] || ws->getOrderCount() || start(s, order))
+                {
+                    *ws += handle;
+                    return;
+                }
+                m_stats.m_coalesced++;
+
+                Workstation* next = ws->route(order);
+                if (!next)
+                {
+                    retire(handle, order);
+                    return;
+                }
+                next = next->pickLane();
+                uint32_t fixed = m_next[s];
+                s = fixed != NO_STATION && m_line[fixed] == next ? fixed : m_index.at(next);
+            }
+        }
+
+        // The order is done at station s and moves on as
+        // Workstation::attemptToMoveOrder() would move it
+        void TimedRun::leave(OrderHandle handle, uint32_t s)
+        {
+            const CustomerOrder& order = m_context.pool().get(handle);
+            Workstation* next = m_line[s]->route(order);
+            if (!next)
+            {
+                retire(handle, order);
+                return;
+            }
+            next = next->pickLane();
+            uint32_t fixed = m_next[s];
+            arrive(handle, fixed != NO_STATION && m_line[fixed] == next ? fixed : m_index.at(next));
+        }
+
+        void TimedRun::retire(OrderHandle handle, const CustomerOrder& order)
+        {
+            (order.isOrderFilled() ? m_context.completed() : m_context.incomplete()).push_back(handle);
+            double flow = m_now - m_released[handle];
+            m_flowTime += flow;
+            m_stats.m_maxFlowTime = std::max(m_stats.m_maxFlowTime, flow);
+            m_stats.m_makespan = m_now;
+            m_stats.m_orders++;
+        }
+
+        // A station that just finished works through its queue: orders
+        // that need nothing from it leave at once, the first that does
+        // starts service
+        void TimedRun::serveQueue(uint32_t s)
+        {
+            Workstation* ws = m_line[s];
+            while (ws->getOrderCount())
+            {
+                if (start(s, m_context.pool().get(ws->getOrders().frontHandle())))
+                {
+                    return;
+                }
+                m_stats.m_coalesced++;
+                leave(ws->popOrder(), s);
+            }
+        }
+
+        TimedStats TimedRun::run()
+        {
+            OrderQueue& pending = m_context.pending();
+            uint64_t& releaseStream = m_streams.back();
+            if (!pending.empty())
+            {
+                m_calendar.push(0.0, 0, EVENT_RELEASE);
+            }
+
+            while (!m_calendar.empty())
+            {
+                TimedEvent event = m_calendar.pop();
+                m_now = event.m_time;
+                m_stats.m_events++;
+                if (event.m_kind == EVENT_RELEASE)
+                {
+                    // Everything released at this instant enters with this event
+                    double gap = 0;
+                    for (bool first = true; gap == 0 && !pending.empty(); first = false)
+                    {
+                        m_stats.m_coalesced += !first;
+                        OrderHandle handle = pending.frontHandle();
+                        pending.pop_front();
+                        m_released[handle] = m_now;
+                        arrive(handle, m_index.at(m_first->pickLane()));
+                        gap = m_options.m_interarrival.sample(releaseStream);
+                    }
+                    if (!pending.empty())
+                    {
+                        m_calendar.push(m_now + gap, 0, EVENT_RELEASE);
+                    }
+                    continue;
+                }
+
+                uint32_t s = event.m_target;
+                m_busy[s] = 0;
+                leave(m_line[s]->popOrder(), s);
+                serveQueue(s);
+            }
+
+            m_stats.m_meanFlowTime = m_stats.m_orders ? m_flowTime / double(m_stats.m_orders) : 0;
+            m_stats.m_throughput = m_stats.m_makespan > 0 ? double(m_stats.m_orders) / m_stats.m_makespan : 0;
+            return m_stats;
+        }
+    }
+
+    TimedStats runTimed(const std::vector<Workstation*>& line, Workstation* first, SimulationContext& context,
+                        const TimedOptions& options)
+    {
+        return TimedRun(line, first, context, options).run();
+    }
+} // namespace seneca
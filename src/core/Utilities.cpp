@@ -1,8 +1,9 @@
 #include "seneca/Utilities.h"
 #include <algorithm>
+#include <cstdio>
 namespace seneca
 {
-    char Utilities::m_delimiter = ',';
+    std::atomic<char> Utilities::m_defaultDelimiter{','};
 
     void Utilities::setFieldWidth(size_t newWidth) {
         m_widthField = newWidth;
@@ -11,20 +12,40 @@ namespace seneca
         return m_widthField;
     }
 
+    const char* toString(ParseStatus status) {
+        switch (status) {
+            case ParseStatus::OK: return "ok";
+            case ParseStatus::EMPTY_FIELD: return "empty field";
+            case ParseStatus::BAD_NUMBER: return "not a number";
+            case ParseStatus::BAD_SERVICE: return "bad service time";
+        }
+        return "unknown";
+    }
+
     std::string Utilities::extractToken(const std::string &str, size_t &next_pos, bool &more)
+    {
+        std::string token;
+        if (nextToken(str, next_pos, more, token) != ParseStatus::OK)
+        {
+            throw std::runtime_error("No token");
+        }
+        return token;
+    }
+
+    ParseStatus Utilities::nextToken(const std::string &str, size_t &next_pos, bool &more, std::string &token)
     {
         if (next_pos >= str.length())
         {
             more = false;
-            return "";
+            token.clear();
+            return ParseStatus::OK;
         }
 
         size_t pos = str.find(m_delimiter, next_pos);
-        std::string token;
 
         if (pos == std::string::npos)
         {
-            token = str.substr(next_pos);
+            token.assign(str, next_pos, std::string::npos);
             next_pos = str.length();
             more = false;
         }
@@ -34,10 +55,10 @@ namespace seneca
             if (pos == next_pos)
             {
                 more = false;
-                throw std::runtime_error("No token");
+                return ParseStatus::EMPTY_FIELD;
             }
 
-            token = str.substr(next_pos, pos - next_pos);
+            token.assign(str, next_pos, pos - next_pos);
             next_pos = pos + 1;
             more = true;
         }
@@ -55,14 +76,38 @@ namespace seneca
             setFieldWidth(token.length());
         }
 
-        return token;
+        return ParseStatus::OK;
     }
 
     void Utilities::setDelimiter(char newDelimiter) {
-        m_delimiter = newDelimiter;
+        m_defaultDelimiter.store(newDelimiter, std::memory_order_relaxed);
     }
 
     char Utilities::getDelimiter() {
-        return m_delimiter;
+        return m_defaultDelimiter.load(std::memory_order_relaxed);
+    }
+
+    std::string escapeJson(const std::string& str) {
+        std::string out;
+        out.reserve(str.size() + 2);
+        for (unsigned char ch : str) {
+            switch (ch) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (ch < 0x20) {
+                        char buf[8];
+                        snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                        out += buf;
+                    }
+                    else {
+                        out += static_cast<char>(ch);
+                    }
+            }
+        }
+        return out;
     }
 }  // namespace seneca
@@ -1,17 +1,28 @@
+#include <algorithm>
 #include "seneca/Workstation.h"
 
 namespace seneca
 {
-    std::deque<CustomerOrder> g_pending{};
-    std::deque<CustomerOrder> g_completed{};
-    std::deque<CustomerOrder> g_incomplete{};
-
     Workstation::Workstation(const std::string& str) : Station(str){}
 
-    void Workstation::fill(std::ostream& os) {
+    Workstation::Workstation(const Station& station) : Station(station){
+        // The station may have been parsed under another context
+        m_context->raiseStationWidth(station.getFieldWidth());
+    }
+
+    bool Workstation::fill(std::ostream& os) {
+        m_metrics.recordTick(m_orders.size());
         if(!m_orders.empty()) {
-            m_orders.front().fillItem(*this,os);
+            CustomerOrder& order = m_orders.front();
+            if(order.fillItem(*this,os)) {
+                m_metrics.m_fills.add();
+                return true;
+            }
+            if(!order.isItemFilled(getItemName())) {
+                m_metrics.m_failedFills.add();
+            }
         }
+        return false;
     }
 
     // bool Workstation::attemptToMoveOrder() {
@@ -49,32 +60,42 @@ namespace seneca
             return false;
         }
 
-        CustomerOrder &order = m_orders.front();
+        OrderHandle handle = m_orders.frontHandle();
+        const CustomerOrder &order = m_context->pool().get(handle);
 
         if (order.isItemFilled(getItemName()) || getQuantity() == 0)
         {
-            if (m_pNextStation)
+            // Only the handle moves; the order itself stays put in the pool
+            if (Workstation *next = route(order))
             {
-                *m_pNextStation += std::move(order);
+                *next->pickLane() += handle;
             }
             else
             {
                 if (order.isOrderFilled())
                 {
-                    g_completed.push_back(std::move(order));
+                    m_context->completed().push_back(handle);
                 }
                 else
                 {
-                    g_incomplete.push_back(std::move(order));
+                    m_context->incomplete().push_back(handle);
                 }
             }
             m_orders.pop_front();
+            m_metrics.m_ordersPassed.add();
             return true;
         }
 
         return false;
     }
 
+    OrderHandle Workstation::popOrder()
+    {
+        OrderHandle handle = m_orders.frontHandle();
+        m_orders.pop_front();
+        return handle;
+    }
+
     void Workstation::setNextStation(Workstation *station)
     {
         m_pNextStation = station;
@@ -85,10 +106,69 @@ namespace seneca
         return m_pNextStation;
     }
 
+    Workstation *Workstation::route(const CustomerOrder &order) const
+    {
+        if (!m_fork)
+        {
+            return m_pNextStation;
+        }
+
+        size_t best = 0;
+        size_t bestScore = 0;
+        for (size_t s = 0; s < m_fork->m_successors.size(); s++)
+        {
+            const auto &reach = m_fork->m_reach[s];
+            size_t score = 0;
+            for (size_t i = 0; i < order.getItemCount(); i++)
+            {
+                const Item &item = order.getItem(i);
+                if (item.m_isFilled)
+                {
+                    continue;
+                }
+                auto it = reach.find(item.m_itemName);
+                score += it != reach.end() &&
+                         std::any_of(it->second.begin(), it->second.end(),
+                                     [](const Workstation *ws) { return ws->getQuantity() > 0; });
+            }
+            if (score > bestScore)
+            {
+                best = s;
+                bestScore = score;
+            }
+        }
+        return m_fork->m_successors[best];
+    }
+
+    Workstation *Workstation::pickLane()
+    {
+        if (!m_lanes)
+        {
+            return this;
+        }
+
+        Workstation *lane = m_lanes->front();
+        for (Workstation *candidate : *m_lanes)
+        {
+            if (candidate->m_orders.size() < lane->m_orders.size())
+            {
+                lane = candidate;
+            }
+        }
+        return lane;
+    }
+
     void Workstation::display(std::ostream &os) const
     {
         os << getItemName() << " --> ";
-        if (m_pNextStation)
+        if (m_fork)
+        {
+            for (size_t s = 0; s < m_fork->m_successors.size(); s++)
+            {
+                os << (s ? ", " : "") << m_fork->m_successors[s]->getItemName();
+            }
+        }
+        else if (m_pNextStation)
         {
             os << m_pNextStation->getItemName();
         }
@@ -105,6 +185,12 @@ namespace seneca
         return *this;
     }
 
+    Workstation &Workstation::operator+=(OrderHandle order)
+    {
+        m_orders.push_back(order);
+        return *this;
+    }
+
     
 } // namespace seneca
 
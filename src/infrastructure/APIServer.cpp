@@ -0,0 +1,677 @@
+#include "seneca/APIServer.h"
+#include "seneca/Logger.h"
+#include "seneca/Utilities.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+#include <unordered_map>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <fcntl.h>
+#endif
+
+namespace seneca
+{
+    std::unique_ptr<APIServer> APIServer::s_instance = nullptr;
+    std::mutex APIServer::s_mutex;
+
+    namespace
+    {
+        const size_t MAX_HEADER_BYTES = 64 * 1024;
+        const size_t MAX_BODY_BYTES = 1024 * 1024;
+
+        struct Connection
+        {
+            std::string in;
+            std::string out;
+            size_t outPos{0};
+            bool closeAfterWrite{false};
+        };
+
+        // Each worker owns a listening socket bound with SO_REUSEPORT, so the
+        // kernel spreads new connections across workers and no accept queue
+        // or connection state is shared between threads
+        struct Worker
+        {
+            int listenFd{-1};
+            int epollFd{-1};
+            int wakeFd{-1};
+            std::thread thread;
+            std::unordered_map<int, Connection> connections;
+        };
+
+        struct ServerImpl
+        {
+            std::vector<std::unique_ptr<Worker>> workers;
+            std::atomic<bool> stopping{false};
+            std::atomic<unsigned long long> requests{0};
+
+            // Routes and documents may be registered before start() and survive restarts
+            std::mutex routeMutex;
+            std::map<std::string, std::shared_ptr<const std::string>> documents;
+            std::map<std::string, RouteHandler> routes;  // keyed by "METHOD /path"
+            std::map<std::string, RouteHandler> jobs;    // keyed by "METHOD /path"
+
+            // Jobs run one at a time on the executor thread, so a long one
+            // never holds up a worker and the connections it serves
+            std::thread executor;
+            std::mutex jobMutex;
+            std::condition_variable jobReady;
+            RouteHandler job;
+            std::string jobBody;
+            std::string jobPath;
+            std::atomic<bool> jobRunning{false};
+        };
+
+        ServerImpl& impl(void* server)
+        {
+            return *static_cast<ServerImpl*>(server);
+        }
+
+        const char* reasonPhrase(int status)
+        {
+            switch (status)
+            {
+                case 200: return "OK";
+                case 202: return "Accepted";
+                case 204: return "No Content";
+                case 400: return "Bad Request";
+                case 404: return "Not Found";
+                case 409: return "Conflict";
+                case 413: return "Payload Too Large";
+                case 431: return "Request Header Fields Too Large";
+                case 500: return "Internal Server Error";
+                default: return "Unknown";
+            }
+        }
+
+        std::string buildResponse(int status, const std::string& body, bool keepAlive)
+        {
+            std::ostringstream ss;
+            ss << "HTTP/1.1 " << status << " " << reasonPhrase(status) << "\r\n"
+               << "Content-Type: application/json\r\n"
+               << "Content-Length: " << body.size() << "\r\n"
+               << "Access-Control-Allow-Origin: *\r\n"
+               << "Access-Control-Allow-Methods: GET, POST, OPTIONS\r\n"
+               << "Access-Control-Allow-Headers: Content-Type\r\n"
+               << "Connection: " << (keepAlive ? "keep-alive" : "close") << "\r\n\r\n"
+               << body;
+            return ss.str();
+        }
+
+        std::string errorBody(const std::string& message)
+        {
+            return "{\"detail\":\"" + escapeJson(message) + "\"}";
+        }
+
+        std::string toLower(std::string s)
+        {
+            std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+            return s;
+        }
+
+        int dispatch(ServerImpl& server, const std::string& method, const std::string& path,
+                     const std::string& body, std::string& response)
+        {
+            if (method == "OPTIONS")
+            {
+                return 204;
+            }
+
+            if (method == "GET" && path == "/health")
+            {
+                response = "{\"status\":\"healthy\"}";
+                return 200;
+            }
+
+            // Only the pointers are taken under the lock; the document is
+            // copied after it is released so a large one never stalls the
+            // publisher or the other workers
+            RouteHandler handler;
+            RouteHandler job;
+            std::shared_ptr<const std::string> snapshot;
+            {
+                std::lock_guard<std::mutex> lock(server.routeMutex);
+                auto route = server.routes.find(method + " " + path);
+                auto queued = server.jobs.find(method + " " + path);
+                if (route != server.routes.end())
+                {
+                    handler = route->second;
+                }
+                else if (queued != server.jobs.end())
+                {
+                    job = queued->second;
+                }
+                else if (method == "GET")
+                {
+                    auto doc = server.documents.find(path);
+                    if (doc != server.documents.end())
+                    {
+                        snapshot = doc->second;
+                    }
+                }
+            }
+            if (snapshot)
+            {
+                response = *snapshot;
+                return 200;
+            }
+
+            if (job)
+            {
+                std::lock_guard<std::mutex> lock(server.jobMutex);
+                if (server.jobRunning)
+                {
+                    response = errorBody("A job is already running; try again when it completes");
+                    return 409;
+                }
+                server.jobRunning = true;
+                server.job = std::move(job);
+                server.jobBody = body;
+                server.jobPath = path;
+                server.jobReady.notify_one();
+                response = "{\"status\":\"accepted\"}";
+                return 202;
+            }
+
+            if (!handler)
+            {
+                response = errorBody("Not found: " + method + " " + path);
+                return 404;
+            }
+
+            try
+            {
+                response = handler(body);
+                return 200;
+            }
+            catch (const std::exception& e)
+            {
+                response = errorBody(e.what());
+                return 500;
+            }
+        }
+
+        // Runs accepted jobs until the server stops; one accepted just before
+        // stop() still runs, so a 202 is never silently dropped
+        void executorLoop(ServerImpl& server)
+        {
+            for (;;)
+            {
+                RouteHandler job;
+                std::string body;
+                std::string path;
+                {
+                    std::unique_lock<std::mutex> lock(server.jobMutex);
+                    server.jobReady.wait(lock, [&server]() { return server.job || server.stopping; });
+                    if (!server.job)
+                    {
+                        return;
+                    }
+                    job = std::move(server.job);
+                    server.job = nullptr;
+                    body = std::move(server.jobBody);
+                    path = std::move(server.jobPath);
+                }
+
+                std::string result;
+                try
+                {
+                    result = job(body);
+                }
+                catch (const std::exception& e)
+                {
+                    LOG_ERROR("API job " + path + " failed: " + e.what());
+                    result = errorBody(e.what());
+                }
+
+                {
+                    std::lock_guard<std::mutex> lock(server.routeMutex);
+                    server.documents[path] = std::make_shared<const std::string>(std::move(result));
+                }
+                server.jobRunning = false;
+            }
+        }
+
+#ifdef __linux__
+        void closeConnection(Worker& worker, int fd)
+        {
+            epoll_ctl(worker.epollFd, EPOLL_CTL_DEL, fd, nullptr);
+            close(fd);
+            worker.connections.erase(fd);
+        }
+
+        // Returns false if the connection was closed
+        bool flush(Worker& worker, int fd, Connection& conn)
+        {
+            while (conn.outPos < conn.out.size())
+            {
+                ssize_t n = send(fd, conn.out.data() + conn.outPos, conn.out.size() - conn.outPos, MSG_NOSIGNAL);
+                if (n < 0)
+                {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK)
+                    {
+                        epoll_event ev{};
+                        ev.events = EPOLLIN | EPOLLOUT;
+                        ev.data.fd = fd;
+                        epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, fd, &ev);
+                        return true;
+                    }
+                    closeConnection(worker, fd);
+                    return false;
+                }
+                conn.outPos += static_cast<size_t>(n);
+            }
+
+            conn.out.clear();
+            conn.outPos = 0;
+            if (conn.closeAfterWrite)
+            {
+                closeConnection(worker, fd);
+                return false;
+            }
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = fd;
+            epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, fd, &ev);
+            return true;
+        }
+
+        // Parse every complete request in the input buffer and queue responses
+        void processInput(ServerImpl& server, Connection& conn)
+        {
+            while (!conn.closeAfterWrite)
+            {
+                size_t headerEnd = conn.in.find("\r\n\r\n");
+                if (headerEnd == std::string::npos)
+                {
+                    if (conn.in.size() > MAX_HEADER_BYTES)
+                    {
+                        conn.out += buildResponse(431, errorBody("Header too large"), false);
+                        conn.closeAfterWrite = true;
+                    }
+                    return;
+                }
+
+                std::istringstream head(conn.in.substr(0, headerEnd));
+                std::string method, target, version, line;
+                head >> method >> target >> version;
+                std::getline(head, line);
+
+                size_t contentLength = 0;
+                bool keepAlive = version == "HTTP/1.1";
+                while (std::getline(head, line))
+                {
+                    size_t colon = line.find(':');
+                    if (colon == std::string::npos) continue;
+                    std::string name = toLower(line.substr(0, colon));
+                    std::string value = line.substr(colon + 1);
+                    value.erase(0, value.find_first_not_of(" \t"));
+                    value.erase(value.find_last_not_of(" \t\r") + 1);
+
+                    if (name == "content-length")
+                    {
+                        contentLength = std::strtoul(value.c_str(), nullptr, 10);
+                    }
+                    else if (name == "connection")
+                    {
+                        std::string v = toLower(value);
+                        if (v == "close") keepAlive = false;
+                        else if (v == "keep-alive") keepAlive = true;
+                    }
+                }
+
+                if (method.empty() || target.empty())
+                {
+                    conn.out += buildResponse(400, errorBody("Malformed request line"), false);
+                    conn.closeAfterWrite = true;
+                    return;
+                }
+
+                if (contentLength > MAX_BODY_BYTES)
+                {
+                    conn.out += buildResponse(413, errorBody("Body too large"), false);
+                    conn.closeAfterWrite = true;
+                    return;
+                }
+
+                size_t total = headerEnd + 4 + contentLength;
+                if (conn.in.size() < total)
+                {
+                    return;  // Wait for the rest of the body
+                }
+
+                std::string body = conn.in.substr(headerEnd + 4, contentLength);
+                conn.in.erase(0, total);
+
+                std::string path = target.substr(0, target.find('?'));
+                std::string response;
+                int status = dispatch(server, method, path, body, response);
+                server.requests++;
+
+                conn.out += buildResponse(status, response, keepAlive);
+                if (!keepAlive)
+                {
+                    conn.closeAfterWrite = true;
+                }
+            }
+        }
+
+        void acceptAll(Worker& worker)
+        {
+            while (true)
+            {
+                int fd = accept4(worker.listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (fd < 0)
+                {
+                    return;  // EAGAIN: backlog drained (or another worker won the race)
+                }
+
+                int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+                epoll_event ev{};
+                ev.events = EPOLLIN;
+                ev.data.fd = fd;
+                if (epoll_ctl(worker.epollFd, EPOLL_CTL_ADD, fd, &ev) != 0)
+                {
+                    close(fd);
+                    continue;
+                }
+                worker.connections[fd];
+            }
+        }
+
+        void workerLoop(ServerImpl& server, Worker& worker)
+        {
+            epoll_event events[64];
+            char buffer[16 * 1024];
+
+            while (!server.stopping)
+            {
+                int n = epoll_wait(worker.epollFd, events, 64, -1);
+                for (int i = 0; i < n; ++i)
+                {
+                    int fd = events[i].data.fd;
+                    if (fd == worker.wakeFd)
+                    {
+                        continue;
+                    }
+                    if (fd == worker.listenFd)
+                    {
+                        acceptAll(worker);
+                        continue;
+                    }
+
+                    auto it = worker.connections.find(fd);
+                    if (it == worker.connections.end())
+                    {
+                        continue;
+                    }
+                    Connection& conn = it->second;
+
+                    if (events[i].events & (EPOLLERR | EPOLLHUP))
+                    {
+                        closeConnection(worker, fd);
+                        continue;
+                    }
+
+                    if (events[i].events & EPOLLOUT)
+                    {
+                        if (!flush(worker, fd, conn)) continue;
+                    }
+
+                    if (events[i].events & EPOLLIN)
+                    {
+                        bool peerClosed = false;
+                        while (true)
+                        {
+                            ssize_t r = recv(fd, buffer, sizeof(buffer), 0);
+                            if (r > 0)
+                            {
+                                conn.in.append(buffer, static_cast<size_t>(r));
+                                continue;
+                            }
+                            peerClosed = (r == 0) || (errno != EAGAIN && errno != EWOULDBLOCK);
+                            break;
+                        }
+
+                        processInput(server, conn);
+                        if (!conn.out.empty())
+                        {
+                            if (!flush(worker, fd, conn)) continue;
+                        }
+                        if (peerClosed)
+                        {
+                            closeConnection(worker, fd);
+                        }
+                    }
+                }
+            }
+
+            for (auto& entry : worker.connections)
+            {
+                close(entry.first);
+            }
+            worker.connections.clear();
+        }
+
+        int openListener(const std::string& address, int port)
+        {
+            int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+            if (fd < 0) return -1;
+
+            int one = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(port));
+            if (inet_pton(AF_INET, address.c_str(), &addr.sin_addr) != 1 ||
+                bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+                listen(fd, SOMAXCONN) != 0)
+            {
+                close(fd);
+                return -1;
+            }
+            return fd;
+        }
+#endif
+    } // namespace
+
+    APIServer::APIServer()
+        : m_port(0)
+        , m_running(false)
+        , m_server(new ServerImpl())
+    {
+    }
+
+    APIServer::~APIServer()
+    {
+        stop();
+        delete static_cast<ServerImpl*>(m_server);
+    }
+
+    APIServer& APIServer::getInstance()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_instance == nullptr)
+        {
+            s_instance = std::unique_ptr<APIServer>(new APIServer());
+        }
+        return *s_instance;
+    }
+
+    bool APIServer::start(int port)
+    {
+        return start(port, "127.0.0.1");
+    }
+
+    bool APIServer::start(int port, const std::string& bindAddress, int threads)
+    {
+#ifdef __linux__
+        if (m_running)
+        {
+            return true;
+        }
+
+        ServerImpl& server = impl(m_server);
+        server.stopping = false;
+        threads = std::max(threads, 1);
+
+        int boundPort = port;
+        for (int i = 0; i < threads; ++i)
+        {
+            auto worker = std::unique_ptr<Worker>(new Worker());
+            worker->listenFd = openListener(bindAddress, boundPort);
+            if (worker->listenFd < 0)
+            {
+                LOG_ERROR("API server failed to bind " + bindAddress + ":" + std::to_string(boundPort) +
+                          " - " + std::strerror(errno));
+                server.workers.push_back(std::move(worker));
+                stop();
+                return false;
+            }
+
+            // With port 0 the first bind picks the port; the rest must share it
+            if (boundPort == 0)
+            {
+                sockaddr_in addr{};
+                socklen_t len = sizeof(addr);
+                getsockname(worker->listenFd, reinterpret_cast<sockaddr*>(&addr), &len);
+                boundPort = ntohs(addr.sin_port);
+            }
+
+            worker->epollFd = epoll_create1(EPOLL_CLOEXEC);
+            worker->wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.fd = worker->listenFd;
+            epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, worker->listenFd, &ev);
+            ev.data.fd = worker->wakeFd;
+            epoll_ctl(worker->epollFd, EPOLL_CTL_ADD, worker->wakeFd, &ev);
+
+            server.workers.push_back(std::move(worker));
+        }
+
+        for (auto& worker : server.workers)
+        {
+            Worker* w = worker.get();
+            w->thread = std::thread([&server, w]() { workerLoop(server, *w); });
+        }
+        server.executor = std::thread([&server]() { executorLoop(server); });
+
+        m_port = boundPort;
+        m_running = true;
+        LOG_INFO("API server listening on " + bindAddress + ":" + std::to_string(m_port) +
+                 " with " + std::to_string(threads) + " worker thread(s)");
+        return true;
+#else
+        (void)port;
+        (void)bindAddress;
+        (void)threads;
+        LOG_ERROR("The embedded API server requires Linux (epoll)");
+        return false;
+#endif
+    }
+
+    void APIServer::stop()
+    {
+#ifdef __linux__
+        ServerImpl& server = impl(m_server);
+        if (server.workers.empty())
+        {
+            return;
+        }
+
+        server.stopping = true;
+        for (auto& worker : server.workers)
+        {
+            if (worker->wakeFd >= 0)
+            {
+                uint64_t one = 1;
+                if (write(worker->wakeFd, &one, sizeof(one)) < 0)
+                {
+                    LOG_WARN("Failed to wake API server worker");
+                }
+            }
+        }
+
+        for (auto& worker : server.workers)
+        {
+            if (worker->thread.joinable()) worker->thread.join();
+            if (worker->listenFd >= 0) close(worker->listenFd);
+            if (worker->epollFd >= 0) close(worker->epollFd);
+            if (worker->wakeFd >= 0) close(worker->wakeFd);
+        }
+        server.workers.clear();
+
+        // Wakes the executor; a job still running finishes first
+        {
+            std::lock_guard<std::mutex> lock(server.jobMutex);
+        }
+        server.jobReady.notify_all();
+        if (server.executor.joinable()) server.executor.join();
+
+        if (m_running)
+        {
+            LOG_INFO("API server stopped");
+        }
+#endif
+        m_running = false;
+    }
+
+    void APIServer::publish(const std::string& path, const std::string& json)
+    {
+        auto doc = std::make_shared<const std::string>(json);
+        ServerImpl& server = impl(m_server);
+        std::lock_guard<std::mutex> lock(server.routeMutex);
+        server.documents[path] = std::move(doc);
+    }
+
+    void APIServer::addRoute(const std::string& method, const std::string& path, RouteHandler handler)
+    {
+        ServerImpl& server = impl(m_server);
+        std::lock_guard<std::mutex> lock(server.routeMutex);
+        server.routes[method + " " + path] = std::move(handler);
+    }
+
+    void APIServer::addJob(const std::string& method, const std::string& path, RouteHandler handler)
+    {
+        ServerImpl& server = impl(m_server);
+        std::lock_guard<std::mutex> lock(server.routeMutex);
+        server.jobs[method + " " + path] = std::move(handler);
+    }
+
+    bool APIServer::isJobRunning() const
+    {
+        return impl(m_server).jobRunning;
+    }
+
+    std::string APIServer::getStatus() const
+    {
+        ServerImpl& server = impl(m_server);
+        std::ostringstream ss;
+        ss << "{\"running\":" << (m_running ? "true" : "false")
+           << ",\"port\":" << m_port
+           << ",\"threads\":" << server.workers.size()
+           << ",\"job_running\":" << (server.jobRunning ? "true" : "false")
+           << ",\"requests_served\":" << server.requests.load() << "}";
+        return ss.str();
+    }
+} // namespace seneca
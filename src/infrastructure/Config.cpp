@@ -2,6 +2,13 @@
 #include "seneca/Logger.h"
 #include <algorithm>
 #include <cctype>
+#include <chrono>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <fcntl.h>
+#endif
 
 namespace seneca
 {
@@ -9,10 +16,19 @@ namespace seneca
     std::mutex Config::s_mutex;
 
     Config::Config()
-        : m_configFile("config.txt")
+        : m_snapshot(std::make_shared<const ConfigMap>())
+        , m_configFile("config.txt")
+        , m_nextSubscriberId(1)
+        , m_watching(false)
+        , m_wakeFd{-1, -1}
     {
     }
 
+    Config::~Config()
+    {
+        stopWatching();
+    }
+
     Config& Config::getInstance()
     {
         std::lock_guard<std::mutex> lock(s_mutex);
@@ -23,14 +39,12 @@ namespace seneca
         return *s_instance;
     }
 
-    bool Config::loadFromFile(const std::string& filename)
+    bool Config::parseFile(const std::string& filename, ConfigMap& out) const
     {
-        m_configFile = filename;
         std::ifstream file(filename);
-        
+
         if (!file.is_open())
         {
-            LOG_WARN("Configuration file not found: " + filename + " (using defaults)");
             return false;
         }
 
@@ -70,20 +84,110 @@ namespace seneca
 
             if (!key.empty())
             {
-                m_config[key] = value;
+                out[key] = value;
                 LOG_DEBUG("Loaded config: " + key + " = " + value);
             }
         }
 
         file.close();
+        return true;
+    }
+
+    bool Config::loadFromFile(const std::string& filename)
+    {
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            m_configFile = filename;
+        }
+
+        // Keys loaded earlier (or set programmatically) survive; the file overrides them
+        ConfigMap next = *snapshot();
+        if (!parseFile(filename, next))
+        {
+            LOG_WARN("Configuration file not found: " + filename + " (using defaults)");
+            return false;
+        }
+
+        publish(std::make_shared<const ConfigMap>(std::move(next)));
         LOG_INFO("Configuration loaded from: " + filename);
         return true;
     }
 
+    bool Config::reload()
+    {
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        std::string filename;
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            filename = m_configFile;
+        }
+
+        // Unlike loadFromFile, a reload starts from an empty map so keys
+        // deleted from the file disappear from the new snapshot
+        ConfigMap next;
+        if (!parseFile(filename, next))
+        {
+            LOG_WARN("Configuration reload failed, keeping previous settings: " + filename);
+            return false;
+        }
+
+        publish(std::make_shared<const ConfigMap>(std::move(next)));
+        LOG_INFO("Configuration reloaded from: " + filename);
+        return true;
+    }
+
+    ConfigSnapshot Config::snapshot() const
+    {
+        std::lock_guard<std::mutex> lock(m_dataMutex);
+        return m_snapshot;
+    }
+
+    void Config::publish(ConfigSnapshot next)
+    {
+        ConfigSnapshot previous;
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            previous = m_snapshot;
+            m_snapshot = next;
+        }
+
+        std::vector<Subscriber> subscribers;
+        {
+            std::lock_guard<std::mutex> lock(m_subscriberMutex);
+            subscribers = m_subscribers;
+        }
+
+        // Notify outside of both data locks so callbacks may read the config;
+        // the write lock keeps the next change waiting until they are done
+        for (const auto& sub : subscribers)
+        {
+            auto oldIt = previous->find(sub.key);
+            auto newIt = next->find(sub.key);
+            bool hadOld = oldIt != previous->end();
+            bool hasNew = newIt != next->end();
+
+            if (hadOld != hasNew || (hasNew && oldIt->second != newIt->second))
+            {
+                LOG_DEBUG("Config key changed: " + sub.key);
+                sub.callback(hasNew ? newIt->second : std::string());
+            }
+        }
+    }
+
+    void Config::update(const std::string& key, const std::string& value)
+    {
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        ConfigMap next = *snapshot();
+        next[key] = value;
+        publish(std::make_shared<const ConfigMap>(std::move(next)));
+    }
+
     std::string Config::getString(const std::string& key, const std::string& defaultValue) const
     {
-        auto it = m_config.find(key);
-        if (it != m_config.end())
+        ConfigSnapshot config = snapshot();
+        auto it = config->find(key);
+        if (it != config->end())
         {
             return it->second;
         }
@@ -92,8 +196,9 @@ namespace seneca
 
     int Config::getInt(const std::string& key, int defaultValue) const
     {
-        auto it = m_config.find(key);
-        if (it != m_config.end())
+        ConfigSnapshot config = snapshot();
+        auto it = config->find(key);
+        if (it != config->end())
         {
             try
             {
@@ -109,28 +214,32 @@ namespace seneca
 
     bool Config::getBool(const std::string& key, bool defaultValue) const
     {
-        auto it = m_config.find(key);
-        if (it != m_config.end())
+        ConfigSnapshot config = snapshot();
+        auto it = config->find(key);
+        return it != config->end() ? parseBool(it->second, defaultValue) : defaultValue;
+    }
+
+    bool Config::parseBool(const std::string& text, bool defaultValue)
+    {
+        std::string value = text;
+        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+
+        if (value == "true" || value == "1" || value == "yes" || value == "on")
         {
-            std::string value = it->second;
-            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-            
-            if (value == "true" || value == "1" || value == "yes" || value == "on")
-            {
-                return true;
-            }
-            else if (value == "false" || value == "0" || value == "no" || value == "off")
-            {
-                return false;
-            }
+            return true;
+        }
+        else if (value == "false" || value == "0" || value == "no" || value == "off")
+        {
+            return false;
         }
         return defaultValue;
     }
 
     double Config::getDouble(const std::string& key, double defaultValue) const
     {
-        auto it = m_config.find(key);
-        if (it != m_config.end())
+        ConfigSnapshot config = snapshot();
+        auto it = config->find(key);
+        if (it != config->end())
         {
             try
             {
@@ -146,27 +255,32 @@ namespace seneca
 
     void Config::setString(const std::string& key, const std::string& value)
     {
-        m_config[key] = value;
+        update(key, value);
     }
 
     void Config::setInt(const std::string& key, int value)
     {
-        m_config[key] = std::to_string(value);
+        update(key, std::to_string(value));
     }
 
     void Config::setBool(const std::string& key, bool value)
     {
-        m_config[key] = value ? "true" : "false";
+        update(key, value ? "true" : "false");
     }
 
     void Config::setDouble(const std::string& key, double value)
     {
-        m_config[key] = std::to_string(value);
+        update(key, std::to_string(value));
     }
 
     bool Config::saveToFile(const std::string& filename) const
     {
-        std::string fileToWrite = filename.empty() ? m_configFile : filename;
+        std::string fileToWrite = filename;
+        if (fileToWrite.empty())
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            fileToWrite = m_configFile;
+        }
         std::ofstream file(fileToWrite);
         
         if (!file.is_open())
@@ -179,7 +293,7 @@ namespace seneca
         file << "# Format: key=value\n";
         file << "# Lines starting with # or ; are comments\n\n";
 
-        for (const auto& pair : m_config)
+        for (const auto& pair : *snapshot())
         {
             file << pair.first << "=" << pair.second << "\n";
         }
@@ -191,12 +305,139 @@ namespace seneca
 
     bool Config::hasKey(const std::string& key) const
     {
-        return m_config.find(key) != m_config.end();
+        ConfigSnapshot config = snapshot();
+        return config->find(key) != config->end();
     }
 
     void Config::clear()
     {
-        m_config.clear();
+        std::lock_guard<std::mutex> writeLock(m_writeMutex);
+        publish(std::make_shared<const ConfigMap>());
+    }
+
+    size_t Config::subscribe(const std::string& key, ConfigCallback callback)
+    {
+        std::lock_guard<std::mutex> lock(m_subscriberMutex);
+        size_t id = m_nextSubscriberId++;
+        m_subscribers.push_back({id, key, std::move(callback)});
+        return id;
+    }
+
+    void Config::unsubscribe(size_t id)
+    {
+        std::lock_guard<std::mutex> lock(m_subscriberMutex);
+        m_subscribers.erase(std::remove_if(m_subscribers.begin(), m_subscribers.end(),
+                                           [id](const Subscriber& sub) { return sub.id == id; }),
+                            m_subscribers.end());
+    }
+
+    bool Config::startWatching()
+    {
+#ifdef __linux__
+        if (m_watching)
+        {
+            return true;
+        }
+        stopWatching();  // Reap a watcher thread that exited on error
+
+        if (pipe2(m_wakeFd, O_CLOEXEC | O_NONBLOCK) != 0)
+        {
+            LOG_ERROR("Failed to create config watcher wake pipe");
+            return false;
+        }
+
+        m_watching = true;
+        m_watcher = std::thread(&Config::watchLoop, this);
+        return true;
+#else
+        LOG_WARN("Configuration hot reload is only supported on Linux");
+        return false;
+#endif
+    }
+
+    void Config::stopWatching()
+    {
+        if (!m_watcher.joinable())
+        {
+            return;
+        }
+
+        m_watching = false;
+        char byte = 0;
+        if (write(m_wakeFd[1], &byte, 1) < 0)
+        {
+            LOG_WARN("Failed to wake config watcher");
+        }
+
+        m_watcher.join();
+
+        close(m_wakeFd[0]);
+        close(m_wakeFd[1]);
+        m_wakeFd[0] = m_wakeFd[1] = -1;
+    }
+
+    void Config::watchLoop()
+    {
+#ifdef __linux__
+        std::string path;
+        {
+            std::lock_guard<std::mutex> lock(m_dataMutex);
+            path = m_configFile;
+        }
+
+        // Watch the directory rather than the file: editors usually save by
+        // writing a temporary file and renaming it over the original, which
+        // would silently drop a watch placed on the old inode
+        size_t slash = path.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path.substr(0, slash);
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0 || inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0)
+        {
+            LOG_ERROR("Failed to watch configuration directory: " + dir);
+            if (fd >= 0) close(fd);
+            m_watching = false;
+            return;
+        }
+
+        LOG_INFO("Watching configuration file for changes: " + path);
+
+        alignas(inotify_event) char buffer[4096];
+        while (m_watching)
+        {
+            pollfd fds[2] = {{fd, POLLIN, 0}, {m_wakeFd[0], POLLIN, 0}};
+            if (poll(fds, 2, -1) < 0 || (fds[1].revents & POLLIN))
+            {
+                continue;
+            }
+
+            bool changed = false;
+            ssize_t len;
+            while ((len = read(fd, buffer, sizeof(buffer))) > 0)
+            {
+                for (char* p = buffer; p < buffer + len;)
+                {
+                    auto* event = reinterpret_cast<inotify_event*>(p);
+                    if (event->len > 0 && name == event->name)
+                    {
+                        changed = true;
+                    }
+                    p += sizeof(inotify_event) + event->len;
+                }
+            }
+
+            if (changed)
+            {
+                // Let a burst of writes from the editor settle before re-reading
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                while (read(fd, buffer, sizeof(buffer)) > 0) {}
+                reload();
+            }
+        }
+
+        close(fd);
+#endif
     }
 } // namespace seneca
 
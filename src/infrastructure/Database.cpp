@@ -1,4 +1,5 @@
 #include "seneca/Database.h"
+#include "seneca/LatencyHistogram.h"
 #include "seneca/Logger.h"
 #include "seneca/Exceptions.h"
 #include <sqlite3.h>
@@ -7,8 +8,12 @@
 #include <ctime>
 #include <chrono>
 #include <algorithm>
+#include <atomic>
+#include <cctype>
 #include <unistd.h>
 #include <limits.h>
+#include <sys/stat.h>
+#include <cerrno>
 #ifdef __APPLE__
 #include <mach-o/dyld.h>
 #endif
@@ -18,6 +23,23 @@ namespace seneca
     std::unique_ptr<Database> Database::s_instance = nullptr;
     std::mutex Database::s_mutex;
 
+    // Equivalent of "mkdir -p" without spawning a shell
+    static bool makeDirectories(const std::string& dir)
+    {
+        for (size_t pos = dir.find('/', 1); ; pos = dir.find('/', pos + 1))
+        {
+            std::string prefix = dir.substr(0, pos);
+            if (!prefix.empty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+            {
+                return false;
+            }
+            if (pos == std::string::npos)
+            {
+                return true;
+            }
+        }
+    }
+
     Database::Database()
         : m_db(nullptr)
         , m_dbPath("")  // Will be set by initialize
@@ -109,8 +131,10 @@ namespace seneca
         if (lastSlash != std::string::npos)
         {
             std::string dir = m_dbPath.substr(0, lastSlash);
-            std::string cmd = "mkdir -p \"" + dir + "\"";
-            system(cmd.c_str());
+            if (!makeDirectories(dir))
+            {
+                LOG_WARN("Failed to create database directory: " + dir);
+            }
         }
 
         int rc = sqlite3_open(m_dbPath.c_str(), &m_db);
@@ -173,6 +197,23 @@ namespace seneca
             )
         )";
 
+        std::string createLatencyTable = R"(
+            CREATE TABLE IF NOT EXISTS latency_history (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                product TEXT NOT NULL,
+                is_completed INTEGER NOT NULL DEFAULT 0,
+                metric TEXT NOT NULL,
+                order_count INTEGER NOT NULL DEFAULT 0,
+                mean REAL NOT NULL DEFAULT 0,
+                p50 INTEGER NOT NULL DEFAULT 0,
+                p90 INTEGER NOT NULL DEFAULT 0,
+                p99 INTEGER NOT NULL DEFAULT 0,
+                p999 INTEGER NOT NULL DEFAULT 0,
+                max_value INTEGER NOT NULL DEFAULT 0,
+                timestamp TEXT NOT NULL
+            )
+        )";
+
         std::string createIndex1 = "CREATE INDEX IF NOT EXISTS idx_orders_customer ON orders(customer_name)";
         std::string createIndex2 = "CREATE INDEX IF NOT EXISTS idx_orders_completed ON orders(is_completed)";
         std::string createIndex3 = "CREATE INDEX IF NOT EXISTS idx_stations_name ON station_history(station_name)";
@@ -193,19 +234,76 @@ namespace seneca
             return false;
         }
 
+        if (sqlite3_exec(m_db, createLatencyTable.c_str(), nullptr, nullptr, &errMsg) != SQLITE_OK)
+        {
+            m_lastError = errMsg ? errMsg : "Unknown error";
+            sqlite3_free(errMsg);
+            return false;
+        }
+
         sqlite3_exec(m_db, createIndex1.c_str(), nullptr, nullptr, nullptr);
         sqlite3_exec(m_db, createIndex2.c_str(), nullptr, nullptr, nullptr);
         sqlite3_exec(m_db, createIndex3.c_str(), nullptr, nullptr, nullptr);
 
+        // Station counter columns were added after the first release; append
+        // them to existing databases so column positions stay stable
+        static const char* stationColumns[][2] = {
+            {"failed_fills", "INTEGER NOT NULL DEFAULT 0"},
+            {"orders_passed", "INTEGER NOT NULL DEFAULT 0"},
+            {"max_queue_depth", "INTEGER NOT NULL DEFAULT 0"},
+            {"mean_queue_depth", "REAL NOT NULL DEFAULT 0"},
+            {"busy_ticks", "INTEGER NOT NULL DEFAULT 0"},
+            {"idle_ticks", "INTEGER NOT NULL DEFAULT 0"},
+        };
+        for (const auto& column : stationColumns)
+        {
+            if (!ensureColumn("station_history", column[0], column[1]))
+            {
+                return false;
+            }
+        }
+
         return true;
     }
 
+    bool Database::ensureColumn(const std::string& table, const std::string& column, const std::string& definition)
+    {
+        sqlite3_stmt* stmt;
+        std::string query = "PRAGMA table_info(" + table + ")";
+        if (sqlite3_prepare_v2(m_db, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            m_lastError = sqlite3_errmsg(m_db);
+            return false;
+        }
+
+        bool exists = false;
+        while (sqlite3_step(stmt) == SQLITE_ROW)
+        {
+            const unsigned char* name = sqlite3_column_text(stmt, 1);
+            if (name && column == reinterpret_cast<const char*>(name))
+            {
+                exists = true;
+                break;
+            }
+        }
+        sqlite3_finalize(stmt);
+
+        if (exists)
+        {
+            return true;
+        }
+
+        LOG_INFO("Adding column " + table + "." + column);
+        return executeQuery("ALTER TABLE " + table + " ADD COLUMN " + column + " " + definition);
+    }
+
     bool Database::dropSchema()
     {
         if (!m_db) return false;
 
         std::string dropOrders = "DROP TABLE IF EXISTS orders";
         std::string dropStations = "DROP TABLE IF EXISTS station_history";
+        std::string dropLatency = "DROP TABLE IF EXISTS latency_history";
 
         char* errMsg = nullptr;
         sqlite3_exec(m_db, dropOrders.c_str(), nullptr, nullptr, &errMsg);
@@ -214,6 +312,9 @@ namespace seneca
         sqlite3_exec(m_db, dropStations.c_str(), nullptr, nullptr, &errMsg);
         if (errMsg) sqlite3_free(errMsg);
 
+        sqlite3_exec(m_db, dropLatency.c_str(), nullptr, nullptr, &errMsg);
+        if (errMsg) sqlite3_free(errMsg);
+
         return createSchema();
     }
 
@@ -226,23 +327,12 @@ namespace seneca
         return ss.str();
     }
 
-    bool Database::saveOrder(const OrderRecord& order)
-    {
-        if (!m_db) return false;
-
-        std::stringstream ss;
-        // Use INSERT OR IGNORE to prevent duplicates, or just INSERT for new entries
-        // Since order_id should be unique, we'll use INSERT (not REPLACE) to allow multiple runs
-        ss << "INSERT INTO orders (order_id, customer_name, product, is_completed, "
-           << "total_items, filled_items, created_at, completed_at) VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
-
-        sqlite3_stmt* stmt;
-        if (sqlite3_prepare_v2(m_db, ss.str().c_str(), -1, &stmt, nullptr) != SQLITE_OK)
-        {
-            m_lastError = sqlite3_errmsg(m_db);
-            return false;
-        }
+    static const char* INSERT_ORDER_SQL =
+        "INSERT INTO orders (order_id, customer_name, product, is_completed, "
+        "total_items, filled_items, created_at, completed_at) VALUES (?, ?, ?, ?, ?, ?, ?, ?)";
 
+    bool Database::insertOrder(sqlite3_stmt* stmt, const OrderRecord& order, const std::string& completedAt)
+    {
         sqlite3_bind_text(stmt, 1, order.orderId.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_text(stmt, 2, order.customerName.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_text(stmt, 3, order.product.c_str(), -1, SQLITE_STATIC);
@@ -250,9 +340,7 @@ namespace seneca
         sqlite3_bind_int(stmt, 5, static_cast<int>(order.totalItems));
         sqlite3_bind_int(stmt, 6, static_cast<int>(order.filledItems));
         sqlite3_bind_text(stmt, 7, order.timestamp.c_str(), -1, SQLITE_STATIC);
-        
-        std::string completedAt = order.isCompleted ? getCurrentTimestamp() : "";
-        sqlite3_bind_text(stmt, 8, completedAt.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 8, order.isCompleted ? completedAt.c_str() : "", -1, SQLITE_STATIC);
 
         int stepResult = sqlite3_step(stmt);
         bool success = (stepResult == SQLITE_DONE);
@@ -272,37 +360,98 @@ namespace seneca
         {
             LOG_DEBUG("Order saved: " + order.customerName + " - " + order.product);
         }
-        
+
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        return success;
+    }
+
+    bool Database::saveOrder(const OrderRecord& order)
+    {
+        if (!m_db) return false;
+
+        // Use INSERT (not REPLACE): order_id is unique per run, so repeated runs add rows
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, INSERT_ORDER_SQL, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            m_lastError = sqlite3_errmsg(m_db);
+            return false;
+        }
+
+        bool success = insertOrder(stmt, order, getCurrentTimestamp());
         sqlite3_finalize(stmt);
         return success;
     }
 
-    bool Database::saveOrderCompletion(const std::string& customerName,
-                                       const std::string& product,
-                                       bool completed,
-                                       size_t filledItems,
-                                       size_t totalItems)
+    size_t Database::saveOrders(const std::vector<OrderRecord>& orders)
+    {
+        if (!m_db || orders.empty()) return 0;
+
+        // One transaction and one prepared statement for the whole batch:
+        // without the transaction SQLite syncs the journal once per row
+        if (!executeQuery("BEGIN TRANSACTION"))
+        {
+            return 0;
+        }
+
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, INSERT_ORDER_SQL, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            m_lastError = sqlite3_errmsg(m_db);
+            executeQuery("ROLLBACK");
+            return 0;
+        }
+
+        std::string completedAt = getCurrentTimestamp();
+        size_t saved = 0;
+        for (const auto& order : orders)
+        {
+            if (insertOrder(stmt, order, completedAt))
+            {
+                saved++;
+            }
+        }
+        sqlite3_finalize(stmt);
+
+        if (!executeQuery("COMMIT"))
+        {
+            LOG_ERROR("Failed to commit order batch: " + m_lastError);
+            executeQuery("ROLLBACK");
+            return 0;
+        }
+        return saved;
+    }
+
+    OrderRecord Database::makeOrderRecord(const std::string& customerName,
+                                          const std::string& product,
+                                          bool completed,
+                                          size_t filledItems,
+                                          size_t totalItems)
     {
+        static std::atomic<unsigned long long> sequence{0};
+
         OrderRecord record;
         record.customerName = customerName;
         record.product = product;
-        // Generate unique order_id with high-precision timestamp + random component
-        auto now = std::chrono::system_clock::now();
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()).count();
-        auto us = std::chrono::duration_cast<std::chrono::microseconds>(
-            now.time_since_epoch()).count();
-        // Add nanoseconds for extra uniqueness and a small random component
+        // Unique order_id: nanosecond timestamp plus a per-process sequence,
+        // so records created in the same clock tick still differ
         auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-            now.time_since_epoch()).count();
-        // Use nanoseconds + microseconds to ensure uniqueness even in rapid succession
-        record.orderId = customerName + "_" + product + "_" + std::to_string(ns) + "_" + std::to_string(us);
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record.orderId = customerName + "_" + product + "_" + std::to_string(ns) + "_" + std::to_string(sequence++);
         record.isCompleted = completed;
         record.filledItems = filledItems;
         record.totalItems = totalItems;
         record.timestamp = getCurrentTimestamp();
+        return record;
+    }
 
-        return saveOrder(record);
+    bool Database::saveOrderCompletion(const std::string& customerName,
+                                       const std::string& product,
+                                       bool completed,
+                                       size_t filledItems,
+                                       size_t totalItems)
+    {
+        return saveOrder(makeOrderRecord(customerName, product, completed, filledItems, totalItems));
     }
 
     static int orderCallback(void* data, int argc, char** argv, char** colNames)
@@ -410,8 +559,9 @@ namespace seneca
         if (!m_db) return false;
 
         std::stringstream ss;
-        ss << "INSERT INTO station_history (station_name, items_processed, inventory_remaining, timestamp) "
-           << "VALUES (?, ?, ?, ?)";
+        ss << "INSERT INTO station_history (station_name, items_processed, inventory_remaining, timestamp, "
+           << "failed_fills, orders_passed, max_queue_depth, mean_queue_depth, busy_ticks, idle_ticks) "
+           << "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
 
         sqlite3_stmt* stmt;
         if (sqlite3_prepare_v2(m_db, ss.str().c_str(), -1, &stmt, nullptr) != SQLITE_OK)
@@ -427,6 +577,12 @@ namespace seneca
         // Use provided timestamp or generate current one
         std::string timestamp = station.timestamp.empty() ? getCurrentTimestamp() : station.timestamp;
         sqlite3_bind_text(stmt, 4, timestamp.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_int64(stmt, 5, static_cast<sqlite3_int64>(station.failedFills));
+        sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(station.ordersPassed));
+        sqlite3_bind_int64(stmt, 7, static_cast<sqlite3_int64>(station.maxQueueDepth));
+        sqlite3_bind_double(stmt, 8, station.meanQueueDepth);
+        sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(station.busyTicks));
+        sqlite3_bind_int64(stmt, 10, static_cast<sqlite3_int64>(station.idleTicks));
 
         bool success = (sqlite3_step(stmt) == SQLITE_DONE);
         if (!success)
@@ -438,6 +594,64 @@ namespace seneca
         return success;
     }
 
+    size_t Database::saveLatencySummaries(const std::vector<LatencySummary>& summaries)
+    {
+        if (!m_db || summaries.empty()) return 0;
+
+        if (!executeQuery("BEGIN TRANSACTION"))
+        {
+            return 0;
+        }
+
+        const char* sql =
+            "INSERT INTO latency_history (product, is_completed, metric, order_count, mean, "
+            "p50, p90, p99, p999, max_value, timestamp) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)";
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(m_db, sql, -1, &stmt, nullptr) != SQLITE_OK)
+        {
+            m_lastError = sqlite3_errmsg(m_db);
+            executeQuery("ROLLBACK");
+            return 0;
+        }
+
+        std::string timestamp = getCurrentTimestamp();
+        size_t saved = 0;
+        for (const auto& s : summaries)
+        {
+            sqlite3_bind_text(stmt, 1, s.m_product.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int(stmt, 2, s.m_completed ? 1 : 0);
+            sqlite3_bind_text(stmt, 3, s.m_metric.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_int64(stmt, 4, static_cast<sqlite3_int64>(s.m_count));
+            sqlite3_bind_double(stmt, 5, s.m_mean);
+            sqlite3_bind_int64(stmt, 6, static_cast<sqlite3_int64>(s.m_p50));
+            sqlite3_bind_int64(stmt, 7, static_cast<sqlite3_int64>(s.m_p90));
+            sqlite3_bind_int64(stmt, 8, static_cast<sqlite3_int64>(s.m_p99));
+            sqlite3_bind_int64(stmt, 9, static_cast<sqlite3_int64>(s.m_p999));
+            sqlite3_bind_int64(stmt, 10, static_cast<sqlite3_int64>(s.m_max));
+            sqlite3_bind_text(stmt, 11, timestamp.c_str(), -1, SQLITE_STATIC);
+
+            if (sqlite3_step(stmt) == SQLITE_DONE)
+            {
+                saved++;
+            }
+            else
+            {
+                m_lastError = sqlite3_errmsg(m_db);
+                LOG_ERROR("Failed to save latency summary: " + m_lastError);
+            }
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+        }
+        sqlite3_finalize(stmt);
+
+        if (!executeQuery("COMMIT"))
+        {
+            executeQuery("ROLLBACK");
+            return 0;
+        }
+        return saved;
+    }
+
     bool Database::updateStationInventory(const std::string& stationName, size_t inventory)
     {
         StationRecord record;
@@ -469,6 +683,12 @@ namespace seneca
                 record.itemsProcessed = sqlite3_column_int(stmt, 2);
                 record.inventoryRemaining = sqlite3_column_int(stmt, 3);
                 record.timestamp = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
+                record.failedFills = static_cast<size_t>(sqlite3_column_int64(stmt, 5));
+                record.ordersPassed = static_cast<size_t>(sqlite3_column_int64(stmt, 6));
+                record.maxQueueDepth = static_cast<size_t>(sqlite3_column_int64(stmt, 7));
+                record.meanQueueDepth = sqlite3_column_double(stmt, 8);
+                record.busyTicks = static_cast<size_t>(sqlite3_column_int64(stmt, 9));
+                record.idleTicks = static_cast<size_t>(sqlite3_column_int64(stmt, 10));
                 records.push_back(record);
             }
             sqlite3_finalize(stmt);
@@ -601,6 +821,51 @@ namespace seneca
         return true;
     }
 
+    bool Database::setPragma(const std::string& name, const std::string& value)
+    {
+        if (!m_db) return false;
+
+        // PRAGMA arguments cannot be bound as parameters, so only accept
+        // plain identifiers and numbers to keep config values from injecting SQL
+        auto isPlain = [](const std::string& s)
+        {
+            return !s.empty() && std::all_of(s.begin(), s.end(), [](unsigned char c)
+                                             { return std::isalnum(c) || c == '_' || c == '-'; });
+        };
+        if (!isPlain(name) || !isPlain(value))
+        {
+            m_lastError = "Invalid pragma: " + name + "=" + value;
+            LOG_WARN(m_lastError);
+            return false;
+        }
+
+        bool success = executeQuery("PRAGMA " + name + " = " + value);
+        if (success)
+        {
+            LOG_INFO("Database pragma applied: " + name + " = " + value);
+        }
+        return success;
+    }
+
+    void Database::queuePragma(const std::string& name, const std::string& value)
+    {
+        std::lock_guard<std::mutex> lock(m_pragmaMutex);
+        m_queuedPragmas.emplace_back(name, value);
+    }
+
+    void Database::applyQueuedPragmas()
+    {
+        std::vector<std::pair<std::string, std::string>> pragmas;
+        {
+            std::lock_guard<std::mutex> lock(m_pragmaMutex);
+            pragmas.swap(m_queuedPragmas);
+        }
+        for (const auto& pragma : pragmas)
+        {
+            setPragma(pragma.first, pragma.second);
+        }
+    }
+
     std::string Database::getLastError() const
     {
         return m_lastError;
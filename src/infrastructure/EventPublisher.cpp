@@ -0,0 +1,323 @@
+#include "seneca/EventPublisher.h"
+#include "seneca/Logger.h"
+#include <vector>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace seneca
+{
+    std::unique_ptr<EventPublisher> EventPublisher::s_instance = nullptr;
+    std::mutex EventPublisher::s_mutex;
+
+    namespace
+    {
+        struct Client
+        {
+            int fd;
+            std::string pending;  // Unsent remainder of the current frame
+            size_t sent;
+            std::string next;     // Latest frame published while it drains
+        };
+
+        long long steadyNow()
+        {
+            return std::chrono::steady_clock::now().time_since_epoch().count();
+        }
+
+        // Sends the current frame, then the latest one queued behind it.
+        // Returns false if the client should be dropped.
+        bool sendPending(Client& client)
+        {
+            while (!client.pending.empty())
+            {
+                while (client.sent < client.pending.size())
+                {
+                    ssize_t n = send(client.fd, client.pending.data() + client.sent,
+                                     client.pending.size() - client.sent, MSG_NOSIGNAL);
+                    if (n < 0)
+                    {
+                        return errno == EAGAIN || errno == EWOULDBLOCK;
+                    }
+                    client.sent += static_cast<size_t>(n);
+                }
+                client.pending.swap(client.next);
+                client.next.clear();
+                client.sent = 0;
+            }
+            return true;
+        }
+
+        // A frame goes out after the one the client is draining; an older
+        // frame still waiting there is replaced, so a slow client skips
+        // frames but always ends up with the latest
+        void queueFrame(Client& client, const std::string& frame)
+        {
+            (client.pending.empty() ? client.pending : client.next) = frame;
+        }
+
+        // True if a server accepts connections on the socket file. One left
+        // behind by a crashed process refuses them and may be replaced.
+        bool socketInUse(const sockaddr_un& addr)
+        {
+            int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (probe < 0)
+            {
+                return false;
+            }
+            bool live = connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+            close(probe);
+            return live;
+        }
+    }
+
+    EventPublisher::EventPublisher()
+        : m_active(false)
+        , m_nextFrameDue(0)
+        , m_interval(0)
+        , m_framesPublished(0)
+        , m_framesCoalesced(0)
+        , m_listenFd(-1)
+        , m_wakeFd{-1, -1}
+    {
+    }
+
+    EventPublisher::~EventPublisher()
+    {
+        stop();
+    }
+
+    EventPublisher& EventPublisher::getInstance()
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_instance == nullptr)
+        {
+            s_instance = std::unique_ptr<EventPublisher>(new EventPublisher());
+        }
+        return *s_instance;
+    }
+
+    bool EventPublisher::start(const std::string& socketPath, double maxRateHz)
+    {
+        if (m_active)
+        {
+            return true;
+        }
+
+        sockaddr_un addr{};
+        if (socketPath.empty() || socketPath.size() >= sizeof(addr.sun_path))
+        {
+            LOG_ERROR("Invalid event stream socket path: " + socketPath);
+            return false;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (socketInUse(addr))
+        {
+            LOG_ERROR("Another process is already streaming events on " + socketPath);
+            return false;
+        }
+
+        // A stale socket file from a crashed process would make bind() fail
+        m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        unlink(socketPath.c_str());
+        if (m_listenFd < 0 ||
+            bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(m_listenFd, 16) != 0 ||
+            pipe(m_wakeFd) != 0)
+        {
+            LOG_ERROR("Failed to open event stream socket " + socketPath + ": " + std::strerror(errno));
+            if (m_listenFd >= 0) close(m_listenFd);
+            m_listenFd = -1;
+            return false;
+        }
+        fcntl(m_listenFd, F_SETFL, O_NONBLOCK);
+        fcntl(m_wakeFd[0], F_SETFL, O_NONBLOCK);
+        fcntl(m_wakeFd[1], F_SETFL, O_NONBLOCK);
+
+        auto interval = std::chrono::duration<double>(1.0 / (maxRateHz > 0 ? maxRateHz : 10.0));
+        m_interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(interval).count();
+        m_nextFrameDue = 0;
+        m_socketPath = socketPath;
+        m_active = true;
+        m_thread = std::thread(&EventPublisher::serveLoop, this);
+
+        LOG_INFO("Event stream listening on " + socketPath);
+        return true;
+    }
+
+    void EventPublisher::stop()
+    {
+        if (!m_thread.joinable())
+        {
+            return;
+        }
+
+        m_active = false;
+        wake();
+        m_thread.join();
+
+        close(m_listenFd);
+        close(m_wakeFd[0]);
+        close(m_wakeFd[1]);
+        m_listenFd = m_wakeFd[0] = m_wakeFd[1] = -1;
+        unlink(m_socketPath.c_str());
+        LOG_INFO("Event stream stopped (" + std::to_string(m_framesPublished.load()) + " frames published, " +
+                 std::to_string(m_framesCoalesced.load()) + " coalesced)");
+    }
+
+    bool EventPublisher::frameDue()
+    {
+        if (!m_active)
+        {
+            return false;
+        }
+
+        long long now = steadyNow();
+        long long due = m_nextFrameDue.load(std::memory_order_relaxed);
+        return now >= due &&
+               m_nextFrameDue.compare_exchange_strong(due, now + m_interval, std::memory_order_relaxed);
+    }
+
+    void EventPublisher::publish(const std::string& event, const std::string& json)
+    {
+        if (!m_active)
+        {
+            return;
+        }
+
+        std::string frame = "event: " + event + "\ndata: " + json + "\n\n";
+        {
+            std::lock_guard<std::mutex> lock(m_frameMutex);
+            if (!m_pendingFrame.empty())
+            {
+                m_framesCoalesced++;  // The sender has not picked up the previous one
+            }
+            m_pendingFrame = std::move(frame);
+        }
+        m_framesPublished++;
+        wake();
+    }
+
+    void EventPublisher::wake()
+    {
+        char byte = 0;
+        // A full pipe already guarantees a wake-up, so EAGAIN is fine
+        if (write(m_wakeFd[1], &byte, 1) < 0 && errno != EAGAIN)
+        {
+            LOG_WARN("Failed to wake event stream thread");
+        }
+    }
+
+    void EventPublisher::serveLoop()
+    {
+        std::vector<Client> clients;
+        std::vector<pollfd> fds;
+        char buffer[512];
+
+        while (m_active)
+        {
+            fds.clear();
+            fds.push_back({m_listenFd, POLLIN, 0});
+            fds.push_back({m_wakeFd[0], POLLIN, 0});
+            for (const auto& client : clients)
+            {
+                fds.push_back({client.fd, static_cast<short>(POLLIN | (client.pending.empty() ? 0 : POLLOUT)), 0});
+            }
+
+            if (poll(fds.data(), fds.size(), -1) < 0)
+            {
+                continue;
+            }
+
+            std::vector<bool> drop(clients.size(), false);
+            for (size_t i = 0; i < clients.size(); ++i)
+            {
+                short revents = fds[i + 2].revents;
+                if (revents & (POLLERR | POLLHUP | POLLNVAL))
+                {
+                    drop[i] = true;
+                }
+                else if (revents & POLLIN)
+                {
+                    // Clients only listen; a read of 0 means they hung up
+                    ssize_t n = recv(clients[i].fd, buffer, sizeof(buffer), 0);
+                    drop[i] = n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+                }
+                if (!drop[i] && (revents & POLLOUT))
+                {
+                    drop[i] = !sendPending(clients[i]);
+                }
+            }
+
+            if (fds[1].revents & POLLIN)
+            {
+                while (read(m_wakeFd[0], buffer, sizeof(buffer)) > 0) {}
+
+                std::string frame;
+                {
+                    std::lock_guard<std::mutex> lock(m_frameMutex);
+                    frame.swap(m_pendingFrame);
+                }
+
+                if (!frame.empty())
+                {
+                    for (size_t i = 0; i < clients.size(); ++i)
+                    {
+                        if (drop[i])
+                        {
+                            continue;
+                        }
+                        queueFrame(clients[i], frame);
+                        drop[i] = !sendPending(clients[i]);
+                    }
+                }
+            }
+
+            for (size_t i = clients.size(); i-- > 0;)
+            {
+                if (drop[i])
+                {
+                    close(clients[i].fd);
+                    clients.erase(clients.begin() + static_cast<long>(i));
+                }
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                int fd;
+                while ((fd = accept(m_listenFd, nullptr, nullptr)) >= 0)
+                {
+                    fcntl(fd, F_SETFL, O_NONBLOCK);
+                    clients.push_back({fd, std::string(), 0, std::string()});
+                    LOG_DEBUG("Event stream client connected");
+                }
+            }
+        }
+
+        // Best-effort delivery of the last frame (usually the end-of-run summary)
+        std::string frame;
+        {
+            std::lock_guard<std::mutex> lock(m_frameMutex);
+            frame.swap(m_pendingFrame);
+        }
+        for (auto& client : clients)
+        {
+            if (!frame.empty())
+            {
+                queueFrame(client, frame);
+            }
+            sendPending(client);
+            close(client.fd);
+        }
+    }
+} // namespace seneca
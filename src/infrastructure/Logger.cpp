@@ -40,6 +40,15 @@ namespace seneca
         m_level = level;
     }
 
+    LogLevel Logger::parseLogLevel(const std::string& level)
+    {
+        if (level == "DEBUG") return LogLevel::DEBUG;
+        if (level == "WARN") return LogLevel::WARN;
+        if (level == "ERROR") return LogLevel::ERROR;
+        if (level == "NONE") return LogLevel::NONE;
+        return LogLevel::INFO;
+    }
+
     void Logger::setLogFile(const std::string& filename)
     {
         m_logFile = filename;
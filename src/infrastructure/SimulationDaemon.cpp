@@ -0,0 +1,212 @@
+#include "seneca/SimulationDaemon.h"
+#include "seneca/Logger.h"
+#include "seneca/Utilities.h"
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+
+namespace seneca
+{
+    namespace
+    {
+        volatile std::sig_atomic_t s_stopRequested = 0;
+
+        void handleStopSignal(int)
+        {
+            s_stopRequested = 1;
+        }
+
+        const size_t MAX_COMMAND_BYTES = 64 * 1024;
+
+        // True if a server accepts connections on the socket file. One left
+        // behind by a crashed process refuses them and may be replaced.
+        bool socketInUse(const sockaddr_un& addr)
+        {
+            int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (probe < 0)
+            {
+                return false;
+            }
+            bool live = connect(probe, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) == 0;
+            close(probe);
+            return live;
+        }
+    }
+
+    SimulationDaemon::SimulationDaemon(const std::string& socketPath, DaemonHandler handler, int commandTimeoutMs)
+        : m_socketPath(socketPath)
+        , m_handler(std::move(handler))
+        , m_listenFd(-1)
+        , m_commandTimeoutMs(commandTimeoutMs)
+    {
+    }
+
+    SimulationDaemon::~SimulationDaemon()
+    {
+        if (m_listenFd >= 0)
+        {
+            close(m_listenFd);
+            unlink(m_socketPath.c_str());
+        }
+    }
+
+    bool SimulationDaemon::run()
+    {
+        sockaddr_un addr{};
+        if (m_socketPath.size() >= sizeof(addr.sun_path))
+        {
+            LOG_ERROR("Daemon socket path too long: " + m_socketPath);
+            return false;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, m_socketPath.c_str(), sizeof(addr.sun_path) - 1);
+        if (socketInUse(addr))
+        {
+            LOG_ERROR("Another daemon is already listening on " + m_socketPath);
+            return false;
+        }
+
+        m_listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (m_listenFd < 0)
+        {
+            LOG_ERROR("Failed to create daemon socket: " + std::string(std::strerror(errno)));
+            return false;
+        }
+
+        // A stale socket file from a crashed daemon would make bind() fail
+        unlink(m_socketPath.c_str());
+        if (bind(m_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(m_listenFd, 16) != 0)
+        {
+            LOG_ERROR("Failed to bind daemon socket " + m_socketPath + ": " + std::strerror(errno));
+            close(m_listenFd);
+            m_listenFd = -1;
+            return false;
+        }
+
+        struct sigaction action{};
+        action.sa_handler = handleStopSignal;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+        signal(SIGPIPE, SIG_IGN);
+
+        LOG_INFO("Simulation daemon listening on " + m_socketPath);
+
+        bool running = true;
+        while (running && !s_stopRequested)
+        {
+            // Poll with a timeout so a signal arriving between the flag check
+            // and the wait cannot leave the daemon blocked forever
+            pollfd pfd{m_listenFd, POLLIN, 0};
+            if (poll(&pfd, 1, 250) <= 0)
+            {
+                continue;
+            }
+
+            int client = accept(m_listenFd, nullptr, nullptr);
+            if (client < 0)
+            {
+                continue;
+            }
+            running = serveClient(client);
+            close(client);
+        }
+
+        LOG_INFO("Simulation daemon shutting down");
+        return true;
+    }
+
+    bool SimulationDaemon::serveClient(int fd)
+    {
+        // The whole command has to arrive by the deadline
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_commandTimeoutMs);
+        timeval sendTimeout{m_commandTimeoutMs / 1000, (m_commandTimeoutMs % 1000) * 1000};
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+        std::string request;
+        char buffer[4096];
+        while (request.find('\n') == std::string::npos && request.size() < MAX_COMMAND_BYTES)
+        {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            pollfd pfd{fd, POLLIN, 0};
+            int ready = left.count() > 0 ? poll(&pfd, 1, int(left.count())) : 0;
+            if (ready < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (ready <= 0)
+            {
+                LOG_WARN("Daemon client sent no complete command within " + std::to_string(m_commandTimeoutMs) +
+                         " ms; dropped");
+                return true;
+            }
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n <= 0)
+            {
+                break;
+            }
+            request.append(buffer, static_cast<size_t>(n));
+        }
+        request = request.substr(0, request.find('\n'));
+
+        // Words are separated by whitespace; a word in double quotes may
+        // contain spaces (and \" or \\ escapes)
+        std::istringstream words(request);
+        std::vector<std::string> command;
+        for (std::string word; words >> std::quoted(word);)
+        {
+            command.push_back(word);
+        }
+
+        bool keepRunning = true;
+        std::string response;
+        if (command.empty())
+        {
+            response = "{\"status\":\"error\",\"detail\":\"empty command\"}";
+        }
+        else if (command[0] == "ping")
+        {
+            response = "{\"status\":\"ok\"}";
+        }
+        else if (command[0] == "shutdown")
+        {
+            response = "{\"status\":\"ok\"}";
+            keepRunning = false;
+        }
+        else
+        {
+            try
+            {
+                response = m_handler(command);
+            }
+            catch (const std::exception& e)
+            {
+                LOG_ERROR("Daemon request failed: " + std::string(e.what()));
+                response = "{\"status\":\"error\",\"detail\":\"" + escapeJson(e.what()) + "\"}";
+            }
+        }
+
+        response += "\n";
+        size_t sent = 0;
+        while (sent < response.size())
+        {
+            ssize_t n = write(fd, response.data() + sent, response.size() - sent);
+            if (n <= 0)
+            {
+                break;  // Client went away; the run itself still completed
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return keepRunning;
+    }
+} // namespace seneca
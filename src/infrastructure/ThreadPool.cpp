@@ -0,0 +1,160 @@
+#include "seneca/ThreadPool.h"
+#include <algorithm>
+
+namespace seneca
+{
+    namespace
+    {
+        // Pool and deque the current thread works for, if any
+        thread_local const ThreadPool* t_pool = nullptr;
+        thread_local size_t t_worker = 0;
+    }
+
+    ThreadPool::ThreadPool(size_t threads)
+        : m_queued(0)
+        , m_unfinished(0)
+        , m_nextQueue(0)
+        , m_stopping(false)
+    {
+        if (threads == 0)
+        {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+
+        for (size_t i = 0; i < threads; i++)
+        {
+            m_queues.push_back(std::make_unique<WorkQueue>());
+        }
+        for (size_t i = 0; i < threads; i++)
+        {
+            m_threads.emplace_back(&ThreadPool::workerLoop, this, i);
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    void ThreadPool::submit(PoolTask task)
+    {
+        size_t index = t_pool == this
+            ? t_worker
+            : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+        {
+            // Counted before the task is visible: a worker could otherwise
+            // steal and finish it first, and wait() would see m_unfinished
+            // reach zero while the submitting task still runs. Under m_mutex
+            // so a worker deciding to sleep cannot miss it.
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queued.fetch_add(1, std::memory_order_relaxed);
+            m_unfinished++;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_queues[index]->m_mutex);
+            m_queues[index]->m_tasks.push_back(std::move(task));
+        }
+        m_wake.notify_one();
+    }
+
+    void ThreadPool::wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this] { return m_unfinished == 0; });
+        if (m_error)
+        {
+            std::exception_ptr error = m_error;
+            m_error = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+    bool ThreadPool::takeTask(size_t index, PoolTask& task)
+    {
+        {
+            WorkQueue& own = *m_queues[index];
+            std::lock_guard<std::mutex> lock(own.m_mutex);
+            if (!own.m_tasks.empty())
+            {
+                task = std::move(own.m_tasks.back());
+                own.m_tasks.pop_back();
+                return true;
+            }
+        }
+
+        for (size_t offset = 1; offset < m_queues.size(); offset++)
+        {
+            WorkQueue& victim = *m_queues[(index + offset) % m_queues.size()];
+            std::unique_lock<std::mutex> lock(victim.m_mutex, std::try_to_lock);
+            if (lock.owns_lock() && !victim.m_tasks.empty())
+            {
+                task = std::move(victim.m_tasks.front());
+                victim.m_tasks.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ThreadPool::workerLoop(size_t index)
+    {
+        t_pool = this;
+        t_worker = index;
+
+        PoolTask task;
+        while (true)
+        {
+            if (takeTask(index, task))
+            {
+                m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+                std::exception_ptr error;
+                try
+                {
+                    task(index);
+                }
+                catch (...)
+                {
+                    error = std::current_exception();
+                }
+                task = nullptr;
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (error && !m_error)
+                {
+                    m_error = error;
+                }
+                if (--m_unfinished == 0)
+                {
+                    m_done.notify_all();
+                }
+                continue;
+            }
+
+            // Nothing to take. A steal may have skipped a busy deque, so only
+            // sleep once no task is queued anywhere.
+            std::unique_lock<std::mutex> lock(m_mutex);
+            if (m_stopping && m_queued.load(std::memory_order_relaxed) == 0)
+            {
+                return;
+            }
+            if (m_queued.load(std::memory_order_relaxed) == 0)
+            {
+                m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_relaxed) > 0; });
+            }
+            else
+            {
+                lock.unlock();
+                std::this_thread::yield();
+            }
+        }
+    }
+} // namespace seneca
@@ -0,0 +1,51 @@
+// scenario_compile - tokenize a scenario once into a binary file
+//
+// Parses the four text inputs the way assembly_line does and writes them
+// as one compiled scenario (see ScenarioFile.h), e.g.
+//
+//   scenario_compile data/Stations1.txt data/Stations2.txt
+//                    data/CustomerOrders.txt data/AssemblyLine.txt data/sample.alsc
+//
+//   assembly_line data/sample.alsc
+//
+// The compiled file does not track its sources: recompile after editing
+// any of the text files.
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioFile.h"
+#include "seneca/Logger.h"
+
+int main(int argc, char** argv)
+{
+    if (argc != 6)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <Stations1.txt> <Stations2.txt> <CustomerOrders.txt> <AssemblyLine.txt> <output.alsc>\n";
+        return 1;
+    }
+
+    try
+    {
+        seneca::Logger::getInstance().enableConsoleOutput(false);
+
+        auto start = std::chrono::steady_clock::now();
+        seneca::Scenario scenario(argv[1], argv[2], argv[3], argv[4]);
+        auto parsed = std::chrono::steady_clock::now();
+        seneca::ScenarioFile::write(scenario, argv[5]);
+        auto written = std::chrono::steady_clock::now();
+
+        auto ms = [](auto duration) { return std::chrono::duration_cast<std::chrono::milliseconds>(duration).count(); };
+        std::cout << "Compiled " << scenario.getStations().size() << " stations, " << scenario.getLinks().size()
+                  << " links and " << scenario.getOrderCount() << " orders to " << argv[5] << " (parsed in "
+                  << ms(parsed - start) << " ms, written in " << ms(written - parsed) << " ms)\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
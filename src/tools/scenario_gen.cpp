@@ -0,0 +1,108 @@
+// scenario_gen - write reproducible synthetic inputs for assembly_line
+//
+// Produces Stations1.txt (',' format), Stations2.txt ('|' format),
+// AssemblyLine.txt and CustomerOrders.txt in the output directory, e.g.
+//
+//   scenario_gen --out data/large --stations 1000 --orders 2000000
+//                --distribution zipf --scarcity 0.8 --seed 42
+//
+//   assembly_line data/large/Stations1.txt data/large/Stations2.txt
+//                 data/large/CustomerOrders.txt data/large/AssemblyLine.txt
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <sys/stat.h>
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/Logger.h"
+#include "seneca/Exceptions.h"
+
+static void usage(const char* program)
+{
+    std::cerr << "Usage: " << program << " --out <dir> [options]\n"
+              << "  --stations N         stations on the line (default 100)\n"
+              << "  --orders N           customer orders (default 10000)\n"
+              << "  --products N         product catalogue size (default 1000)\n"
+              << "  --min-items N        fewest items per product (default 1)\n"
+              << "  --max-items N        most items per product (default 8)\n"
+              << "  --distribution D     item popularity: uniform | zipf (default uniform)\n"
+              << "  --zipf-exponent X    skew for zipf (default 1.0)\n"
+              << "  --scarcity X         inventory / demand per item, 1.0 = all orders can\n"
+              << "                       complete (default 1.0)\n"
+              << "  --ordered-line       write AssemblyLine.txt in line order\n"
+              << "  --service-time T     per-unit service time of every station, e.g. exp:2\n"
+              << "  --seed N             random seed (default 1)\n";
+}
+
+int main(int argc, char** argv)
+{
+    seneca::GeneratorOptions options;
+    std::string outDir;
+
+    try
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string {
+                if (i + 1 >= argc)
+                {
+                    throw seneca::ValidationException("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--out") outDir = value();
+            else if (arg == "--stations") options.m_stations = std::stoull(value());
+            else if (arg == "--orders") options.m_orders = std::stoull(value());
+            else if (arg == "--products") options.m_products = std::stoull(value());
+            else if (arg == "--min-items") options.m_minItems = std::stoull(value());
+            else if (arg == "--max-items") options.m_maxItems = std::stoull(value());
+            else if (arg == "--distribution") options.m_distribution = seneca::ScenarioGenerator::parseDistribution(value());
+            else if (arg == "--zipf-exponent") options.m_zipfExponent = std::stod(value());
+            else if (arg == "--scarcity") options.m_scarcity = std::stod(value());
+            else if (arg == "--ordered-line") options.m_shuffleLines = false;
+            else if (arg == "--service-time") options.m_serviceTime = value();
+            else if (arg == "--seed") options.m_seed = std::stoull(value());
+            else if (arg == "--help" || arg == "-h")
+            {
+                usage(argv[0]);
+                return 0;
+            }
+            else
+            {
+                throw seneca::ValidationException("Unknown argument: " + arg);
+            }
+        }
+
+        if (outDir.empty())
+        {
+            usage(argv[0]);
+            return 1;
+        }
+
+        if (::mkdir(outDir.c_str(), 0755) != 0 && errno != EEXIST)
+        {
+            throw seneca::FileException("Cannot create " + outDir + ": " + std::strerror(errno));
+        }
+
+        seneca::Logger::getInstance().enableConsoleOutput(false);
+
+        auto start = std::chrono::steady_clock::now();
+        seneca::ScenarioGenerator generator(options);
+        generator.writeFiles(outDir);
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "Wrote " << options.m_stations << " stations and " << options.m_orders
+                  << " orders to " << outDir << " in " << ms << " ms (seed " << options.m_seed << ")\n";
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,84 @@
+#ifndef SENECA_TESTSUPPORT_H
+#define SENECA_TESTSUPPORT_H
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "seneca/SimulationContext.h"
+#include "seneca/Workstation.h"
+#include "seneca/CustomerOrder.h"
+#include "seneca/Utilities.h"
+
+// Helpers shared by the testers
+
+// Stations of the comma- and bar-delimited station files, read record by
+// record as tester_3 reads them; the caller deletes them
+inline std::vector<seneca::Workstation*> loadStations(const char* commaFile, const char* barFile)
+{
+	std::vector<seneca::Workstation*> stations;
+	const char* files[] = {commaFile, barFile};
+	const char delimiters[] = {',', '|'};
+	for (int f = 0; f < 2; ++f) {
+		std::ifstream file(files[f]);
+		if (!file)
+			throw std::runtime_error(std::string("Unable to open [") + files[f] + "] file.");
+		seneca::Utilities::setDelimiter(delimiters[f]);
+		for (std::string record; std::getline(file, record);) {
+			if (!record.empty())
+				stations.push_back(new seneca::Workstation(record));
+		}
+	}
+	return stations;
+}
+
+// Queues every order of the file on g_pending; returns how many
+inline size_t queueOrders(const char* orderFile)
+{
+	std::ifstream file(orderFile);
+	if (!file)
+		throw std::runtime_error(std::string("Unable to open [") + orderFile + "] file.");
+	size_t count = 0;
+	for (std::string record; std::getline(file, record);) {
+		if (!record.empty()) {
+			seneca::g_pending.push_back(seneca::CustomerOrder(record));
+			count++;
+		}
+	}
+	return count;
+}
+
+// Completed and incomplete orders and every station's inventory at the end
+// of a run; with `metrics`, each station's runtime counters as well
+inline std::string finalState(seneca::SimulationContext& context, const std::vector<seneca::Workstation*>& stations,
+                              bool metrics = false)
+{
+	std::ostringstream out;
+	out << "Completed\n";
+	for (const auto& o : context.completed())
+		o.display(out);
+	out << "Incomplete\n";
+	for (const auto& o : context.incomplete())
+		o.display(out);
+	out << "Inventory\n";
+	for (const auto* station : stations) {
+		station->Station::display(out, true);
+		if (metrics) {
+			seneca::StationStats stats = station->getMetrics().snapshot();
+			out << stats.m_fills << ' ' << stats.m_failedFills << ' ' << stats.m_ordersPassed << ' '
+			    << stats.m_maxQueueDepth << ' ' << stats.m_queueDepthSum << ' ' << stats.ticks() << '\n';
+		}
+	}
+	return out.str();
+}
+
+// Prints one check's outcome; returns ok so results can be and-ed together
+inline bool report(const std::string& name, bool ok)
+{
+	std::cout << name << ": " << (ok ? "ok" : "FAILED") << std::endl;
+	return ok;
+}
+
+#endif
@@ -0,0 +1,170 @@
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/LineManager.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Replicated stations and threaded fills: replicas of a station must never
+// hand out more units than it holds or the same serial number twice, and
+// filling on several threads must not change the run of a line without
+// replicas at all.
+
+using Replicas = std::vector<std::pair<std::string, size_t>>;
+
+struct Outcome
+{
+	std::string m_trace;
+	std::string m_final;
+	size_t m_iterations{};
+	bool m_consistent{};
+};
+
+// Every unit a station gave out is one filled item carrying a serial number
+// from the station's range, each used once
+static bool consistent(seneca::SimulationContext& context, const seneca::Scenario& scenario,
+                       const std::vector<seneca::Workstation*>& stations)
+{
+	std::map<std::string, std::pair<size_t, size_t>> initial;     // Serial, quantity
+	for (const auto& station : scenario.getStations())
+		initial.emplace(station.getItemName(), std::make_pair(station.getSerialNumber(), station.getQuantity()));
+
+	std::map<std::string, std::set<size_t>> serials;
+	size_t filled = 0;
+	for (const auto* queue : {&context.completed(), &context.incomplete()}) {
+		for (const auto& order : *queue) {
+			for (size_t i = 0; i < order.getItemCount(); ++i) {
+				const seneca::Item& item = order.getItem(i);
+				if (!item.m_isFilled)
+					continue;
+				auto range = initial.find(std::string(item.m_itemName));
+				if (range == initial.end() || item.m_serialNumber < range->second.first ||
+				    item.m_serialNumber >= range->second.first + range->second.second ||
+				    !serials[std::string(item.m_itemName)].insert(item.m_serialNumber).second)
+					return false;
+				++filled;
+			}
+		}
+	}
+
+	size_t taken = 0;
+	std::set<std::string> seen;
+	for (const auto* station : stations) {
+		if (!seen.insert(station->getItemName()).second)
+			continue;
+		const auto& range = initial[station->getItemName()];
+		if (station->getQuantity() > range.second ||
+		    station->getSerialNumber() != range.first + range.second - station->getQuantity())
+			return false;
+		taken += range.second - station->getQuantity();
+	}
+	return taken == filled &&
+	       context.completed().size() + context.incomplete().size() == scenario.getOrderCount();
+}
+
+static Outcome simulate(const seneca::Scenario& scenario, const Replicas& replicas, size_t threads)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	Outcome outcome;
+	{
+		seneca::StationRegistry registry = scenario.createStations();
+		std::vector<seneca::Workstation*> stations = registry.stations();
+		scenario.enqueueOrders();
+
+		seneca::LineManager lm(scenario.getLinks(), stations);
+		for (const auto& r : replicas)
+			lm.replicateStation(r.first, r.second);
+		lm.setThreads(threads);
+
+		std::ostringstream trace;
+		while (!lm.run(trace));
+		outcome.m_trace = trace.str();
+		outcome.m_iterations = lm.getIterationCount();
+		outcome.m_final = finalState(context, stations);
+		outcome.m_consistent = consistent(context, scenario, stations);
+	}
+	context.clearOrders();
+	return outcome;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		Outcome plain = simulate(sample, {}, 0);
+		Outcome single = simulate(sample, {{"Bed", 1}}, 0);
+		ok &= report("Sample data, one replica of Bed is the plain line",
+		             single.m_trace == plain.m_trace && single.m_final == plain.m_final);
+
+		Outcome replicated = simulate(sample, {{"Bed", 3}, {"Dresser", 2}}, 0);
+		ok &= report("Sample data, replicated Bed and Dresser",
+		             replicated.m_consistent && replicated.m_iterations <= plain.m_iterations);
+		std::cout << "  iterations: " << plain.m_iterations << " plain, " << replicated.m_iterations << " replicated" << std::endl;
+
+		bool refused = false;
+		try {
+			simulate(sample, {{"Spaceship", 2}}, 0);
+		}
+		catch (const seneca::ValidationException&) {
+			refused = true;
+		}
+		ok &= report("Replicating a station that is not on the line is refused", refused);
+
+		// Long enough for the fill phase to be split across workers
+		seneca::GeneratorOptions options;
+		options.m_stations = 400;
+		options.m_orders = 3000;
+		options.m_scarcity = 0.6;
+		options.m_seed = 47;
+		seneca::Scenario generated = seneca::ScenarioGenerator(options).build();
+		Outcome sequential = simulate(generated, {}, 0);
+		bool same = sequential.m_consistent;
+		for (size_t threads : {2, 4, 8}) {
+			Outcome threaded = simulate(generated, {}, threads);
+			same &= threaded.m_trace == sequential.m_trace && threaded.m_final == sequential.m_final;
+		}
+		ok &= report("Generated line, threaded fills match the single-threaded run", same);
+
+		// Replicas of the busiest stations race for their stock on
+		// different workers; the shared inventory must hold up every time
+		Replicas hot;
+		for (size_t i = 0; i < 40; ++i)
+			hot.emplace_back(generated.getStations()[i * 10].getItemName(), 2 + i % 4);
+		Outcome base = simulate(generated, hot, 0);
+		bool consistentRuns = base.m_consistent && base.m_iterations <= sequential.m_iterations;
+		for (int run = 0; run < 5; ++run)
+			consistentRuns &= simulate(generated, hot, 4).m_consistent;
+		ok &= report("Generated line, replicas filling on 4 threads", consistentRuns);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: replicated or threaded runs are inconsistent\n";
+		std::exit(3);
+	}
+	return 0;
+}
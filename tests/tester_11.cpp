@@ -0,0 +1,210 @@
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/IncrementalEngine.h"
+#include "seneca/LineManager.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Lines with forks and joins: an order leaving a fork must take the branch
+// that can fill its items, the branches must merge again at the join, and
+// filling on several threads must not change a forked run.
+
+using Links = std::vector<seneca::StationLink>;
+
+struct Outcome
+{
+	std::string m_trace;
+	std::string m_final;
+	std::map<std::string, size_t> m_passed;    // Orders each station moved on
+	size_t m_completed{};
+	size_t m_incomplete{};
+	size_t m_iterations{};
+};
+
+static Outcome simulate(const seneca::Scenario& scenario, size_t threads)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	Outcome outcome;
+	{
+		seneca::StationRegistry registry = scenario.createStations();
+		std::vector<seneca::Workstation*> stations = registry.stations();
+		scenario.enqueueOrders();
+
+		seneca::LineManager lm(scenario.getLinks(), stations);
+		lm.reorderStations();
+		lm.setThreads(threads);
+
+		std::ostringstream trace;
+		while (!lm.run(trace));
+		lm.display(trace);
+		outcome.m_trace = trace.str();
+		outcome.m_iterations = lm.getIterationCount();
+
+		outcome.m_final = finalState(context, stations);
+		for (const auto* station : stations)
+			outcome.m_passed[station->getItemName()] = station->getMetrics().m_ordersPassed.get();
+		outcome.m_completed = context.completed().size();
+		outcome.m_incomplete = context.incomplete().size();
+	}
+	context.clearOrders();
+	return outcome;
+}
+
+// Frame forks into a drawer cell and an upholstery cell that join again at
+// Paint; every order needs the frame, the paint and one cell's items
+static seneca::Scenario workshop(Links links)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	std::vector<seneca::Station> stations;
+	for (const char* record : {"Frame,100,20,Frame", "Drawer,200,20,Drawer", "Handle,300,20,Handle",
+	                           "Cushion,400,20,Cushion", "Paint,500,20,Paint"})
+		stations.emplace_back(record, ',');
+
+	std::vector<seneca::OrderSpec> orders;
+	for (int i = 0; i < 6; ++i) {
+		if (i % 3 == 2)
+			orders.push_back({"Sofa " + std::to_string(i), "Sofa", {"Frame", "Cushion", "Paint"}});
+		else
+			orders.push_back({"Dresser " + std::to_string(i), "Dresser", {"Frame", "Drawer", "Handle", "Paint"}});
+	}
+	return seneca::Scenario(std::move(stations), std::move(orders), std::move(links));
+}
+
+static const Links FORKED{{"Frame", "Drawer"}, {"Frame", "Cushion"}, {"Drawer", "Handle"},
+                          {"Handle", "Paint"}, {"Cushion", "Paint"}, {"Paint", ""}};
+
+template <typename Exception, typename Action>
+static bool refuses(Action action)
+{
+	try {
+		action();
+	}
+	catch (const Exception&) {
+		return true;
+	}
+	return false;
+}
+
+// A generated chain with extra links skipping ahead, so that every tenth
+// station forks and the skipped stations are bypassed by some orders
+static seneca::Scenario forkedChain(const seneca::Scenario& generated)
+{
+	std::map<std::string, std::string> next;
+	std::map<std::string, bool> linkedTo;
+	for (const auto& link : generated.getLinks()) {
+		next[link.first] = link.second;
+		linkedTo[link.second] = true;
+	}
+	std::vector<std::string> chain;
+	for (const auto& link : generated.getLinks())
+		if (!linkedTo[link.first])
+			for (std::string name = link.first; !name.empty(); name = next[name])
+				chain.push_back(name);
+
+	Links links = generated.getLinks();
+	for (size_t i = 0; i + 7 < chain.size(); i += 10)
+		links.emplace_back(chain[i], chain[i + 7]);
+	std::vector<seneca::Station> stations = generated.getStations();
+	std::vector<seneca::OrderSpec> orders = generated.getOrders();
+	return seneca::Scenario(std::move(stations), std::move(orders), std::move(links));
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		// Sofas take the upholstery cell, dressers the drawer cell, and
+		// both leave through Paint
+		Outcome forked = simulate(workshop(FORKED), 0);
+		ok &= report("Orders take the branch that fills them",
+		             forked.m_completed == 6 && forked.m_incomplete == 0 &&
+		             forked.m_passed["Drawer"] == 4 && forked.m_passed["Cushion"] == 2 &&
+		             forked.m_passed["Paint"] == 6);
+		ok &= report("A fork lists its branches",
+		             forked.m_trace.find("Frame --> Drawer, Cushion\n") != std::string::npos);
+
+		// The same cells in a row: every order crosses every station
+		Outcome chained = simulate(workshop({{"Frame", "Drawer"}, {"Drawer", "Handle"}, {"Handle", "Cushion"},
+		                                     {"Cushion", "Paint"}, {"Paint", ""}}), 0);
+		ok &= report("The forked line is no slower than the chain",
+		             chained.m_completed == 6 && chained.m_passed["Cushion"] == 6 &&
+		             forked.m_iterations <= chained.m_iterations);
+		std::cout << "  iterations: " << chained.m_iterations << " chained, " << forked.m_iterations << " forked" << std::endl;
+
+		// Once the upholstery cell runs dry the sofas have nowhere better
+		// to go and follow the first branch
+		seneca::Scenario dry = workshop(FORKED);
+		std::vector<seneca::Station> stations = dry.getStations();
+		stations[3].setQuantity(0);
+		std::vector<seneca::OrderSpec> orders = dry.getOrders();
+		Links links = FORKED;
+		Outcome stockOut = simulate(seneca::Scenario(std::move(stations), std::move(orders), std::move(links)), 0);
+		ok &= report("A dry branch is not chosen",
+		             stockOut.m_incomplete == 2 && stockOut.m_passed["Cushion"] == 0 && stockOut.m_passed["Drawer"] == 6);
+
+		Links cyclic = FORKED;
+		cyclic.emplace_back("Handle", "Drawer");
+		ok &= report("A cycle behind a fork is refused",
+		             refuses<seneca::ValidationException>([&]() { simulate(workshop(cyclic), 0); }));
+
+		ok &= report("fastForward refuses a forked line", refuses<seneca::StationException>([&]() {
+			seneca::Scenario scenario = workshop(FORKED);
+			seneca::SimulationContext context;
+			seneca::SimulationContext::Scope scope(context);
+			seneca::StationRegistry registry = scenario.createStations();
+			scenario.enqueueOrders();
+			seneca::LineManager lm(scenario.getLinks(), registry.stations());
+			lm.fastForward();
+		}));
+		ok &= report("The incremental engine refuses a forked line", refuses<seneca::ValidationException>([&]() {
+			seneca::Scenario scenario = workshop(FORKED);
+			seneca::IncrementalEngine engine(scenario);
+		}));
+
+		// Long enough for the fill phase to be split across workers
+		seneca::GeneratorOptions options;
+		options.m_stations = 400;
+		options.m_orders = 3000;
+		options.m_scarcity = 0.6;
+		options.m_seed = 48;
+		seneca::Scenario generated = forkedChain(seneca::ScenarioGenerator(options).build());
+		Outcome sequential = simulate(generated, 0);
+		bool same = sequential.m_completed + sequential.m_incomplete == generated.getOrderCount();
+		for (size_t threads : {2, 4}) {
+			Outcome threaded = simulate(generated, threads);
+			same &= threaded.m_trace == sequential.m_trace && threaded.m_final == sequential.m_final;
+		}
+		ok &= report("Generated forked line, threaded fills match the single-threaded run", same);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: forked lines routed or merged orders wrongly\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,148 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/LineManager.h"
+#include "seneca/ShardedLine.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Sharded runs: a line split into worker processes must end in exactly the
+// state run() reaches in one process, whatever the segment count, batch
+// size and credit window.
+
+// Final state of the scenario run in this process, or sharded when options
+// are given
+static std::string simulate(const seneca::Scenario& scenario, const seneca::ShardOptions* options,
+                            seneca::ShardStats* stats = nullptr)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	std::string state;
+	{
+		seneca::StationRegistry registry = scenario.createStations();
+		std::vector<seneca::Workstation*> stations = registry.stations();
+		scenario.enqueueOrders();
+
+		seneca::LineManager lm(scenario.getLinks(), stations);
+		if (options) {
+			seneca::ShardStats result = lm.runSharded(*options);
+			if (stats)
+				*stats = result;
+		}
+		else {
+			std::ostream discard(nullptr);
+			while (!lm.run(discard));
+		}
+		state = finalState(context, stations);
+	}
+	context.clearOrders();
+	return state;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		std::string expected = simulate(sample, nullptr);
+		bool same = true;
+		for (size_t segments : {1, 3, 8, 20}) {
+			seneca::ShardOptions options;
+			options.m_segments = segments;
+			same &= simulate(sample, &options) == expected;
+		}
+		ok &= report("Sample data, 1 to 8 segments", same);
+
+		seneca::GeneratorOptions generator;
+		generator.m_stations = 60;
+		generator.m_orders = 2000;
+		generator.m_scarcity = 0.7;
+		generator.m_seed = 49;
+		seneca::Scenario generated = seneca::ScenarioGenerator(generator).build();
+		expected = simulate(generated, nullptr);
+		same = true;
+		for (size_t segments : {1, 2, 7}) {
+			for (size_t batch : {1, 64, 5000}) {
+				seneca::ShardOptions options;
+				options.m_segments = segments;
+				options.m_batchOrders = batch;
+				options.m_credits = batch == 1 ? 1 : 4;
+				same &= simulate(generated, &options) == expected;
+			}
+		}
+		ok &= report("Generated line, segments x batch sizes x credit windows", same);
+
+		// With one credit per hop the coordinator has to wait for every
+		// batch to be acknowledged before sending the next
+		seneca::ShardOptions tight;
+		tight.m_segments = 4;
+		tight.m_batchOrders = 100;
+		tight.m_credits = 1;
+		seneca::ShardStats stats;
+		same = simulate(generated, &tight, &stats) == expected;
+		ok &= report("One credit per hop", same && stats.m_segments == 4 && stats.m_batches == 20 && stats.m_stalls >= 19);
+		std::cout << "  " << stats.m_batches << " batches, " << stats.m_bytes << " bytes, "
+		          << stats.m_stalls << " credit stalls" << std::endl;
+
+		// Batches of one order and a window far wider than the unread
+		// credits a socket buffer holds: every batch is acknowledged on its
+		// own while the sender keeps writing
+		seneca::GeneratorOptions wideGenerator;
+		wideGenerator.m_stations = 20;
+		wideGenerator.m_orders = 3000;
+		wideGenerator.m_seed = 12;
+		seneca::Scenario wideScenario = seneca::ScenarioGenerator(wideGenerator).build();
+		expected = simulate(wideScenario, nullptr);
+		bool wide = true;
+		for (size_t credits : {300, 5000}) {
+			seneca::ShardOptions options;
+			options.m_segments = 3;
+			options.m_batchOrders = 1;
+			options.m_credits = credits;
+			wide &= simulate(wideScenario, &options, &stats) == expected && stats.m_batches == 3000;
+		}
+		ok &= report("Credit windows wider than a socket buffer", wide);
+
+		bool refused = false;
+		try {
+			seneca::SimulationContext context;
+			seneca::SimulationContext::Scope scope(context);
+			seneca::StationRegistry registry = sample.createStations();
+			sample.enqueueOrders();
+			seneca::LineManager lm(sample.getLinks(), registry.stations());
+			lm.replicateStation("Bed", 2);
+			seneca::ShardOptions options;
+			lm.runSharded(options);
+		}
+		catch (const seneca::StationException&) {
+			refused = true;
+		}
+		ok &= report("A line with replicated stations is refused", refused);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: sharded runs diverged from the single-process run\n";
+		std::exit(3);
+	}
+	return 0;
+}
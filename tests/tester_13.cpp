@@ -0,0 +1,283 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/ScenarioFile.h"
+#include "seneca/RecordParser.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/LineManager.h"
+#include "seneca/CalendarQueue.h"
+#include "seneca/TimedEngine.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Timed runs: the calendar must hand events out in time order, service
+// times must parse from station records, and a chain run in simulated time
+// must end in the state run() reaches, with the makespan queueing theory
+// predicts where it can be worked out by hand.
+
+using Links = std::vector<seneca::StationLink>;
+using Replicas = std::vector<std::pair<std::string, size_t>>;
+
+struct Outcome
+{
+	std::string m_final;
+	seneca::TimedStats m_stats;
+};
+
+// Final state of the scenario run in simulated time, or iterated by run()
+// when no options are given
+static Outcome simulate(const seneca::Scenario& scenario, const seneca::TimedOptions* options,
+                        const Replicas& replicas = {})
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	Outcome outcome;
+	{
+		seneca::StationRegistry registry = scenario.createStations();
+		std::vector<seneca::Workstation*> stations = registry.stations();
+		scenario.enqueueOrders();
+
+		seneca::LineManager lm(scenario.getLinks(), stations);
+		for (const auto& r : replicas)
+			lm.replicateStation(r.first, r.second);
+		if (options)
+			outcome.m_stats = lm.runTimed(*options);
+		else {
+			std::ostream discard(nullptr);
+			while (!lm.run(discard));
+		}
+		outcome.m_final = finalState(context, stations);
+	}
+	context.clearOrders();
+	return outcome;
+}
+
+// A line of single-item stations in record order, every order wanting one
+// unit from each
+static seneca::Scenario line(const std::vector<std::string>& records, size_t orders)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	std::vector<seneca::Station> stations;
+	for (const auto& record : records)
+		stations.emplace_back(record, ',');
+
+	Links links;
+	std::vector<std::string> items;
+	for (size_t i = 0; i < stations.size(); ++i) {
+		items.push_back(stations[i].getItemName());
+		links.emplace_back(stations[i].getItemName(), i + 1 < stations.size() ? stations[i + 1].getItemName() : "");
+	}
+	std::vector<seneca::OrderSpec> specs;
+	for (size_t i = 0; i < orders; ++i)
+		specs.push_back({"Customer " + std::to_string(i), "Product", items});
+	return seneca::Scenario(std::move(stations), std::move(specs), std::move(links));
+}
+
+static bool close(double a, double b)
+{
+	return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		// Service times
+		seneca::ServiceTime time;
+		bool parsed = seneca::ServiceTime::parse("2.5", time) && time.m_kind == seneca::ServiceTime::Kind::CONSTANT &&
+		              time.m_a == 2.5 && seneca::ServiceTime::parse("uniform:1:3", time) && time.mean() == 2 &&
+		              seneca::ServiceTime::parse("exp:4", time) && time.toString() == "exp:4" &&
+		              seneca::ServiceTime::parse("normal:5:0", time) && time.mean() == 5;
+		for (const char* bad : {"", "-1", "fast", "exp", "exp:1:2", "uniform:3:1", "normal:1", "const:inf", "2x"})
+			parsed &= !seneca::ServiceTime::parse(bad, time);
+		ok &= report("Service times parse and print", parsed);
+
+		{
+			seneca::SimulationContext context;
+			seneca::SimulationContext::Scope scope(context);
+			seneca::Station timed("Bed,100,5,Queen bed,service=exp:2", ',');
+			seneca::Station plain("Bed,100,5,Queen bed,ships flat", ',');
+			seneca::StationFields fields;
+			bool records = timed.getServiceTime().toString() == "exp:2" && timed.getDescription() == "Queen bed" &&
+			               plain.getServiceTime().toString() == "1" &&
+			               seneca::parseStation("Bed | 100 | 5 | Queen bed | service=uniform:1:2", '|', fields) == seneca::ParseStatus::OK &&
+			               fields.m_service.toString() == "uniform:1:2" &&
+			               seneca::parseStation("Bed,100,5,Queen bed,service=soon", ',', fields) == seneca::ParseStatus::BAD_SERVICE;
+			try {
+				seneca::Station broken("Bed,100,5,Queen bed,service=-3", ',');
+				records = false;
+			}
+			catch (const std::exception&) {
+			}
+			ok &= report("Station records carry a service time", records);
+		}
+
+		// The calendar against a sorted copy: a hold model with ties and
+		// jumps far ahead, so it resizes and recalibrates along the way
+		{
+			seneca::CalendarQueue calendar;
+			uint64_t state = 13;
+			auto next = [&state]() { state = state * 6364136223846793005ULL + 1442695040888963407ULL; return state >> 33; };
+			double now = 0;
+			uint32_t id = 0;
+			std::vector<std::pair<double, uint32_t>> popped;
+			for (int i = 0; i < 2000; ++i)
+				calendar.push(double(next() % 100), id++, 0);
+			for (int step = 0; step < 200000; ++step) {
+				seneca::TimedEvent event = calendar.pop();
+				if (event.m_time < now)
+					break;
+				now = event.m_time;
+				popped.emplace_back(event.m_time, event.m_target);
+				// Grow, then alternate holding and draining
+				int pushes = step < 20000 ? 1 + step % 2 : step % 1000 < 500 ? 1 : (step % 3 == 0 ? 2 : 0);
+				for (int p = 0; p < pushes && calendar.size() < 50000; ++p) {
+					double delay = step % 997 == 0 ? 1e6 : double(next() % 1000) / 100.0;
+					calendar.push(now + delay, id++, 0);
+				}
+				if (calendar.empty())
+					break;
+			}
+			while (!calendar.empty()) {
+				seneca::TimedEvent event = calendar.pop();
+				popped.emplace_back(event.m_time, event.m_target);
+			}
+			// Ids grow with scheduling order, so time then id is the order
+			// events must come out in
+			bool ordered = popped.size() == id && std::is_sorted(popped.begin(), popped.end());
+			ok &= report("Calendar queue pops in time order, first in first out on ties", ordered);
+			std::cout << "  " << popped.size() << " events, " << calendar.resizeCount() << " resizes, "
+			          << calendar.bucketCount() << " buckets at the end" << std::endl;
+		}
+
+		// One station taking 2 per unit: n orders at once finish at 2n,
+		// the k-th after 2k in the system
+		seneca::TimedOptions options;
+		Outcome single = simulate(line({"Bed,1,100,Bed,service=2"}, 10), &options);
+		ok &= report("One server, constant service", close(single.m_stats.m_makespan, 20) &&
+		             close(single.m_stats.m_throughput, 0.5) && close(single.m_stats.m_meanFlowTime, 11) &&
+		             single.m_stats.m_events == 11 && close(single.m_stats.m_stations[0].m_busy, 20));
+
+		// Three stations in tandem, one unit each: the pipeline fills in 2
+		// and then retires an order per time unit
+		Outcome tandem = simulate(line({"A,1,100,A", "B,1,100,B", "C,1,100,C"}, 50), &options);
+		ok &= report("Tandem line, makespan n + stations - 1", close(tandem.m_stats.m_makespan, 52) &&
+		             tandem.m_stats.m_orders == 50);
+
+		// Orders released every 3 into a station taking 2 never queue
+		seneca::TimedOptions spaced;
+		spaced.m_interarrival.m_a = 3;
+		Outcome idle = simulate(line({"Bed,1,100,Bed,service=2"}, 10), &spaced);
+		ok &= report("Releases spaced wider than the service never queue",
+		             close(idle.m_stats.m_makespan, 29) && close(idle.m_stats.m_maxFlowTime, 2));
+
+		// Bed holds the line to one order per 4; two replicas, taking
+		// orders in turn, to two
+		Outcome replicated = simulate(line({"A,1,100,A", "Bed,1,100,Bed,service=4", "C,1,100,C"}, 20), &options,
+		                              {{"Bed", 2}});
+		Outcome bottleneck = simulate(line({"A,1,100,A", "Bed,1,100,Bed,service=4", "C,1,100,C"}, 20), &options);
+		ok &= report("Replicating the bottleneck", close(bottleneck.m_stats.m_makespan, 82) &&
+		             close(replicated.m_stats.m_makespan, 43) && replicated.m_stats.m_orders == 20);
+		std::cout << "  makespan " << bottleneck.m_stats.m_makespan << " with one Bed, "
+		          << replicated.m_stats.m_makespan << " with two" << std::endl;
+
+		// Once A runs dry at 15 the orders behind pass it at once and
+		// queue at B
+		Outcome dry = simulate(line({"A,1,3,A,service=5", "B,1,100,B"}, 10), &options);
+		ok &= report("A dry station is passed at once", close(dry.m_stats.m_makespan, 23) &&
+		             dry.m_stats.m_stations[0].m_units == 3);
+
+		// Whatever the timing, a chain ends where run() ends
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		std::string expected = simulate(sample, nullptr).m_final;
+		bool same = simulate(sample, &options).m_final == expected;
+		spaced.m_interarrival = {seneca::ServiceTime::Kind::EXPONENTIAL, 0.5, 0};
+		same &= simulate(sample, &spaced).m_final == expected;
+		ok &= report("Sample data, timed runs end in the state run() reaches", same);
+
+		seneca::GeneratorOptions generator;
+		generator.m_stations = 80;
+		generator.m_orders = 3000;
+		generator.m_scarcity = 0.7;
+		generator.m_seed = 50;
+		generator.m_serviceTime = "exp:1";
+		seneca::Scenario generated = seneca::ScenarioGenerator(generator).build();
+		expected = simulate(generated, nullptr).m_final;
+		seneca::TimedOptions random;
+		random.m_interarrival = {seneca::ServiceTime::Kind::UNIFORM, 0, 4};
+		random.m_seed = 7;
+		Outcome first = simulate(generated, &random);
+		Outcome again = simulate(generated, &random);
+		random.m_seed = 8;
+		Outcome reseeded = simulate(generated, &random);
+		ok &= report("Generated line, random service times end in the state run() reaches",
+		             first.m_final == expected && reseeded.m_final == expected);
+		ok &= report("Same seed, same run; another seed, another makespan",
+		             first.m_stats.m_makespan == again.m_stats.m_makespan &&
+		             first.m_stats.m_events == again.m_stats.m_events &&
+		             first.m_stats.m_makespan != reseeded.m_stats.m_makespan);
+		std::cout << "  makespan " << first.m_stats.m_makespan << ", " << first.m_stats.m_events << " events, "
+		          << first.m_stats.m_coalesced << " coalesced, throughput " << first.m_stats.m_throughput << std::endl;
+
+		// A compiled scenario keeps its service times
+		{
+			seneca::SimulationContext context;
+			seneca::SimulationContext::Scope scope(context);
+			std::string path = "timed_test.alsc";
+			seneca::ScenarioFile::write(generated, path);
+			seneca::Scenario compiled = seneca::ScenarioFile::read(path);
+			std::remove(path.c_str());
+			bool kept = compiled.getStations().size() == generated.getStations().size();
+			for (const auto& station : compiled.getStations())
+				kept &= station.getServiceTime().toString() == "exp:1";
+			ok &= report("Compiled scenarios keep service times", kept);
+		}
+
+		bool refused = false;
+		try {
+			seneca::SimulationContext context;
+			seneca::SimulationContext::Scope scope(context);
+			seneca::StationRegistry registry = sample.createStations();
+			sample.enqueueOrders();
+			seneca::LineManager lm(sample.getLinks(), registry.stations());
+			std::ostream discard(nullptr);
+			lm.run(discard);
+			lm.run(discard);
+			lm.runTimed(options);
+		}
+		catch (const seneca::StationException&) {
+			refused = true;
+		}
+		ok &= report("A line with orders in progress is refused", refused);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: timed runs scheduled or filled orders wrongly\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,228 @@
+#include <atomic>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ParameterSweep.h"
+#include "seneca/ThreadPool.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Parallel sweeps: the pool must not let wait() return while any task,
+// including one submitted by a running task, is unfinished, and a sweep
+// must parse its spec, number its variants and report them the same way
+// whatever the thread count.
+
+// Every task submits `fanout` children down to `depth`; each leaf yields
+// for a while so a premature wait() would find it still running
+static bool nestedSubmits(size_t threads, size_t rounds)
+{
+	seneca::ThreadPool pool(threads);
+	const size_t fanout = 4;
+	const size_t depth = 3;
+	const size_t expected = fanout * fanout * fanout;
+	for (size_t round = 0; round < rounds; ++round) {
+		std::atomic<size_t> leaves{0};
+		std::function<void(size_t)> spawn = [&](size_t level) {
+			if (level == depth) {
+				for (int spin = 0; spin < 20; ++spin)
+					std::this_thread::yield();
+				leaves.fetch_add(1);
+				return;
+			}
+			for (size_t c = 0; c < fanout; ++c)
+				pool.submit([&spawn, level](size_t) { spawn(level + 1); });
+		};
+		pool.submit([&spawn](size_t) { spawn(0); });
+		pool.wait();
+		if (leaves.load() != expected) {
+			std::cout << "  round " << round << ": wait() returned after " << leaves.load() << " of "
+			          << expected << " leaves" << std::endl;
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool throwsValidation(const seneca::Scenario& scenario, const std::string& spec, const std::string& expect)
+{
+	try {
+		std::istringstream in(spec);
+		seneca::ParameterSweep sweep(scenario, in);
+	}
+	catch (const seneca::ValidationException& e) {
+		if (std::string(e.what()).find(expect) != std::string::npos)
+			return true;
+		std::cout << "  '" << spec << "': " << e.what() << std::endl;
+		return false;
+	}
+	catch (const std::exception& e) {
+		std::cout << "  '" << spec << "' escaped as " << e.what() << std::endl;
+		return false;
+	}
+	std::cout << "  '" << spec << "' was accepted" << std::endl;
+	return false;
+}
+
+static bool sameOutcome(const seneca::SweepResult& a, const seneca::SweepResult& b)
+{
+	return a.m_variant == b.m_variant && a.m_quantities == b.m_quantities && a.m_totalInventory == b.m_totalInventory &&
+	       a.m_completed == b.m_completed && a.m_incomplete == b.m_incomplete && a.m_iterations == b.m_iterations;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		{
+			seneca::ThreadPool pool(4);
+			std::atomic<size_t> sum{0};
+			std::atomic<bool> indexInRange{true};
+			for (size_t i = 1; i <= 1000; ++i) {
+				pool.submit([&, i](size_t worker) {
+					sum.fetch_add(i);
+					if (worker >= pool.size())
+						indexInRange = false;
+				});
+			}
+			pool.wait();
+			ok &= report("Pool runs every task submitted from outside", sum.load() == 500500 && indexInRange.load());
+		}
+
+		ok &= report("wait() covers tasks submitted by running tasks", nestedSubmits(4, 200) && nestedSubmits(1, 20));
+
+		{
+			seneca::ThreadPool pool(3);
+			std::atomic<size_t> ran{0};
+			for (int i = 0; i < 10; ++i) {
+				pool.submit([&ran, i](size_t) {
+					ran.fetch_add(1);
+					if (i == 5)
+						throw std::runtime_error("task 5");
+				});
+			}
+			bool rethrown = false;
+			try {
+				pool.wait();
+			}
+			catch (const std::runtime_error& e) {
+				rethrown = std::string(e.what()) == "task 5";
+			}
+			pool.submit([&ran](size_t) { ran.fetch_add(1); });
+			pool.wait();
+			ok &= report("A task's exception comes out of wait() and the pool carries on", rethrown && ran.load() == 11);
+		}
+
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		const size_t orders = sample.getOrders().size();
+
+		{
+			std::istringstream spec("# two range axes, first one fastest\n"
+			                        "Bed  | range | 0 | 2\n"
+			                        "\n"
+			                        "Desk | range | 1 | 3 | 2   # 1, 3\n");
+			seneca::ParameterSweep sweep(sample, spec);
+			bool indexed = sweep.variantCount() == 6 && sweep.getAxes().size() == 2;
+			const size_t bed[] = {0, 1, 2, 0, 1, 2};
+			const size_t desk[] = {1, 1, 1, 3, 3, 3};
+			for (size_t v = 0; indexed && v < 6; ++v)
+				indexed = sweep.quantities(v) == std::vector<size_t>{bed[v], desk[v]};
+			ok &= report("Range axes are mixed-radix digits of the variant", indexed);
+
+			std::vector<seneca::SweepResult> one = sweep.run(1);
+			std::vector<seneca::SweepResult> three = sweep.run(3);
+			bool same = one.size() == 6 && three.size() == 6;
+			for (size_t v = 0; same && v < 6; ++v) {
+				same = sameOutcome(one[v], three[v]) && one[v].m_variant == v &&
+				       one[v].m_completed + one[v].m_incomplete == orders;
+			}
+			ok &= report("Variants come back in order, the same on 1 and 3 threads", same);
+
+			std::ostringstream csv;
+			sweep.writeCsv(csv, one);
+			std::istringstream lines(csv.str());
+			std::string header;
+			std::getline(lines, header);
+			size_t rows = 0;
+			for (std::string row; std::getline(lines, row);)
+				rows++;
+			ok &= report("CSV has a header and one row per variant",
+			             header == "variant,completed,incomplete,iterations,total_inventory,elapsed_ms,Bed,Desk" &&
+			             rows == 6);
+		}
+
+		{
+			std::istringstream spec("@seed | 7\n@samples | 5\nBed | random | 2 | 4\n* | random | 0 | 3\n");
+			seneca::ParameterSweep sweep(sample, spec);
+			std::istringstream again("@seed | 7\n@samples | 5\nBed | random | 2 | 4\n* | random | 0 | 3\n");
+			seneca::ParameterSweep twin(sample, again);
+			bool bounded = sweep.variantCount() == 5 && sweep.getAxes().size() == sample.getStations().size();
+			for (size_t v = 0; bounded && v < 5; ++v) {
+				std::vector<size_t> values = sweep.quantities(v);
+				bounded = values == twin.quantities(v) && values[0] >= 2 && values[0] <= 4;
+				for (size_t a = 1; bounded && a < values.size(); ++a)
+					bounded = values[a] <= 3;
+			}
+			ok &= report("Random draws stay in bounds and depend only on seed and variant", bounded);
+		}
+
+		{
+			std::istringstream full("Bed | random | 0 | 18446744073709551615\n");
+			seneca::ParameterSweep sweep(sample, full);
+			sweep.quantities(0);
+			ok &= report("A random axis over every size_t draws without dividing by zero", sweep.variantCount() == 1);
+		}
+
+		bool rejected = throwsValidation(sample, "Bed | range | 0 | 99999999999999999999\n", "line 1: '99999999999999999999' is out of range");
+		rejected &= throwsValidation(sample, "@seed | 1\nBed | range | 0 | 18446744073709551615\n", "line 2: range has more than");
+		rejected &= throwsValidation(sample, "Sofa | range | 0 | 2\n", "unknown station 'Sofa'");
+		rejected &= throwsValidation(sample, "Bed | range | 0 | 2\nBed | random | 0 | 2\n", "swept twice");
+		rejected &= throwsValidation(sample, "Bed | range | 3 | 2\n", "min is greater than max");
+		rejected &= throwsValidation(sample, "Bed | range | 0 | 2 | 0\n", "step must be at least 1");
+		rejected &= throwsValidation(sample, "Bed | range | -1 | 2\n", "non-negative integer");
+		rejected &= throwsValidation(sample, "@samples | 0\n", "at least 1");
+		rejected &= throwsValidation(sample, "* | range | 0 | 9999\nBed | range | 0 | 9999\n", "variants");
+		ok &= report("Bad specs are line-numbered ValidationExceptions", rejected);
+
+		{
+			std::vector<seneca::SweepResult> results(4);
+			size_t totals[] = {30, 12, 9, 15};
+			size_t incomplete[] = {0, 0, 2, 0};
+			for (size_t i = 0; i < 4; ++i) {
+				results[i].m_variant = i;
+				results[i].m_totalInventory = totals[i];
+				results[i].m_incomplete = incomplete[i];
+			}
+			const seneca::SweepResult* best = seneca::ParameterSweep::cheapestComplete(results);
+			results[1].m_incomplete = results[3].m_incomplete = results[0].m_incomplete = 1;
+			ok &= report("cheapestComplete picks the smallest inventory that completed everything",
+			             best && best->m_variant == 1 && !seneca::ParameterSweep::cheapestComplete(results));
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the pool or the sweep misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,196 @@
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include "seneca/Config.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Hot-reloadable configuration: a reload must publish a new snapshot
+// without touching the ones readers hold, notify exactly the subscribers
+// whose key changed, never lose or reorder concurrent changes, and the
+// file watcher must pick up a file replaced the way editors save it.
+
+// Collects the values a subscriber was called with
+struct Calls
+{
+	std::mutex m_mutex;
+	std::condition_variable m_changed;
+	std::vector<std::string> m_values;
+
+	seneca::ConfigCallback callback()
+	{
+		return [this](const std::string& value) {
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_values.push_back(value);
+			m_changed.notify_all();
+		};
+	}
+
+	std::vector<std::string> values()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_values;
+	}
+
+	// Waits up to `seconds` for the count to reach `count`
+	bool waitFor(size_t count, int seconds)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_changed.wait_for(lock, std::chrono::seconds(seconds), [&] { return m_values.size() >= count; });
+	}
+};
+
+static void writeFile(const std::string& path, const std::string& text)
+{
+	std::ofstream out(path);
+	out << text;
+}
+
+// Written beside the file and renamed over it, as editors save
+static void replaceFile(const std::string& path, const std::string& text)
+{
+	std::string temporary = path + ".new";
+	writeFile(temporary, text);
+	std::rename(temporary.c_str(), path.c_str());
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	std::string path = "config_test_" + std::to_string(::getpid()) + ".txt";
+	try {
+		seneca::Config& config = seneca::Config::getInstance();
+		writeFile(path, "# test settings\nlog_level = INFO\nthreads=4\nconsole=no\nkept=same\nremoved=soon\n");
+		ok &= report("Load and typed access", config.loadFromFile(path) && config.getString("log_level") == "INFO" &&
+		             config.getInt("threads") == 4 && !config.getBool("console", true) && config.hasKey("removed"));
+
+		bool parsed = true;
+		for (const char* yes : {"true", "1", "yes", "on", "TRUE", "On"})
+			parsed &= seneca::Config::parseBool(yes, false);
+		for (const char* no : {"false", "0", "no", "off", "False", "OFF"})
+			parsed &= !seneca::Config::parseBool(no, true);
+		parsed &= seneca::Config::parseBool("maybe", true) && !seneca::Config::parseBool("", false);
+		ok &= report("parseBool accepts the spellings getBool does", parsed);
+
+		Calls level, kept, removed, added;
+		size_t levelId = config.subscribe("log_level", level.callback());
+		config.subscribe("kept", kept.callback());
+		config.subscribe("removed", removed.callback());
+		config.subscribe("added", added.callback());
+
+		seneca::ConfigSnapshot before = config.snapshot();
+		writeFile(path, "log_level=DEBUG\nthreads=4\nconsole=no\nkept=same\nadded=new\n");
+		bool reloaded = config.reload();
+		ok &= report("A reload notifies changed, removed and added keys only",
+		             reloaded && level.values() == std::vector<std::string>{"DEBUG"} && kept.values().empty() &&
+		             removed.values() == std::vector<std::string>{""} &&
+		             added.values() == std::vector<std::string>{"new"});
+		ok &= report("A held snapshot keeps the values it was taken with",
+		             before->at("log_level") == "INFO" && before->count("removed") == 1 &&
+		             config.getString("log_level") == "DEBUG" && !config.hasKey("removed"));
+
+		config.setString("log_level", "WARN");
+		config.unsubscribe(levelId);
+		config.setString("log_level", "ERROR");
+		ok &= report("Set values notify until unsubscribed",
+		             level.values() == std::vector<std::string>{"DEBUG", "WARN"});
+
+		{
+			// Writers on four threads: no thread's key may be lost to another's
+			// copy, and the subscriber must end on the value the config holds
+			Calls shared;
+			size_t sharedId = config.subscribe("shared", shared.callback());
+			std::vector<std::thread> writers;
+			for (int t = 0; t < 4; ++t) {
+				writers.emplace_back([&config, t]() {
+					for (int n = 0; n < 500; ++n) {
+						config.setInt("writer" + std::to_string(t * 1000 + n), n);
+						config.setInt("shared", t * 1000 + n);
+					}
+				});
+			}
+			for (auto& writer : writers)
+				writer.join();
+			config.unsubscribe(sharedId);
+			std::vector<std::string> values = shared.values();
+			bool kept = true;
+			for (int t = 0; t < 4; ++t)
+				for (int n = 0; n < 500; ++n)
+					kept &= config.getInt("writer" + std::to_string(t * 1000 + n), -1) == n;
+			std::vector<int> last(4, -1);
+			bool ordered = !values.empty() && values.back() == config.getString("shared");
+			for (const std::string& value : values) {
+				int t = std::stoi(value) / 1000, n = std::stoi(value) % 1000;
+				ordered &= n > last[t];
+				last[t] = n;
+			}
+			ok &= report("Concurrent sets keep every key and notify in order", kept && ordered);
+		}
+
+		std::remove(path.c_str());
+		ok &= report("A reload of a file that is gone keeps the settings",
+		             !config.reload() && config.getString("added") == "new");
+
+		writeFile(path, "log_level=ERROR\nwatched=1\n");
+		config.loadFromFile(path);
+		Calls watched;
+		config.subscribe("watched", watched.callback());
+		bool watching = config.startWatching();
+		// The watch is set up on the watcher thread, so a save made right
+		// after startWatching() can come before it; save until one is seen
+		bool seen = false;
+		for (int attempt = 0; watching && !seen && attempt < 25; ++attempt) {
+			replaceFile(path, "log_level=ERROR\nwatched=2\n");
+			std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			seen = watched.waitFor(1, 0);
+		}
+		seen = seen && watched.values().front() == "2";
+		config.stopWatching();
+		ok &= report("The watcher reloads a file renamed over the old one", seen && !config.isWatching());
+
+		// Console output is toggled from the watcher thread in production
+		seneca::Logger& logger = seneca::Logger::getInstance();
+		logger.setLogLevel(seneca::LogLevel::INFO);
+		std::ostringstream captured;
+		std::streambuf* original = std::cout.rdbuf(captured.rdbuf());
+		logger.enableConsoleOutput(false);
+		LOG_INFO("hidden");
+		logger.enableConsoleOutput(true);
+		LOG_INFO("shown");
+		std::cout.rdbuf(original);
+		logger.setLogLevel(seneca::LogLevel::ERROR);
+		ok &= report("Console output follows enableConsoleOutput",
+		             captured.str().find("hidden") == std::string::npos && captured.str().find("shown") != std::string::npos);
+	}
+	catch (const std::exception& e) {
+		std::remove(path.c_str());
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+	std::remove(path.c_str());
+
+	if (!ok) {
+		std::cerr << "ERROR: configuration reload misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,243 @@
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include "seneca/APIServer.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Embedded HTTP server: published documents and routes must be served
+// over real sockets, keep-alive connections must carry several requests,
+// malformed and oversized requests must be refused, a document replaced
+// while workers serve it must always come back whole, and a job must be
+// answered at once and run off the workers, one at a time.
+
+struct Response
+{
+	int m_status{};
+	std::string m_body;
+};
+
+static int connectTo(int port)
+{
+	int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+	sockaddr_in addr{};
+	addr.sin_family = AF_INET;
+	addr.sin_port = htons(static_cast<uint16_t>(port));
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Reads one response off the connection; `pending` keeps bytes that
+// belong to the next one
+static Response readResponse(int fd, std::string& pending)
+{
+	char buffer[4096];
+	size_t headerEnd;
+	while ((headerEnd = pending.find("\r\n\r\n")) == std::string::npos) {
+		ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+		if (n <= 0)
+			throw std::runtime_error("connection closed before a response");
+		pending.append(buffer, size_t(n));
+	}
+	std::string head = pending.substr(0, headerEnd);
+	size_t length = 0;
+	size_t field = head.find("Content-Length: ");
+	if (field != std::string::npos)
+		length = std::strtoul(head.c_str() + field + 16, nullptr, 10);
+	while (pending.size() < headerEnd + 4 + length) {
+		ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+		if (n <= 0)
+			throw std::runtime_error("connection closed inside a body");
+		pending.append(buffer, size_t(n));
+	}
+
+	Response response;
+	response.m_status = std::atoi(head.c_str() + head.find(' ') + 1);
+	response.m_body = pending.substr(headerEnd + 4, length);
+	pending.erase(0, headerEnd + 4 + length);
+	return response;
+}
+
+static bool sendAll(int fd, const std::string& data)
+{
+	return ::send(fd, data.data(), data.size(), MSG_NOSIGNAL) == ssize_t(data.size());
+}
+
+// One request on its own connection
+static Response request(int port, const std::string& method, const std::string& target, const std::string& body = "")
+{
+	int fd = connectTo(port);
+	if (fd < 0)
+		throw std::runtime_error("cannot connect");
+	sendAll(fd, method + " " + target + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\nContent-Length: " +
+	                std::to_string(body.size()) + "\r\n\r\n" + body);
+	std::string pending;
+	Response response = readResponse(fd, pending);
+	::close(fd);
+	return response;
+}
+
+static std::string document(size_t version)
+{
+	return "{\"version\":" + std::to_string(version) + ",\"pad\":\"" + std::string(64 * 1024, char('a' + version % 26)) + "\"}";
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	seneca::APIServer& api = seneca::APIServer::getInstance();
+	std::atomic<bool> release{false};
+	try {
+		api.publish("/stats", "{\"total_orders\":3}");
+		api.addRoute("POST", "/echo", [](const std::string& body) { return "{\"echo\":\"" + body + "\"}"; });
+		api.addRoute("POST", "/fail", [](const std::string&) -> std::string { throw std::runtime_error("no \"luck\""); });
+		api.addJob("POST", "/slow", [&release](const std::string& body) {
+			while (!release)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			return "{\"job\":\"" + body + "\"}";
+		});
+		api.addJob("POST", "/broken", [](const std::string&) -> std::string { throw std::runtime_error("jammed"); });
+		if (!api.start(0, "127.0.0.1", 2) || api.getPort() <= 0) {
+			std::cerr << "ERROR: the server did not start\n";
+			std::exit(2);
+		}
+		int port = api.getPort();
+
+		Response health = request(port, "GET", "/health");
+		Response stats = request(port, "GET", "/stats?fresh=1");
+		ok &= report("Health and a document published before start",
+		             health.m_status == 200 && health.m_body == "{\"status\":\"healthy\"}" &&
+		             stats.m_status == 200 && stats.m_body == "{\"total_orders\":3}");
+
+		api.publish("/stats", "{\"total_orders\":4}");
+		ok &= report("A republished document replaces the old one", request(port, "GET", "/stats").m_body == "{\"total_orders\":4}");
+
+		Response echo = request(port, "POST", "/echo", "hi");
+		Response failed = request(port, "POST", "/fail");
+		ok &= report("Routes get the body; a throwing route is a 500 with the message",
+		             echo.m_status == 200 && echo.m_body == "{\"echo\":\"hi\"}" && failed.m_status == 500 &&
+		             failed.m_body == "{\"detail\":\"no \\\"luck\\\"\"}");
+
+		ok &= report("Unknown paths, wrong methods and OPTIONS",
+		             request(port, "GET", "/nothing").m_status == 404 && request(port, "POST", "/stats").m_status == 404 &&
+		             request(port, "GET", "/echo").m_status == 404 && request(port, "OPTIONS", "/stats").m_status == 204);
+
+		{
+			int fd = connectTo(port);
+			sendAll(fd, "GET /stats HTTP/1.1\r\n\r\nPOST /echo HTTP/1.1\r\nContent-Length: 3\r\n\r\nabcGET /health HTTP/1.1\r\n\r\n");
+			std::string pending;
+			Response first = readResponse(fd, pending);
+			Response second = readResponse(fd, pending);
+			Response third = readResponse(fd, pending);
+			::close(fd);
+			ok &= report("Pipelined requests on one keep-alive connection",
+			             first.m_body == "{\"total_orders\":4}" && second.m_body == "{\"echo\":\"abc\"}" &&
+			             third.m_status == 200);
+		}
+
+		{
+			int fd = connectTo(port);
+			sendAll(fd, "POST /echo HTTP/1.1\r\nContent-Length: 999999999\r\n\r\n");
+			std::string pending;
+			Response tooLarge = readResponse(fd, pending);
+			::close(fd);
+			fd = connectTo(port);
+			sendAll(fd, "\r\n\r\n");
+			pending.clear();
+			Response malformed = readResponse(fd, pending);
+			::close(fd);
+			ok &= report("Oversized bodies and malformed request lines are refused",
+			             tooLarge.m_status == 413 && malformed.m_status == 400);
+		}
+
+		{
+			// Readers on two threads while the document keeps changing: every
+			// response must be one whole published version
+			std::atomic<bool> publishing{true};
+			std::atomic<size_t> torn{0};
+			std::atomic<size_t> served{0};
+			api.publish("/big", document(0));
+			std::vector<std::thread> readers;
+			for (int r = 0; r < 2; ++r) {
+				readers.emplace_back([&]() {
+					while (publishing) {
+						Response big = request(port, "GET", "/big");
+						size_t version = std::strtoul(big.m_body.c_str() + 11, nullptr, 10);
+						torn += big.m_status != 200 || big.m_body != document(version);
+						served++;
+					}
+				});
+			}
+			for (size_t version = 1; version <= 200 || served < 20; ++version)
+				api.publish("/big", document(version));
+			publishing = false;
+			for (auto& reader : readers)
+				reader.join();
+			ok &= report("Documents replaced under concurrent readers come back whole", torn == 0 && served > 0);
+		}
+
+		{
+			// The job holds the executor until released; were it run on a
+			// worker, the first POST would not be answered
+			Response accepted = request(port, "POST", "/slow", "one");
+			Response busy = request(port, "POST", "/slow", "two");
+			Response other = request(port, "POST", "/broken");
+			bool running = api.isJobRunning();
+			release = true;
+			while (api.isJobRunning())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			Response result = request(port, "GET", "/slow");
+			Response broken = request(port, "POST", "/broken");
+			while (api.isJobRunning())
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			Response failure = request(port, "GET", "/broken");
+			ok &= report("Jobs are accepted at once, refused while one runs, and publish their result",
+			             accepted.m_status == 202 && accepted.m_body == "{\"status\":\"accepted\"}" &&
+			             busy.m_status == 409 && other.m_status == 409 && running && result.m_status == 200 &&
+			             result.m_body == "{\"job\":\"one\"}" && broken.m_status == 202 &&
+			             failure.m_body == "{\"detail\":\"jammed\"}");
+		}
+
+		api.stop();
+		int fd = connectTo(port);
+		if (fd >= 0)
+			::close(fd);
+		ok &= report("stop() closes the listener", !api.isRunning() && fd < 0);
+	}
+	catch (const std::exception& e) {
+		release = true;
+		api.stop();
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the HTTP server misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
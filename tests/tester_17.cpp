@@ -0,0 +1,166 @@
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "seneca/LineManager.h"
+#include "seneca/SimulationDaemon.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Daemon protocol: every connection carries one newline-terminated command
+// and gets one newline-terminated response; quoted words keep their spaces,
+// handler errors come back as JSON, a stalled client is dropped, a second
+// daemon cannot take the socket over, and "shutdown" ends run() cleanly.
+
+static int connectTo(const std::string& path)
+{
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un addr{};
+	addr.sun_family = AF_UNIX;
+	path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+	if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Sends `command` as is and returns the response line without its newline
+static std::string send(const std::string& path, const std::string& command)
+{
+	int fd = -1;
+	for (int attempt = 0; fd < 0 && attempt < 100; ++attempt) {
+		fd = connectTo(path);
+		if (fd < 0)
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+	if (fd < 0)
+		throw std::runtime_error("cannot connect to the daemon");
+	::write(fd, command.data(), command.size());
+	::shutdown(fd, SHUT_WR);
+	std::string response;
+	char buffer[4096];
+	for (ssize_t n; (n = ::read(fd, buffer, sizeof(buffer))) > 0;)
+		response.append(buffer, size_t(n));
+	::close(fd);
+	if (response.empty() || response.back() != '\n')
+		throw std::runtime_error("response without a newline: " + response);
+	response.pop_back();
+	return response;
+}
+
+// Runs the sample line to the end and counts the completed orders
+static size_t completedOrders(char** argv)
+{
+	std::vector<seneca::Workstation*> stations = loadStations(argv[1], argv[2]);
+	queueOrders(argv[3]);
+	size_t completed = 0;
+	{
+		seneca::LineManager lm(argv[4], stations);
+		std::ostream discard(nullptr);
+		while (!lm.run(discard));
+		completed = seneca::g_completed.size();
+	}
+	seneca::g_completed.clear();
+	seneca::g_incomplete.clear();
+	for (auto* station : stations)
+		delete station;
+	return completed;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	std::string path = "daemon_test_" + std::to_string(::getpid()) + ".sock";
+	try {
+		size_t expected = completedOrders(argv);
+
+		bool served = false;
+		std::thread server([&]() {
+			seneca::SimulationDaemon daemon(path, [&](const std::vector<std::string>& command) {
+				if (command[0] == "fail")
+					throw std::runtime_error("bad \"input\"");
+				if (command[0] == "run")
+					return "{\"completed\":" + std::to_string(completedOrders(argv)) + "}";
+				// The words as received, '|'-separated
+				std::string words;
+				for (const std::string& word : command)
+					words += (words.empty() ? "" : "|") + word;
+				return "{\"words\":\"" + words + "\"}";
+			}, 300);
+			served = daemon.run();
+		});
+
+		ok &= report("ping and an empty command",
+		             send(path, "ping\n") == "{\"status\":\"ok\"}" &&
+		             send(path, "   \n") == "{\"status\":\"error\",\"detail\":\"empty command\"}");
+
+		std::string runs;
+		for (int i = 0; i < 3; ++i)
+			runs += send(path, "run\n");
+		std::string one = "{\"completed\":" + std::to_string(expected) + "}";
+		ok &= report("Runs on a warm scenario, one per connection", runs == one + one + one);
+
+		std::string words = send(path, "open \"a b.txt\" plain \"say \\\"hi\\\"\"\nignored after the newline");
+		ok &= report("Quoted words keep their spaces and escapes",
+		             words == "{\"words\":\"open|a b.txt|plain|say \"hi\"\"}");
+
+		ok &= report("Handler errors come back as escaped JSON",
+		             send(path, "fail now\n") == "{\"status\":\"error\",\"detail\":\"bad \\\"input\\\"\"}");
+
+		ok &= report("A command without a newline is served at end of input", send(path, "last") == "{\"words\":\"last\"}");
+
+		{
+			// Served one at a time: a client stuck mid-command must not hold
+			// up the one behind it for longer than the command timeout
+			int stalled = connectTo(path);
+			::write(stalled, "ping", 4);
+			auto started = std::chrono::steady_clock::now();
+			std::string answer = send(path, "ping\n");
+			auto waited = std::chrono::steady_clock::now() - started;
+			::close(stalled);
+			ok &= report("A client stalled mid-command is dropped at the timeout",
+			             answer == "{\"status\":\"ok\"}" && waited < std::chrono::seconds(3));
+		}
+
+		{
+			seneca::SimulationDaemon second(path, [](const std::vector<std::string>&) { return std::string("{}"); });
+			bool refused = !second.run();
+			ok &= report("A second daemon leaves a socket that is still served alone",
+			             refused && send(path, "ping\n") == "{\"status\":\"ok\"}");
+		}
+
+		bool stopped = send(path, "shutdown\n") == "{\"status\":\"ok\"}";
+		server.join();
+		struct stat status;
+		ok &= report("shutdown ends run() and removes the socket", stopped && served && ::stat(path.c_str(), &status) != 0);
+	}
+	catch (const std::exception& e) {
+		::unlink(path.c_str());
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the daemon protocol misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
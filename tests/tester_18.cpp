@@ -0,0 +1,196 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include "seneca/LineManager.h"
+#include "seneca/EventPublisher.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Live event stream: frames are rate limited with frameDue(), go out to
+// every connected client in Server-Sent Events framing, never arrive torn
+// or out of order, a client that falls behind still gets the last frame,
+// a line run with the stream active ends with a "complete" frame, and a
+// socket another process serves is never taken over.
+
+static int connectTo(const std::string& path)
+{
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un addr{};
+	addr.sun_family = AF_UNIX;
+	path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+	if (fd >= 0 && ::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+		::close(fd);
+		return -1;
+	}
+	timeval timeout{0, 100 * 1000};
+	::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+	return fd;
+}
+
+static int listenOn(const std::string& path)
+{
+	int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un addr{};
+	addr.sun_family = AF_UNIX;
+	path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+	::unlink(path.c_str());
+	if (fd >= 0 && (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 4) != 0)) {
+		::close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Whatever arrives within 100 ms
+static std::string drain(int fd)
+{
+	std::string text;
+	char buffer[4096];
+	for (ssize_t n; (n = ::recv(fd, buffer, sizeof(buffer), 0)) > 0;)
+		text.append(buffer, size_t(n));
+	return text;
+}
+
+// Frames "event: <name>\ndata: <json>\n\n" of one event name, as their data
+static bool frames(const std::string& text, const std::string& event, std::vector<std::string>& data)
+{
+	std::string head = "event: " + event + "\ndata: ";
+	for (size_t at = 0; at < text.size();) {
+		size_t end = text.find("\n\n", at);
+		if (text.compare(at, head.size(), head) != 0 || end == std::string::npos)
+			return false;
+		data.push_back(text.substr(at + head.size(), end - at - head.size()));
+		at = end + 2;
+	}
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	std::string path = "events_test_" + std::to_string(::getpid()) + ".sock";
+	seneca::EventPublisher& events = seneca::EventPublisher::getInstance();
+	try {
+		events.publish("tick", "{}");
+		ok &= report("An inactive stream publishes nothing", !events.frameDue() && events.getFramesPublished() == 0);
+
+		// A socket file left by a crashed process is replaced; a live one is not
+		std::string other = path + ".live";
+		int live = listenOn(other);
+		::close(listenOn(path));
+		bool refused = !events.start(other) && !events.isActive();
+		int probe = connectTo(other);
+		refused &= probe >= 0;
+		::close(probe);
+		::close(live);
+		::unlink(other.c_str());
+		if (!events.start(path, 5.0)) {
+			std::cerr << "ERROR: the stream did not start\n";
+			std::exit(2);
+		}
+		ok &= report("A stale socket file is replaced; one another process serves is refused", refused);
+
+		bool first = events.frameDue();
+		bool again = events.frameDue();
+		std::this_thread::sleep_for(std::chrono::milliseconds(250));
+		ok &= report("frameDue() once per interval", first && !again && events.frameDue());
+
+		// Publish until the server has accepted the client and sent it a frame
+		int client = connectTo(path);
+		std::string received;
+		for (int attempt = 0; client >= 0 && received.empty() && attempt < 50; ++attempt) {
+			events.publish("tick", "{\"n\":0}");
+			received = drain(client);
+		}
+		std::vector<std::string> data;
+		ok &= report("A client gets Server-Sent Events frames",
+		             frames(received, "tick", data) && !data.empty() && data.back() == "{\"n\":0}");
+
+		int leaver = connectTo(path);
+		events.publish("tick", "{\"n\":0}");
+		drain(leaver);
+		::close(leaver);
+
+		for (int n = 1; n <= 2000; ++n)
+			events.publish("tick", "{\"n\":" + std::to_string(n) + "}");
+		data.clear();
+		bool whole = frames(drain(client), "tick", data) && !data.empty();
+		for (size_t i = 1; whole && i < data.size(); ++i)
+			whole = std::atoi(data[i].c_str() + 5) > std::atoi(data[i - 1].c_str() + 5);
+		ok &= report("Frames stay whole and in order, a client that left notwithstanding", whole);
+		std::cout << "  " << data.size() << " of 2000 frames delivered, " << events.getFramesCoalesced()
+		          << " coalesced" << std::endl;
+
+		{
+			// A frame larger than the socket buffers keeps this client draining
+			// when the next one arrives; that one must still follow it
+			int slow = connectTo(path);
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			events.publish("tick", "{\"pad\":\"" + std::string(4 * 1024 * 1024, 'x') + "\"}");
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			events.publish("complete", "{\"done\":1}");
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			std::string text = drain(slow);
+			::close(slow);
+			drain(client);
+			const std::string last = "event: complete\ndata: {\"done\":1}\n\n";
+			ok &= report("A client still draining a frame gets the last one after it",
+			             text.size() > last.size() && text.compare(text.size() - last.size(), last.size(), last) == 0);
+		}
+
+		{
+			std::vector<seneca::Workstation*> stations = loadStations(argv[1], argv[2]);
+			queueOrders(argv[3]);
+			{
+				seneca::LineManager lm(argv[4], stations);
+				std::ostream discard(nullptr);
+				while (!lm.run(discard));
+			}
+			seneca::g_completed.clear();
+			seneca::g_incomplete.clear();
+			for (auto* station : stations)
+				delete station;
+			std::string text = drain(client);
+			size_t last = text.rfind("event: ");
+			ok &= report("A line run ends its stream with a complete frame",
+			             last != std::string::npos && text.compare(last, 23, "event: complete\ndata: {") == 0 &&
+			             text.compare(text.size() - 2, 2, "\n\n") == 0);
+		}
+
+		events.stop();
+		::close(client);
+		struct stat status;
+		ok &= report("stop() closes the stream and removes the socket",
+		             !events.isActive() && !events.frameDue() && ::stat(path.c_str(), &status) != 0);
+	}
+	catch (const std::exception& e) {
+		events.stop();
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the event stream misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
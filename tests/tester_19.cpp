@@ -0,0 +1,141 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "seneca/LineManager.h"
+#include "seneca/StationMetrics.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Station metrics: the counters must add up to what the run did (units
+// handed out, orders passed on, one tick per station per iteration), read
+// consistently from another thread while the line runs, and survive a
+// snapshot/restore round trip unchanged.
+
+static bool sameStats(const seneca::StationStats& a, const seneca::StationStats& b)
+{
+	return a.m_fills == b.m_fills && a.m_failedFills == b.m_failedFills && a.m_ordersPassed == b.m_ordersPassed &&
+	       a.m_maxQueueDepth == b.m_maxQueueDepth && a.m_queueDepthSum == b.m_queueDepthSum &&
+	       a.m_busyTicks == b.m_busyTicks && a.m_idleTicks == b.m_idleTicks;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		{
+			seneca::StationMetrics metrics[2];
+			bool apart = alignof(seneca::StationMetrics) == seneca::CACHE_LINE_SIZE &&
+			             reinterpret_cast<const char*>(&metrics[1]) - reinterpret_cast<const char*>(&metrics[0]) >=
+			                     std::ptrdiff_t(seneca::CACHE_LINE_SIZE);
+			seneca::StationCounter counter;
+			counter.add();
+			counter.add(4);
+			counter.raise(3);
+			bool counted = counter.get() == 5;
+			counter.raise(9);
+			counted &= counter.get() == 9;
+			counter.reset();
+			counted &= counter.get() == 0;
+			ok &= report("Counters add, raise and reset; stations sit on their own cache lines", apart && counted);
+
+			for (size_t depth : {0, 2, 5, 1, 0})
+				metrics[0].recordTick(depth);
+			seneca::StationStats stats = metrics[0].snapshot();
+			ok &= report("A tick records depth, peak and busy or idle",
+			             stats.m_queueDepthSum == 8 && stats.m_maxQueueDepth == 5 && stats.m_busyTicks == 3 &&
+			             stats.m_idleTicks == 2 && stats.ticks() == 5 && stats.utilization() == 0.6 &&
+			             stats.meanQueueDepth() == 1.6 && seneca::StationStats{}.utilization() == 0.0 &&
+			             seneca::StationStats{}.meanQueueDepth() == 0.0);
+		}
+
+		std::vector<seneca::Workstation*> stations = loadStations(argv[1], argv[2]);
+		std::vector<size_t> initial;
+		for (const seneca::Workstation* station : stations)
+			initial.push_back(station->getQuantity());
+		const size_t orders = queueOrders(argv[3]);
+		size_t iterations = 1;
+		{
+			seneca::LineManager lm(argv[4], stations);
+
+			// Another thread reads the counters the way the API does; a
+			// counter it sees must never go backwards
+			std::atomic<bool> running{true};
+			std::atomic<bool> monotonic{true};
+			std::thread reader([&]() {
+				std::vector<seneca::StationStats> last(stations.size());
+				while (running) {
+					for (size_t s = 0; s < stations.size(); ++s) {
+						seneca::StationStats now = stations[s]->getMetrics().snapshot();
+						if (now.m_fills < last[s].m_fills || now.m_ordersPassed < last[s].m_ordersPassed ||
+						    now.ticks() < last[s].ticks())
+							monotonic = false;
+						last[s] = now;
+					}
+				}
+			});
+			std::ostream discard(nullptr);
+			while (!lm.run(discard))
+				iterations++;
+			running = false;
+			reader.join();
+			ok &= report("Counters read during the run never go backwards", monotonic.load());
+		}
+
+		uint64_t fills = 0;
+		bool counted = true;
+		for (size_t s = 0; s < stations.size(); ++s) {
+			seneca::StationStats stats = stations[s]->getMetrics().snapshot();
+			fills += stats.m_fills;
+			counted &= stats.m_fills == initial[s] - stations[s]->getQuantity() && stats.ticks() == iterations &&
+			           stats.m_ordersPassed == orders && stats.m_busyTicks >= 1 &&
+			           stats.m_maxQueueDepth <= orders && stats.m_queueDepthSum >= stats.m_busyTicks &&
+			           stats.m_queueDepthSum <= stats.m_maxQueueDepth * stats.m_busyTicks &&
+			           (stats.m_failedFills == 0 || stations[s]->getQuantity() == 0);
+		}
+		uint64_t filled = 0;
+		for (const auto& order : seneca::g_completed)
+			filled += order.getFilledItemCount();
+		for (const auto& order : seneca::g_incomplete)
+			filled += order.getFilledItemCount();
+		ok &= report("Fills match stock used and items filled; one tick per iteration; every order passed",
+		             counted && fills == filled);
+
+		seneca::Workstation* first = stations.front();
+		seneca::StationStats before = first->getMetrics().snapshot();
+		first->resetMetrics();
+		bool cleared = sameStats(first->getMetrics().snapshot(), seneca::StationStats{});
+		first->restoreMetrics(before);
+		ok &= report("A snapshot restores exactly what it recorded",
+		             cleared && sameStats(first->getMetrics().snapshot(), before));
+
+		seneca::g_completed.clear();
+		seneca::g_incomplete.clear();
+		for (auto* station : stations)
+			delete station;
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: station metrics do not add up\n";
+		std::exit(3);
+	}
+	return 0;
+}
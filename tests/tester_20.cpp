@@ -0,0 +1,137 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "seneca/OrderTable.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Order table: per-order fill counts must be right wherever an order's
+// items fall in the packed fill bitmap, per-product summaries and the
+// aggregate scans must agree with the orders, serials and ticks keep all
+// 64 bits, and the CSV export quotes what needs quoting.
+
+static const uint64_t BIG = uint64_t(1) << 40;
+
+// An order of `items` items named after `product`'s parts; item k is
+// filled when `filled(k)`, with a serial past 32 bits
+template <typename Filled>
+static seneca::CustomerOrder makeOrder(const std::string& name, const std::string& product, size_t items, Filled filled)
+{
+	std::vector<std::string> names;
+	for (size_t k = 0; k < items; ++k)
+		names.push_back(product + " part " + std::to_string(k % 3));
+	seneca::CustomerOrder order(name, product, names);
+	for (size_t k = 0; k < items; ++k)
+		if (filled(k))
+			order.setItemFilled(k, BIG + k);
+	return order;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		// Sizes chosen so orders start and end on, just before and just
+		// after 64-bit word boundaries, and one spans several whole words
+		const size_t sizes[] = {0, 1, 62, 1, 64, 65, 200, 3, 63};
+		std::vector<seneca::CustomerOrder> orders;
+		for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+			std::string product = i % 2 ? "Desk" : "Chair";
+			orders.push_back(makeOrder("Customer " + std::to_string(i), product, sizes[i],
+			                           [i](size_t k) { return (k * 7 + i) % 3 != 0; }));
+			orders.back().markEntry(BIG + i);
+			if (i % 3 != 2)
+				orders.back().markRetired(BIG + 100 + i);
+		}
+
+		seneca::OrderTable table;
+		table.reserve(orders.size(), 600);
+		for (size_t i = 0; i < orders.size(); ++i)
+			table.append(orders[i], i % 4 == 1 ? seneca::OrderOutcome::INCOMPLETE : seneca::OrderOutcome::COMPLETED);
+
+		bool counted = table.size() == orders.size();
+		size_t items = 0, filled = 0;
+		for (size_t i = 0; counted && i < orders.size(); ++i) {
+			size_t bits = 0;
+			for (uint64_t k = table.firstItem(i); k < table.firstItem(i) + table.orderItemCount(i); ++k)
+				bits += table.isItemFilled(k);
+			counted &= table.orderItemCount(i) == sizes[i] && table.filledItemCount(i) == bits &&
+			           bits == orders[i].getFilledItemCount();
+			items += sizes[i];
+			filled += bits;
+		}
+		ok &= report("Per-order fill counts across word boundaries",
+		             counted && table.itemCount() == items && table.filledItemCount() == filled);
+
+		bool wide = true;
+		for (size_t i = 0; i < orders.size(); ++i) {
+			wide &= table.entryTick(i) == BIG + i && table.retireTick(i) == (i % 3 != 2 ? BIG + 100 + i : 0) &&
+			        table.customerName(i) == "Customer " + std::to_string(i);
+			for (size_t k = 0; k < sizes[i]; ++k)
+				if (orders[i].getItem(k).m_isFilled)
+					wide &= table.itemSerial(table.firstItem(i) + k) == BIG + k;
+		}
+		ok &= report("Names, ticks and serials come back whole", wide);
+
+		std::vector<seneca::ProductSummary> summaries = table.summarizeByProduct();
+		bool summed = summaries.size() == 2;
+		for (const auto& summary : summaries) {
+			seneca::ProductSummary expected;
+			for (size_t i = 0; i < orders.size(); ++i) {
+				if (table.productName(i) != table.name(summary.m_product))
+					continue;
+				expected.m_orders++;
+				expected.m_completed += table.outcome(i) == seneca::OrderOutcome::COMPLETED;
+				expected.m_items += sizes[i];
+				expected.m_filledItems += orders[i].getFilledItemCount();
+			}
+			summed &= summary.m_orders == expected.m_orders && summary.m_completed == expected.m_completed &&
+			          summary.m_items == expected.m_items && summary.m_filledItems == expected.m_filledItems;
+		}
+		ok &= report("Summaries by product and outcome counts",
+		             summed && table.count(seneca::OrderOutcome::COMPLETED) == 7 &&
+		             table.count(seneca::OrderOutcome::INCOMPLETE) == 2 && table.count(seneca::OrderOutcome::PENDING) == 0);
+
+		seneca::OrderTable small;
+		small.append(makeOrder("Smith, \"Jo\"", "Lamp", 2, [](size_t k) { return k == 0; }),
+		             seneca::OrderOutcome::INCOMPLETE);
+		seneca::CustomerOrder done = makeOrder("Lee", "Lamp", 1, [](size_t) { return true; });
+		done.markEntry(BIG);
+		done.markRetired(BIG + 5);
+		small.append(done, seneca::OrderOutcome::COMPLETED);
+		std::ostringstream csv;
+		small.exportCsv(csv);
+		ok &= report("CSV export quotes names and writes 64-bit ticks",
+		             csv.str() == "customer,product,outcome,filled_items,total_items,entry_tick,retire_tick\n"
+		                          "\"Smith, \"\"Jo\"\"\",Lamp,incomplete,1,2,0,0\n"
+		                          "Lee,Lamp,completed,1,1," + std::to_string(BIG) + "," + std::to_string(BIG + 5) + "\n");
+
+		small.clear();
+		ok &= report("clear() empties every column", small.size() == 0 && small.itemCount() == 0 &&
+		             small.filledItemCount() == 0 && small.summarizeByProduct().empty());
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the order table does not match its orders\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "seneca/LatencyHistogram.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Latency histograms: buckets must tile the whole 64-bit range with no gap
+// or overlap (one value per bucket below 32, then 16 per power of two),
+// percentiles of known distributions must land within a bucket of the
+// exact answer and never below it, and the recorder must group orders by
+// product and outcome.
+
+using seneca::LatencyHistogram;
+
+// The bucket holding `value` contains it, maps both its ends back to
+// itself, stays within 1/16 of its lowest value, and ends where the next
+// one starts
+static bool bucketHolds(uint64_t value)
+{
+	size_t index = LatencyHistogram::bucketIndex(value);
+	uint64_t low = LatencyHistogram::bucketLowest(index);
+	uint64_t high = LatencyHistogram::bucketHighest(index);
+	bool ok = low <= value && value <= high && LatencyHistogram::bucketIndex(low) == index &&
+	          LatencyHistogram::bucketIndex(high) == index && high - low <= low / 16;
+	if (high != UINT64_MAX)
+		ok &= LatencyHistogram::bucketIndex(high + 1) == index + 1 && LatencyHistogram::bucketLowest(index + 1) == high + 1;
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		bool exact = true;
+		for (uint64_t v = 0; v < 32; ++v)
+			exact &= LatencyHistogram::bucketIndex(v) == v && LatencyHistogram::bucketLowest(v) == v &&
+			         LatencyHistogram::bucketHighest(v) == v;
+		exact &= LatencyHistogram::bucketIndex(32) == 32 && LatencyHistogram::bucketHighest(32) == 33 &&
+		         LatencyHistogram::bucketIndex(63) == 47 && LatencyHistogram::bucketLowest(47) == 62 &&
+		         LatencyHistogram::bucketIndex(64) == 48 && LatencyHistogram::bucketHighest(48) == 67;
+		ok &= report("One bucket per value below 32, then 16 per power of two", exact);
+
+		bool tiled = true;
+		for (unsigned bit = 0; bit < 64; ++bit) {
+			uint64_t power = uint64_t(1) << bit;
+			for (uint64_t v : {power - 1, power, power + 1, power + power / 3, power + power / 2 + 1})
+				tiled &= bucketHolds(v);
+		}
+		for (uint64_t v = 0; v < 5000; ++v)
+			tiled &= bucketHolds(v);
+		tiled &= bucketHolds(UINT64_MAX) && LatencyHistogram::bucketHighest(LatencyHistogram::bucketIndex(UINT64_MAX)) == UINT64_MAX;
+		ok &= report("Buckets tile the 64-bit range at power-of-two edges, within 1/16", tiled);
+
+		LatencyHistogram empty;
+		ok &= report("An empty histogram reports zeros", empty.count() == 0 && empty.min() == 0 && empty.max() == 0 &&
+		             empty.mean() == 0.0 && empty.percentile(0.5) == 0);
+
+		LatencyHistogram small;
+		for (uint64_t v = 1; v <= 20; ++v)
+			small.record(v);
+		ok &= report("Exact percentiles, min, max, count and mean for small values",
+		             small.count() == 20 && small.min() == 1 && small.max() == 20 && small.mean() == 10.5 &&
+		             small.percentile(0.5) == 10 && small.percentile(0.9) == 18 && small.percentile(0.01) == 1 &&
+		             small.percentile(1.0) == 20 && small.percentile(0.0) == 1);
+
+		// Uniform 1..100000: the value at rank q*n is exactly q*n
+		LatencyHistogram uniform, low, high;
+		for (uint64_t v = 1; v <= 100000; ++v) {
+			uniform.record(v);
+			(v <= 50000 ? low : high).record(v);
+		}
+		bool close = true;
+		for (double q : {0.25, 0.5, 0.9, 0.99, 0.999}) {
+			uint64_t truth = uint64_t(q * 100000);
+			uint64_t reported = uniform.percentile(q);
+			close &= reported >= truth && reported - truth <= truth / 16;
+		}
+		ok &= report("Uniform percentiles are never below the truth and within 1/16 of it",
+		             close && uniform.percentile(1.0) == 100000 && uniform.min() == 1 && uniform.mean() == 50000.5);
+
+		low.merge(high);
+		bool merged = low.count() == uniform.count() && low.min() == 1 && low.max() == 100000 && low.mean() == uniform.mean();
+		for (double q : {0.1, 0.5, 0.99})
+			merged &= low.percentile(q) == uniform.percentile(q);
+		ok &= report("Merging two halves gives the whole", merged);
+
+		// A bimodal distribution: 90% at 10, 10% at 1,000,000
+		LatencyHistogram bimodal;
+		bimodal.record(10, 900);
+		bimodal.record(1000000, 100);
+		ok &= report("Counted records and a bimodal tail",
+		             bimodal.count() == 1000 && bimodal.percentile(0.9) == 10 && bimodal.percentile(0.91) == 1000000 &&
+		             bimodal.percentile(0.5) == 10 && bimodal.max() == 1000000);
+		bimodal.reset();
+		ok &= report("reset() empties the histogram", bimodal.count() == 0 && bimodal.max() == 0 && bimodal.percentile(0.5) == 0);
+
+		// Orders stamped by hand: Chairs take 2..6 ticks, a Desk 9; one
+		// order never retired and is left out
+		seneca::LatencyRecorder recorder;
+		std::vector<seneca::CustomerOrder> orders;
+		for (size_t i = 0; i < 6; ++i) {
+			orders.emplace_back("Customer " + std::to_string(i), i == 5 ? "Desk" : "Chair", std::vector<std::string>{"Bolt"});
+			orders.back().markEntry(10);
+			if (i != 4)
+				orders.back().markRetired(i == 5 ? 19 : 12 + i);
+		}
+		for (size_t i = 0; i < orders.size(); ++i)
+			recorder.record(orders[i], i != 3);
+
+		bool grouped = true;
+		size_t groups = 0;
+		for (const auto& s : recorder.summarize()) {
+			if (s.m_metric != "ticks")
+				continue;
+			groups++;
+			if (s.m_product == "Chair" && s.m_completed)
+				grouped &= s.m_count == 3 && s.m_p50 == 3 && s.m_max == 4 && s.m_mean == 3.0;
+			else if (s.m_product == "Chair")
+				grouped &= s.m_count == 1 && s.m_p50 == 5 && s.m_max == 5;
+			else if (s.m_product == "Desk")
+				grouped &= s.m_completed && s.m_count == 1 && s.m_p999 == 9;
+			else if (s.m_product == "*" && s.m_completed)
+				grouped &= s.m_count == 4 && s.m_max == 9 && s.m_p50 == 3;
+			else
+				grouped &= s.m_product == "*" && s.m_count == 1;
+		}
+		std::ostringstream table;
+		recorder.report(table);
+		ok &= report("The recorder groups retired orders by product and outcome",
+		             grouped && groups == 5 && table.str().find("Desk") != std::string::npos);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: latency histograms are off\n";
+		std::exit(3);
+	}
+	return 0;
+}
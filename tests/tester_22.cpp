@@ -0,0 +1,115 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "seneca/RunArena.h"
+#include "seneca/CustomerOrder.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Run arena: allocations must be aligned and counted (the intern set's own
+// nodes included), interning must return one copy per distinct string,
+// orders built under a Scope must share their product and item names, and
+// reset() must keep a buffer big enough for the largest run so far.
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::RunArena arena(256);
+		void* a = arena.allocate(3, 1);
+		void* b = arena.allocate(8, 64);
+		ok &= report("Allocations are aligned and counted",
+		             a && reinterpret_cast<uintptr_t>(b) % 64 == 0 && arena.bytesAllocated() == 11);
+
+		size_t before = arena.bytesAllocated();
+		std::string_view first = arena.copy("bolt");
+		std::string_view second = arena.copy("bolt");
+		ok &= report("copy() makes a NUL-terminated copy every time",
+		             first == "bolt" && first.data()[4] == '\0' && first.data() != second.data() &&
+		             arena.bytesAllocated() == before + 10);
+
+		before = arena.bytesAllocated();
+		std::string_view interned = arena.intern("nut");
+		size_t added = arena.bytesAllocated() - before;
+		before = arena.bytesAllocated();
+		std::string_view again = arena.intern(std::string("nut"));
+		ok &= report("intern() keeps one copy and counts the set's node with it",
+		             interned == "nut" && again.data() == interned.data() && added > 4 &&
+		             arena.bytesAllocated() == before && arena.intern("washer") != interned);
+
+		before = arena.bytesAllocated();
+		{
+			std::pmr::vector<uint64_t> column(arena.resource());
+			column.resize(100);
+		}
+		ok &= report("Containers on resource() are counted", arena.bytesAllocated() >= before + 800);
+
+		arena.reset();
+		bool emptied = arena.bytesAllocated() == 0 && arena.intern("nut") == "nut";
+		arena.reset();
+		for (int i = 0; i < 100; ++i)
+			arena.allocate(100);
+		size_t grown = arena.capacity();
+		arena.reset();
+		size_t kept = arena.capacity();
+		for (int i = 0; i < 100; ++i)
+			arena.allocate(100);
+		arena.reset();
+		ok &= report("reset() frees everything and keeps a buffer for the largest run",
+		             emptied && grown < 10000 && kept >= 10000 && arena.capacity() == kept);
+
+		bool scoped = seneca::RunArena::current() == nullptr;
+		{
+			seneca::RunArena::Scope outer(arena);
+			seneca::RunArena other;
+			{
+				seneca::RunArena::Scope inner(other);
+				scoped &= seneca::RunArena::current() == &other;
+			}
+			scoped &= seneca::RunArena::current() == &arena;
+		}
+		scoped &= seneca::RunArena::current() == nullptr;
+		ok &= report("Scopes nest and restore the previous arena", scoped);
+
+		bool shared;
+		{
+			seneca::RunArena::Scope scope(arena);
+			size_t start = arena.bytesAllocated();
+			seneca::CustomerOrder one("Ann", "Desk", std::vector<std::string>{"Leg", "Top", "Leg"});
+			seneca::CustomerOrder two(std::string("Bob"), std::string("Desk"), std::vector<std::string>{"Top"});
+			shared = one.getProduct().data() == two.getProduct().data() &&
+			         one.getItem(0).m_itemName.data() == one.getItem(2).m_itemName.data() &&
+			         one.getItem(1).m_itemName.data() == two.getItem(0).m_itemName.data() &&
+			         one.getCustomerName() == "Ann" && two.getCustomerName() == "Bob" &&
+			         arena.bytesAllocated() > start;
+		}
+		seneca::CustomerOrder heap("Cy", "Desk", std::vector<std::string>{"Leg", "Leg"});
+		shared &= heap.getItem(0).m_itemName == "Leg" && heap.getItem(1).m_itemName == "Leg";
+		arena.reset();
+		ok &= report("Orders in a scope share interned products and item names", shared);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the run arena misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,106 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "seneca/OrderPool.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Order pool and queues: an order keeps its address from acquire() to
+// release() however far the pool grows, a released slot is emptied and
+// handed out again, pushing an order moves it into the pool, and a handle
+// taken with frontHandle()/pop_front() belongs to whichever queue it is
+// pushed to next.
+
+static seneca::CustomerOrder makeOrder(size_t n)
+{
+	return seneca::CustomerOrder("Customer " + std::to_string(n), "Desk", std::vector<std::string>{"Leg", "Top"});
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::OrderPool pool;
+		seneca::OrderHandle first = pool.acquire(makeOrder(0));
+		const seneca::CustomerOrder* address = &pool.get(first);
+		bool stable = first == 0;
+		for (size_t n = 1; n < 10000; ++n)
+			stable &= pool.acquire(makeOrder(n)) == n;
+		stable &= &pool.get(first) == address && pool.get(first).getCustomerName() == "Customer 0" &&
+		          pool.get(9999).getCustomerName() == "Customer 9999" && pool.size() == 10000;
+		ok &= report("Handles are dense and orders keep their address as the pool grows", stable);
+
+		pool.release(5);
+		pool.release(7000);
+		bool emptied = pool.get(5).getItemCount() == 0 && pool.get(5).getCustomerName().empty() && pool.size() == 9998;
+		seneca::OrderHandle reused = pool.acquire(makeOrder(20000));
+		seneca::OrderHandle next = pool.acquire(makeOrder(20001));
+		ok &= report("A released slot is emptied and its handle reused",
+		             emptied && reused == 7000 && next == 5 && pool.get(7000).getCustomerName() == "Customer 20000" &&
+		             pool.acquire(makeOrder(20002)) == 10000 && pool.size() == 10001);
+
+		pool.clear();
+		ok &= report("clear() starts the handles over", pool.size() == 0 && pool.acquire(makeOrder(1)) == 0);
+		pool.clear();
+
+		{
+			seneca::OrderQueue pending(pool);
+			seneca::OrderQueue done(pool);
+			seneca::CustomerOrder order = makeOrder(1);
+			pending.push_back(std::move(order));
+			for (size_t n = 2; n <= 4; ++n)
+				pending.push_back(makeOrder(n));
+			ok &= report("Pushing an order moves it into the pool",
+			             order.getItemCount() == 0 && order.getCustomerName().empty() && pending.size() == 4 &&
+			             pending.front().getCustomerName() == "Customer 1" && pending.front().getItemCount() == 2 &&
+			             pool.size() == 4);
+
+			// Move the first two on the way the line does, by handle
+			const seneca::CustomerOrder* moved = &pending.front();
+			for (int i = 0; i < 2; ++i) {
+				seneca::OrderHandle handle = pending.frontHandle();
+				pending.pop_front();
+				done.push_back(handle);
+			}
+			ok &= report("pop_front() hands the order over without releasing it",
+			             pool.size() == 4 && &done.front() == moved && done[1].getCustomerName() == "Customer 2" &&
+			             pending.front().getCustomerName() == "Customer 3" && pending.size() == 2 && done.size() == 2);
+
+			bool iterated = done.end() - done.begin() == 2 && (done.begin() + 1)->getCustomerName() == "Customer 2" &&
+			                done.begin().handle() == 0;
+			const seneca::OrderQueue& view = pending;
+			size_t seen = 0;
+			for (const seneca::CustomerOrder& o : view)
+				iterated &= o.getCustomerName() == "Customer " + std::to_string(3 + seen++);
+			ok &= report("Iterators walk the queue in order and expose handles", iterated && seen == 2);
+
+			done.clear();
+			ok &= report("clear() releases only the queue's own orders",
+			             done.empty() && pool.size() == 2 && pool.get(0).getItemCount() == 0 &&
+			             pending.front().getCustomerName() == "Customer 3");
+		}
+		ok &= report("A destroyed queue releases what it still holds", pool.size() == 0);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the order pool misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
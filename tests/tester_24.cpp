@@ -0,0 +1,112 @@
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/StationRegistry.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Station registry: a scenario lays its stations out with the ones on the
+// line first, in link order, then the ones the line never references;
+// every slot sits on its own cache line; lookups and stations() still
+// speak input order; and destroying or moving a registry tears down
+// exactly the workstations it built.
+
+static std::vector<seneca::Station> makeStations(const std::vector<std::string>& names)
+{
+	std::vector<seneca::Station> stations;
+	for (size_t i = 0; i < names.size(); ++i)
+		stations.emplace_back(names[i], 1000 + i, 5, names[i] + " parts", names[i].size());
+	return stations;
+}
+
+static std::vector<std::string> slotNames(seneca::StationRegistry& registry)
+{
+	std::vector<std::string> names;
+	for (const seneca::Workstation& station : registry)
+		names.push_back(station.getItemName());
+	return names;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	try {
+		// Input order E A B C D; the line runs C -> A -> D, B and E are spare
+		seneca::Scenario scenario(makeStations({"E", "A", "B", "C", "D"}), std::vector<seneca::OrderSpec>{},
+		                          std::vector<seneca::StationLink>{{"C", "A"}, {"A", "D"}, {"D", ""}});
+		seneca::StationRegistry registry = scenario.createStations();
+		ok &= report("Line stations first in link order, then the unreferenced ones",
+		             slotNames(registry) == std::vector<std::string>{"C", "A", "D", "E", "B"});
+
+		std::vector<seneca::Workstation*> stations = registry.stations();
+		bool indexed = stations.size() == 5 && registry.find("A") == 1 && registry.find("E") == 3 &&
+		               registry.find("missing") == seneca::StationRegistry::npos;
+		const char* input[] = {"E", "A", "B", "C", "D"};
+		for (size_t i = 0; indexed && i < 5; ++i)
+			indexed &= stations[i]->getItemName() == input[i] && stations[i] == &registry[registry.slotOf(i)];
+		ok &= report("stations(), slotOf() and find() keep input order", indexed);
+
+		bool aligned = true;
+		for (size_t slot = 0; slot < registry.size(); ++slot)
+			aligned &= reinterpret_cast<uintptr_t>(&registry[slot]) % seneca::CACHE_LINE_SIZE == 0;
+		ok &= report("Every station starts on a cache line", aligned && alignof(seneca::Workstation) >= seneca::CACHE_LINE_SIZE);
+
+		seneca::StationRegistry plain(makeStations({"X", "Y", "X"}));
+		ok &= report("No layout keeps input order; a duplicate name finds the first",
+		             slotNames(plain) == std::vector<std::string>{"X", "Y", "X"} && plain.find("X") == 0);
+
+		size_t refused = 0;
+		for (const std::vector<size_t>& layout : {std::vector<size_t>{0, 1}, std::vector<size_t>{0, 0, 1},
+		                                           std::vector<size_t>{0, 1, 3}}) {
+			try {
+				seneca::StationRegistry bad(makeStations({"X", "Y", "Z"}), layout);
+			}
+			catch (const seneca::ValidationException&) {
+				refused++;
+			}
+		}
+		ok &= report("A layout that is not a permutation is refused", refused == 3);
+
+		// Orders queued at the stations live in the context's pool; only
+		// tearing down the workstations holding them gives them back
+		for (auto& station : registry)
+			station += seneca::CustomerOrder("Ann", "Desk", std::vector<std::string>{"A"});
+		seneca::Workstation* first = &registry[0];
+		seneca::StationRegistry moved(std::move(registry));
+		bool held = context.pool().size() == 5 && registry.size() == 0 && moved.size() == 5 && &moved[0] == first &&
+		            moved.find("D") == 2;
+		registry = std::move(plain);
+		held &= context.pool().size() == 5 && registry.size() == 3 && plain.size() == 0;
+		moved = seneca::StationRegistry();
+		ok &= report("Moves keep the stations in place; destruction releases their orders",
+		             held && context.pool().size() == 0 && moved.size() == 0 && registry[1].getItemName() == "Y");
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: the station registry misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+#include "seneca/LineManager.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Utilities.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Line topology: links that name an unknown station, a line where every
+// station is linked to from another, and a cycle must each be refused with
+// a ValidationException that says which; a refused line must leave no
+// fork behind on its stations, and a spare station or a blank line in the
+// link file is no error.
+
+using Links = std::vector<std::pair<std::string, std::string>>;
+
+struct Line
+{
+	std::vector<std::unique_ptr<seneca::Workstation>> m_owned;
+	std::vector<seneca::Workstation*> m_stations;
+
+	explicit Line(const std::vector<std::string>& names)
+	{
+		for (const std::string& name : names) {
+			m_owned.push_back(std::make_unique<seneca::Workstation>(seneca::Station(name, 1, 5, name, name.size())));
+			m_stations.push_back(m_owned.back().get());
+		}
+	}
+};
+
+// The message of the ValidationException building the line throws, or ""
+static std::string refusal(const Links& links, Line& line)
+{
+	try {
+		seneca::LineManager lm(links, line.m_stations);
+	}
+	catch (const seneca::ValidationException& e) {
+		return e.what();
+	}
+	return "";
+}
+
+static bool mentions(const std::string& message, const std::string& text)
+{
+	return message.find(text) != std::string::npos;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	std::string path = "topology_test_" + std::to_string(::getpid()) + ".txt";
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	try {
+		Line line({"A", "B", "C"});
+		ok &= report("A chain with a spare station is accepted",
+		             refusal({{"A", "B"}, {"B", ""}}, line).empty());
+
+		std::string from = refusal({{"A", "B"}, {"Sofa", "C"}, {"B", "C"}, {"C", ""}}, line);
+		std::string to = refusal({{"A", "B"}, {"B", "Lamp"}}, line);
+		ok &= report("A link to or from an unknown station is refused by name",
+		             mentions(from, "unknown station: Sofa") && mentions(to, "unknown station: Lamp"));
+
+		std::string closed = refusal({{"A", "B"}, {"B", "C"}, {"C", "A"}}, line);
+		ok &= report("A line where every station is linked to has no first station",
+		             mentions(closed, "no first station"));
+
+		std::string cycle = refusal({{"A", "B"}, {"B", "C"}, {"C", "B"}}, line);
+		ok &= report("A cycle behind the first station is refused", mentions(cycle, "cycle at station: B"));
+
+		// B forks to C and D, and D leads back to B
+		Line forked({"A", "B", "C", "D"});
+		std::string loop = refusal({{"A", "B"}, {"B", "C"}, {"B", "D"}, {"D", "B"}, {"C", ""}}, forked);
+		bool unhooked = true;
+		for (const seneca::Workstation* station : forked.m_stations)
+			unhooked &= station->getFork() == nullptr;
+		ok &= report("A refused forked line leaves no fork on its stations", mentions(loop, "cycle") && unhooked);
+
+		seneca::Utilities::setDelimiter('|');
+		{
+			std::ofstream file(path);
+			file << "A|B\n\nB|C\n   \nC\n";
+		}
+		Line filed({"A", "B", "C"});
+		bool read = false;
+		{
+			seneca::LineManager lm(path, filed.m_stations);
+			read = filed.m_stations[0]->getNextStation() == filed.m_stations[1] &&
+			       filed.m_stations[1]->getNextStation() == filed.m_stations[2] &&
+			       filed.m_stations[2]->getNextStation() == nullptr;
+		}
+		ok &= report("Blank lines in a link file are skipped", read);
+	}
+	catch (const std::exception& e) {
+		std::remove(path.c_str());
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+	std::remove(path.c_str());
+
+	if (!ok) {
+		std::cerr << "ERROR: line topology validation misbehaved\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/Scenario.h"
+#include "seneca/ServiceTime.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Scenario generator: the files written for a seed must be byte for byte
+// the same on every run and every platform, another seed must give other
+// files, and what is written must load through Scenario into exactly the
+// scenario build() returns.
+
+static const char* FILES[] = {"Stations1.txt", "Stations2.txt", "AssemblyLine.txt", "CustomerOrders.txt"};
+
+static std::string readFile(const std::string& path)
+{
+	std::ifstream in(path, std::ios::binary);
+	std::ostringstream text;
+	text << in.rdbuf();
+	return text.str();
+}
+
+// The four files of a scenario written into `directory`, concatenated
+static std::string generate(const seneca::GeneratorOptions& options, const std::string& directory)
+{
+	::mkdir(directory.c_str(), 0755);
+	seneca::ScenarioGenerator(options).writeFiles(directory);
+	std::string all;
+	for (const char* name : FILES)
+		all += readFile(directory + "/" + name) + '\0';
+	return all;
+}
+
+static void removeDirectory(const std::string& directory)
+{
+	for (const char* name : FILES)
+		std::remove((directory + "/" + name).c_str());
+	::rmdir(directory.c_str());
+}
+
+// FNV-1a: a fixed checksum, independent of the standard library. The
+// uniform options below draw only from splitmix64 streams, so the recorded
+// checksum holds on every platform.
+static uint64_t fnv1a(const std::string& text)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (unsigned char ch : text) {
+		hash ^= ch;
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static bool sameScenario(const seneca::Scenario& a, const seneca::Scenario& b)
+{
+	const auto& sa = a.getStations();
+	const auto& sb = b.getStations();
+	bool same = sa.size() == sb.size() && a.getOrders().size() == b.getOrders().size();
+	for (size_t i = 0; same && i < sa.size(); ++i)
+		same = sa[i].getItemName() == sb[i].getItemName() && sa[i].getQuantity() == sb[i].getQuantity() &&
+		       sa[i].getSerialNumber() == sb[i].getSerialNumber() && sa[i].getDescription() == sb[i].getDescription() &&
+		       sa[i].getServiceTime().toString() == sb[i].getServiceTime().toString();
+	for (size_t i = 0; same && i < a.getOrders().size(); ++i) {
+		const seneca::OrderSpec& oa = a.getOrders()[i];
+		const seneca::OrderSpec& ob = b.getOrders()[i];
+		same = oa.m_name == ob.m_name && oa.m_product == ob.m_product && oa.m_items == ob.m_items;
+	}
+	// The line file is written shuffled; the links, not their order, matter
+	std::vector<seneca::StationLink> la = a.getLinks();
+	std::vector<seneca::StationLink> lb = b.getLinks();
+	std::sort(la.begin(), la.end());
+	std::sort(lb.begin(), lb.end());
+	return same && la == lb;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	const std::string base = "generator_test_" + std::to_string(::getpid());
+	const std::string dirs[] = {base + "_a", base + "_b", base + "_c", base + "_d"};
+	try {
+		seneca::GeneratorOptions options;
+		options.m_stations = 12;
+		options.m_orders = 300;
+		options.m_products = 20;
+		options.m_scarcity = 0.8;
+		options.m_seed = 31;
+
+		std::string first = generate(options, dirs[0]);
+		std::string second = generate(options, dirs[1]);
+		std::cout << "  checksum " << std::hex << fnv1a(first) << std::dec << std::endl;
+		ok &= report("The same seed writes the same files, matching the recorded checksum",
+		             !first.empty() && first == second && fnv1a(first) == 0x7fa62c704646a5f9ull);
+
+		seneca::GeneratorOptions reseeded = options;
+		reseeded.m_seed = 32;
+		ok &= report("Another seed writes other files", generate(reseeded, dirs[2]) != first);
+
+		auto load = [](const std::string& dir) {
+			return seneca::Scenario(dir + "/Stations1.txt", dir + "/Stations2.txt", dir + "/CustomerOrders.txt",
+			                        dir + "/AssemblyLine.txt");
+		};
+		seneca::Scenario loaded = load(dirs[0]);
+		ok &= report("Written files load into the scenario build() returns",
+		             loaded.getStations().size() == 12 && loaded.getOrderCount() == 300 &&
+		             loaded.getLinks().size() == 12 && sameScenario(loaded, seneca::ScenarioGenerator(options).build()));
+
+		seneca::GeneratorOptions skewed = options;
+		skewed.m_distribution = seneca::ItemDistribution::ZIPF;
+		skewed.m_shuffleLines = false;
+		skewed.m_serviceTime = "exp:2";
+		generate(skewed, dirs[3]);
+		seneca::Scenario timed = load(dirs[3]);
+		bool serviced = !timed.getStations().empty();
+		for (const seneca::Station& station : timed.getStations())
+			serviced &= station.getServiceTime().m_kind == seneca::ServiceTime::Kind::EXPONENTIAL &&
+			            station.getServiceTime().m_a == 2.0;
+		ok &= report("Zipf demand, an ordered line and service times load too",
+		             sameScenario(timed, seneca::ScenarioGenerator(skewed).build()) && serviced);
+	}
+	catch (const std::exception& e) {
+		for (const std::string& dir : dirs)
+			removeDirectory(dir);
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+	for (const std::string& dir : dirs)
+		removeDirectory(dir);
+
+	if (!ok) {
+		std::cerr << "ERROR: generated scenarios are not reproducible\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/RunArena.h"
+#include "seneca/LineManager.h"
+#include "seneca/Logger.h"
+
+// Independent simulations: every thread runs the same scenario in its own
+// SimulationContext and must produce exactly the output of a single
+// run on the main thread.
+
+static std::string simulate(const seneca::Scenario& scenario)
+{
+	seneca::SimulationContext& context = seneca::SimulationContext::current();
+	std::ostringstream out;
+	{
+		seneca::StationRegistry registry = scenario.createStations();
+		std::vector<seneca::Workstation*> stations = registry.stations();
+		scenario.enqueueOrders();
+
+		seneca::LineManager lm(scenario.getLinks(), stations);
+		while (!lm.run(out));
+
+		for (const auto& o : context.completed())
+			o.display(out);
+		for (const auto& o : context.incomplete())
+			o.display(out);
+		for (const auto* station : stations)
+			station->Station::display(out, true);
+	}
+	context.clearOrders();
+	return out.str();
+}
+
+static bool runConcurrently(const char* name, const seneca::Scenario& scenario, size_t threads)
+{
+	// Reference run on this thread, in a fresh context like the workers'
+	std::string expected;
+	{
+		seneca::SimulationContext context;
+		seneca::SimulationContext::Scope contextScope(context);
+		expected = simulate(scenario);
+	}
+
+	std::vector<std::string> results(threads);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; ++t) {
+		workers.emplace_back([&scenario, &results, t]() {
+			seneca::SimulationContext context;
+			seneca::RunArena arena;
+			seneca::SimulationContext::Scope contextScope(context);
+			seneca::RunArena::Scope arenaScope(arena);
+			for (int run = 0; run < 3; ++run)
+				results[t] = simulate(scenario);
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+
+	size_t mismatches = 0;
+	for (const auto& result : results)
+		mismatches += result != expected;
+
+	std::cout << name << ": " << threads << " threads, " << expected.size() << " bytes of output per run, "
+	          << (mismatches ? std::to_string(mismatches) + " mismatched" : std::string("all identical")) << std::endl;
+	return mismatches == 0;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		ok &= runConcurrently("Sample data", sample, 8);
+
+		seneca::GeneratorOptions options;
+		options.m_stations = 200;
+		options.m_orders = 500;
+		options.m_scarcity = 0.3;
+		options.m_seed = 39;
+		seneca::Scenario generated = seneca::ScenarioGenerator(options).build();
+		ok &= runConcurrently("Generated scenario", generated, 8);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: concurrent simulations diverged from the single-threaded run\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/LineManager.h"
+#include "seneca/IncrementalEngine.h"
+#include "seneca/Logger.h"
+
+// Fast-forward engine: LineManager::fastForward() must leave exactly the
+// orders, serial numbers and inventory that running the line to
+// completion does. The incremental engine must agree with it after every
+// inventory change.
+
+static std::string finalState(const seneca::Scenario& scenario, bool fast)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	std::ostringstream out;
+
+	seneca::StationRegistry registry = scenario.createStations();
+	std::vector<seneca::Workstation*> stations = registry.stations();
+	scenario.enqueueOrders();
+
+	seneca::LineManager lm(scenario.getLinks(), stations);
+	if (fast) {
+		lm.fastForward();
+	}
+	else {
+		std::ostream discard(nullptr);
+		while (!lm.run(discard));
+	}
+
+	out << "Completed\n";
+	for (const auto& o : context.completed())
+		o.display(out);
+	out << "Incomplete\n";
+	for (const auto& o : context.incomplete())
+		o.display(out);
+	out << "Inventory\n";
+	for (const auto* station : stations)
+		station->Station::display(out, true);
+	context.clearOrders();
+	return out.str();
+}
+
+static bool check(const std::string& name, const seneca::Scenario& scenario)
+{
+	std::string simulated = finalState(scenario, false);
+	std::string fast = finalState(scenario, true);
+	std::cout << name << ": " << (simulated == fast ? "match" : "MISMATCH") << std::endl;
+	return simulated == fast;
+}
+
+// The engine's view of every order, rendered like CustomerOrder::display()
+static std::vector<std::string> engineOrders(const seneca::IncrementalEngine& engine, const seneca::Scenario& scenario)
+{
+	const size_t width = seneca::SimulationContext::current().orderWidth();
+	std::vector<std::string> orders;
+	for (size_t order = 0; order < engine.orderCount(); ++order) {
+		const seneca::OrderSpec& spec = scenario.getOrders()[order];
+		std::ostringstream out;
+		out << spec.m_name << " - " << spec.m_product << "\n";
+		for (size_t i = 0; i < spec.m_items.size(); ++i) {
+			out << "[" << std::right << std::setw(6) << std::setfill('0') << engine.itemSerial(order, i) << "] "
+			    << std::setw(width) << std::setfill(' ') << std::left << spec.m_items[i] << " - "
+			    << (engine.isItemFilled(order, i) ? "FILLED" : "TO BE FILLED") << "\n";
+		}
+		orders.push_back(out.str());
+	}
+	std::sort(orders.begin(), orders.end());
+	return orders;
+}
+
+static bool agrees(const seneca::IncrementalEngine& engine, const seneca::Scenario& scenario)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+
+	seneca::StationRegistry registry = scenario.createStations();
+	std::vector<seneca::Workstation*> stations = registry.stations();
+	scenario.enqueueOrders();
+	seneca::LineManager lm(scenario.getLinks(), stations);
+	lm.fastForward();
+
+	std::vector<std::string> orders;
+	for (const auto& o : context.completed()) {
+		std::ostringstream out;
+		o.display(out);
+		orders.push_back(out.str());
+	}
+	for (const auto& o : context.incomplete()) {
+		std::ostringstream out;
+		o.display(out);
+		orders.push_back(out.str());
+	}
+	std::sort(orders.begin(), orders.end());
+
+	bool ok = engine.completedCount() == context.completed().size() && orders == engineOrders(engine, scenario);
+	for (size_t i = 0; i < stations.size(); ++i)
+		ok &= engine.remainingQuantity(i) == stations[i]->getQuantity();
+	context.clearOrders();
+	return ok;
+}
+
+static bool checkIncremental(const std::string& name, const seneca::Scenario& scenario, uint64_t seed)
+{
+	seneca::IncrementalEngine engine(scenario);
+	std::vector<seneca::Station> stations = scenario.getStations();
+	std::mt19937_64 rng(seed);
+
+	bool ok = agrees(engine, scenario);
+	for (int step = 0; step < 25 && ok; ++step) {
+		size_t station = rng() % stations.size();
+		size_t quantity = rng() % 4 == 0 ? 0 : rng() % (2 * stations[station].getQuantity() + 20);
+		size_t before = engine.completedCount();
+
+		seneca::OutcomeDiff diff = engine.setQuantity(station, quantity);
+		stations[station].setQuantity(quantity);
+		ok &= engine.completedCount() == before + diff.m_completed.size() - diff.m_incomplete.size();
+
+		seneca::Scenario changed(std::vector<seneca::Station>(stations),
+		                         std::vector<seneca::OrderSpec>(scenario.getOrders()),
+		                         std::vector<seneca::StationLink>(scenario.getLinks()));
+		ok &= agrees(engine, changed);
+	}
+	std::cout << name << " (incremental): " << (ok ? "match" : "MISMATCH") << std::endl;
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		ok &= check("Sample data", sample);
+		ok &= checkIncremental("Sample data", sample, 42);
+
+		// Scarce and plentiful inventory, skewed demand, long and short lines
+		const double scarcity[] = {0.2, 0.7, 1.0, 1.5};
+		for (uint64_t seed = 1; seed <= 12; ++seed) {
+			seneca::GeneratorOptions options;
+			options.m_stations = 5 + seed * 17;
+			options.m_orders = 300 + seed * 40;
+			options.m_products = 40;
+			options.m_maxItems = 1 + seed % 9;
+			options.m_scarcity = scarcity[seed % 4];
+			options.m_distribution = seed % 2 ? seneca::ItemDistribution::ZIPF : seneca::ItemDistribution::UNIFORM;
+			options.m_shuffleLines = seed % 3 != 0;
+			options.m_seed = seed;
+			std::string name = "Generated scenario " + std::to_string(seed) + " (" +
+			                   std::to_string(options.m_stations) + " stations, " +
+			                   std::to_string(options.m_orders) + " orders)";
+			seneca::Scenario generated = seneca::ScenarioGenerator(options).build();
+			ok &= check(name, generated);
+			ok &= checkIncremental(name, generated, seed);
+		}
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: fast-forward or incremental results differ from the simulated run\n";
+		std::exit(3);
+	}
+	return 0;
+}
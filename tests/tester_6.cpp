@@ -0,0 +1,140 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/LineManager.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+#include "TestSupport.h"
+
+// Checkpoint and restore: a run checkpointed at some iteration and resumed
+// on a freshly built line must print the same trace from there on and end
+// in exactly the state of the uninterrupted run.
+
+// Runs the scenario to the end; checkpoints after `at` iterations when
+// `save` is set, or resumes from `path` when it is not
+static std::string run(const seneca::Scenario& scenario, const std::string& path, size_t at, bool save)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+
+	seneca::StationRegistry registry = scenario.createStations();
+	std::vector<seneca::Workstation*> stations = registry.stations();
+	scenario.enqueueOrders();
+	seneca::LineManager lm(scenario.getLinks(), stations);
+
+	std::ostringstream trace;
+	std::ostream discard(nullptr);
+	bool done = false;
+	if (save) {
+		while (!done && lm.getIterationCount() < at)
+			done = lm.run(discard);
+		lm.saveCheckpoint(path);
+	}
+	else {
+		lm.restoreCheckpoint(path);
+	}
+	while (!done)
+		done = lm.run(trace);
+
+	std::string result = trace.str() + finalState(context, stations, true);
+	context.clearOrders();
+	return result;
+}
+
+static bool check(const std::string& name, const seneca::Scenario& scenario, size_t at)
+{
+	std::string path = "checkpoint_test_" + std::to_string(::getpid()) + ".ckpt";
+	std::string uninterrupted = run(scenario, path, at, true);
+	std::string resumed = run(scenario, path, at, false);
+	std::remove(path.c_str());
+	bool ok = uninterrupted == resumed;
+	std::cout << name << ", checkpoint at iteration " << at << ": " << (ok ? "match" : "MISMATCH") << std::endl;
+	return ok;
+}
+
+template <typename Exception>
+static bool rejects(const std::string& name, const seneca::Scenario& scenario, const std::string& path)
+{
+	bool thrown = false;
+	try {
+		run(scenario, path, 0, false);
+	}
+	catch (const Exception& e) {
+		thrown = true;
+	}
+	std::cout << name << ": " << (thrown ? "rejected" : "ACCEPTED") << std::endl;
+	return thrown;
+}
+
+// A damaged file or another line's checkpoint must never be restored
+static bool checkRejected(const seneca::Scenario& scenario, const seneca::Scenario& other)
+{
+	std::string path = "checkpoint_test_" + std::to_string(::getpid()) + ".ckpt";
+	run(scenario, path, 3, true);
+
+	bool ok = rejects<seneca::ValidationException>("Checkpoint of another line", other, path);
+
+	std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	file.seekp(size - 3);
+	file.put('#');
+	file.close();
+	ok &= rejects<seneca::FileException>("Corrupted checkpoint", scenario, path);
+
+	::truncate(path.c_str(), size / 2);
+	ok &= rejects<seneca::FileException>("Truncated checkpoint", scenario, path);
+
+	std::remove(path.c_str());
+	ok &= rejects<seneca::FileException>("Missing checkpoint", scenario, path);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		seneca::Scenario sample(argv[1], argv[2], argv[3], argv[4]);
+		for (size_t at : {0, 1, 4, 9})
+			ok &= check("Sample data", sample, at);
+
+		seneca::GeneratorOptions options;
+		options.m_stations = 150;
+		options.m_orders = 600;
+		options.m_scarcity = 0.5;
+		options.m_seed = 43;
+		seneca::Scenario generated = seneca::ScenarioGenerator(options).build();
+		for (size_t at : {1, 100, 400, 700})
+			ok &= check("Generated scenario", generated, at);
+
+		ok &= checkRejected(sample, generated);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: checkpoint restore diverged from the uninterrupted run\n";
+		std::exit(3);
+	}
+	return 0;
+}
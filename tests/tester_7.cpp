@@ -0,0 +1,158 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioFile.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/LineManager.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+// Compiled scenarios: a scenario written by ScenarioFile and loaded back
+// must run exactly like the text files it was compiled from.
+
+// Loads the scenario in a fresh context and runs it to the end
+template <typename Load>
+static std::string simulate(Load load)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	seneca::Scenario scenario = load();
+	std::ostringstream out;
+
+	seneca::StationRegistry registry = scenario.createStations();
+	std::vector<seneca::Workstation*> stations = registry.stations();
+	for (const auto* station : stations)
+		station->Station::display(out, true);
+	scenario.enqueueOrders();
+
+	seneca::LineManager lm(scenario.getLinks(), stations);
+	while (!lm.run(out));
+
+	for (const auto& o : context.completed())
+		o.display(out);
+	for (const auto& o : context.incomplete())
+		o.display(out);
+	for (const auto* station : stations)
+		station->Station::display(out, true);
+	context.clearOrders();
+	return out.str();
+}
+
+static bool sameOrders(const seneca::Scenario& a, const seneca::Scenario& b)
+{
+	if (a.getOrderCount() != b.getOrderCount() || a.getOrders().size() != b.getOrders().size())
+		return false;
+	for (size_t i = 0; i < a.getOrders().size(); ++i) {
+		const seneca::OrderSpec& x = a.getOrders()[i];
+		const seneca::OrderSpec& y = b.getOrders()[i];
+		if (x.m_name != y.m_name || x.m_product != y.m_product || x.m_items != y.m_items)
+			return false;
+	}
+	return a.getLinks() == b.getLinks();
+}
+
+template <typename Load>
+static bool check(const std::string& name, Load loadText)
+{
+	std::string path = "scenario_test_" + std::to_string(::getpid()) + ".alsc";
+	{
+		seneca::SimulationContext context;
+		seneca::SimulationContext::Scope scope(context);
+		seneca::ScenarioFile::write(loadText(), path);
+	}
+
+	std::string fromText = simulate(loadText);
+	std::string fromCompiled = simulate([&path]() { return seneca::ScenarioFile::read(path); });
+	bool ok = fromText == fromCompiled;
+	{
+		seneca::SimulationContext context;
+		seneca::SimulationContext::Scope scope(context);
+		ok &= sameOrders(loadText(), seneca::ScenarioFile::read(path));
+	}
+	std::remove(path.c_str());
+
+	std::cout << name << ": " << (ok ? "match" : "MISMATCH") << std::endl;
+	return ok;
+}
+
+static bool rejects(const std::string& name, const std::string& path)
+{
+	bool thrown = false;
+	try {
+		seneca::ScenarioFile::read(path);
+	}
+	catch (const seneca::FileException&) {
+		thrown = true;
+	}
+	std::cout << name << ": " << (thrown ? "rejected" : "ACCEPTED") << std::endl;
+	return thrown;
+}
+
+static bool checkRejected(const seneca::Scenario& scenario, const std::string& textFile)
+{
+	std::string path = "scenario_test_" + std::to_string(::getpid()) + ".alsc";
+	seneca::ScenarioFile::write(scenario, path);
+
+	std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	file.seekp(size / 2);
+	file.put('#');
+	file.close();
+	bool ok = rejects("Corrupted compiled scenario", path);
+
+	::truncate(path.c_str(), size - 8);
+	ok &= rejects("Truncated compiled scenario", path);
+
+	std::remove(path.c_str());
+	ok &= rejects("Missing compiled scenario", path);
+	ok &= rejects("Text file as compiled scenario", textFile);
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	try {
+		ok &= check("Sample data", [argv]() { return seneca::Scenario(argv[1], argv[2], argv[3], argv[4]); });
+
+		for (uint64_t seed = 1; seed <= 4; ++seed) {
+			seneca::GeneratorOptions options;
+			options.m_stations = 20 + seed * 30;
+			options.m_orders = 200 + seed * 150;
+			options.m_scarcity = 0.4 * double(seed);
+			options.m_seed = seed;
+			ok &= check("Generated scenario " + std::to_string(seed),
+			            [options]() { return seneca::ScenarioGenerator(options).build(); });
+		}
+
+		ok &= checkRejected(seneca::Scenario(argv[1], argv[2], argv[3], argv[4]), argv[3]);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+
+	if (!ok) {
+		std::cerr << "ERROR: compiled scenarios differ from their text files\n";
+		std::exit(3);
+	}
+	return 0;
+}
@@ -0,0 +1,216 @@
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/Utilities.h"
+#include "seneca/Station.h"
+#include "seneca/CustomerOrder.h"
+#include "seneca/Logger.h"
+
+// Reentrant tokenizing: parsers with different delimiters must not see each
+// other, and a scenario loaded in parallel must match a plain sequential
+// load of the same files.
+
+// Every thread splits the same fields with its own delimiter while another
+// thread keeps changing the default one
+static bool checkTokenizers(size_t threads)
+{
+	const std::vector<std::string> fields{"Desk", "12345", "  7 ", "Standing desk, oak"};
+	const std::string delimiters = ",|/;:#%~";
+
+	std::atomic<bool> stop{false};
+	std::thread flipper([&stop, &delimiters]() {
+		for (size_t i = 0; !stop.load(); ++i)
+			seneca::Utilities::setDelimiter(delimiters[i % delimiters.size()]);
+	});
+
+	std::vector<size_t> failures(threads, 0);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < threads; ++t) {
+		workers.emplace_back([&, t]() {
+			char delimiter = delimiters[t % delimiters.size()];
+			std::string record;
+			for (const auto& field : fields)
+				record += (record.empty() ? "" : std::string(1, delimiter)) + field;
+			// The description holds a ',' and must stay whole for every other delimiter
+			size_t expectedTokens = delimiter == ',' ? fields.size() + 1 : fields.size();
+
+			for (int round = 0; round < 20000; ++round) {
+				seneca::Utilities ut(delimiter);
+				size_t next_pos = 0;
+				bool more = true;
+				size_t count = 0;
+				while (more) {
+					std::string token = ut.extractToken(record, next_pos, more);
+					failures[t] += ut.delimiter() != delimiter;
+					failures[t] += count == 0 && token != "Desk";
+					failures[t] += count == 2 && token != "7";
+					++count;
+				}
+				failures[t] += count != expectedTokens;
+			}
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+	stop = true;
+	flipper.join();
+
+	size_t total = 0;
+	for (size_t f : failures)
+		total += f;
+	std::cout << "Concurrent tokenizers: " << threads << " threads, "
+	          << (total ? std::to_string(total) + " wrong tokens" : std::string("all tokens correct")) << std::endl;
+	return total == 0;
+}
+
+// The scenario as the original loader read it: one file after another,
+// switching the default delimiter in between
+static seneca::Scenario loadSequentially(const std::string& stations1, const std::string& stations2,
+                                         const std::string& orders, const std::string& line)
+{
+	std::vector<seneca::Station> stations;
+	std::vector<seneca::OrderSpec> specs;
+	std::vector<seneca::StationLink> links;
+	std::string record;
+
+	seneca::Utilities::setDelimiter(',');
+	std::ifstream file(stations1);
+	while (std::getline(file, record))
+		if (!record.empty())
+			stations.emplace_back(record);
+	file = std::ifstream(stations2);
+	seneca::Utilities::setDelimiter('|');
+	while (std::getline(file, record))
+		if (!record.empty())
+			stations.emplace_back(record);
+
+	file = std::ifstream(orders);
+	while (std::getline(file, record)) {
+		if (record.empty())
+			continue;
+		seneca::Utilities ut;
+		size_t next_pos = 0;
+		bool more = true;
+		seneca::OrderSpec spec;
+		spec.m_name = ut.extractToken(record, next_pos, more);
+		spec.m_product = ut.extractToken(record, next_pos, more);
+		while (more)
+			spec.m_items.push_back(ut.extractToken(record, next_pos, more));
+		specs.push_back(std::move(spec));
+	}
+
+	file = std::ifstream(line);
+	while (std::getline(file, record)) {
+		seneca::Utilities ut;
+		size_t next_pos = 0;
+		bool more = true;
+		std::string name = ut.extractToken(record, next_pos, more);
+		std::string next = more ? ut.extractToken(record, next_pos, more) : "";
+		links.emplace_back(name, next);
+	}
+	return seneca::Scenario(std::move(stations), std::move(specs), std::move(links));
+}
+
+static std::string describe(const seneca::Scenario& scenario)
+{
+	std::ostringstream out;
+	for (const auto& station : scenario.getStations())
+		station.display(out, true);
+	for (const auto& spec : scenario.getOrders()) {
+		out << spec.m_name << '|' << spec.m_product;
+		for (const auto& item : spec.m_items)
+			out << '|' << item;
+		out << '\n';
+	}
+	for (const auto& link : scenario.getLinks())
+		out << link.first << "->" << link.second << '\n';
+	return out.str();
+}
+
+template <typename Load>
+static std::string loadInContext(Load load)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	return describe(load());
+}
+
+static bool check(const std::string& name, const std::string& stations1, const std::string& stations2,
+                  const std::string& orders, const std::string& line)
+{
+	std::string expected = loadInContext([&]() { return loadSequentially(stations1, stations2, orders, line); });
+
+	// A default delimiter left at something else must not matter
+	seneca::Utilities::setDelimiter('#');
+	bool ok = loadInContext([&]() { return seneca::Scenario(stations1, stations2, orders, line); }) == expected;
+
+	// Neither must other loads running at the same time
+	std::vector<std::string> results(4);
+	std::vector<std::thread> workers;
+	for (size_t t = 0; t < results.size(); ++t) {
+		workers.emplace_back([&, t]() {
+			results[t] = loadInContext([&]() { return seneca::Scenario(stations1, stations2, orders, line); });
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+	for (const auto& result : results)
+		ok &= result == expected;
+
+	std::cout << name << ": " << expected.size() << " bytes parsed, " << (ok ? "match" : "MISMATCH") << std::endl;
+	return ok;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	std::string directory = "tokenizer_test_" + std::to_string(::getpid());
+	try {
+		ok &= checkTokenizers(8);
+		ok &= check("Sample data", argv[1], argv[2], argv[3], argv[4]);
+
+		// Large enough for the orders file to be split across workers
+		seneca::GeneratorOptions options;
+		options.m_stations = 120;
+		options.m_orders = 40000;
+		options.m_seed = 45;
+		::mkdir(directory.c_str(), 0755);
+		seneca::ScenarioGenerator(options).writeFiles(directory);
+		ok &= check("Generated scenario", directory + "/Stations1.txt", directory + "/Stations2.txt",
+		            directory + "/CustomerOrders.txt", directory + "/AssemblyLine.txt");
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+	for (const char* file : {"Stations1.txt", "Stations2.txt", "CustomerOrders.txt", "AssemblyLine.txt"})
+		std::remove((directory + "/" + file).c_str());
+	::rmdir(directory.c_str());
+
+	if (!ok) {
+		std::cerr << "ERROR: parallel scenario loading diverged from a sequential load\n";
+		std::exit(3);
+	}
+	return 0;
+}
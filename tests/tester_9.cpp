@@ -0,0 +1,224 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "seneca/Scenario.h"
+#include "seneca/ScenarioGenerator.h"
+#include "seneca/SimulationContext.h"
+#include "seneca/RecordParser.h"
+#include "seneca/CustomerOrder.h"
+#include "seneca/Exceptions.h"
+#include "seneca/Logger.h"
+
+// Lenient parsing: the status-code parsers must accept exactly what the
+// throwing constructors accept, and a lenient load of a dirty feed must
+// equal a strict load of the same feed with the bad lines taken out.
+
+static bool checkRecordParity()
+{
+	const std::vector<std::string> stations{
+		"Desk,12345,7,Oak desk", "  Lamp , 42 , 3 ", "Bench", "Bench,", "Bench,9", "Shelf,,4,Pine",
+		"Shelf,x1,4,Pine", "Shelf, 12ab ,4", "Shelf,-3,4", "Shelf,99999999999999999999999,1",
+		"Shelf,1,2,,Pine", "Chair,1,2,Blue, padded", ",1,2,Nameless", ""};
+	const std::vector<std::string> orders{
+		"Ann|Office|Desk|Chair", "Ann|Office|", "Ann", "Ann|", "Ann||Desk", "|Office|Desk",
+		"Ann|Office|Desk||Chair", "  Ann  |  Office  |  Desk  "};
+
+	size_t mismatches = 0;
+	for (const auto& record : stations) {
+		seneca::SimulationContext context;
+		seneca::SimulationContext::Scope scope(context);
+		seneca::StationFields fields;
+		bool parsed = seneca::parseStation(record, ',', fields) == seneca::ParseStatus::OK;
+		try {
+			seneca::Station station(record, ',');
+			mismatches += !parsed || station.getItemName() != fields.m_name ||
+			              station.getSerialNumber() != fields.m_serialNumber ||
+			              station.getQuantity() != fields.m_quantity ||
+			              station.getDescription() != fields.m_description ||
+			              station.getFieldWidth() != fields.m_fieldWidth;
+		}
+		catch (const std::exception&) {
+			mismatches += parsed;
+		}
+	}
+	for (const auto& record : orders) {
+		seneca::SimulationContext context;
+		seneca::SimulationContext::Scope scope(context);
+		seneca::OrderSpec spec;
+		bool parsed = seneca::parseOrder(record, '|', spec) == seneca::ParseStatus::OK;
+		try {
+			seneca::CustomerOrder order(record, '|');
+			bool same = parsed && order.getProduct() == spec.m_product && order.getItemCount() == spec.m_items.size();
+			for (size_t i = 0; same && i < spec.m_items.size(); ++i)
+				same = order.getItem(i).m_itemName == spec.m_items[i];
+			mismatches += !same;
+		}
+		catch (const std::exception&) {
+			mismatches += parsed;
+		}
+	}
+
+	std::cout << "Record parity: " << stations.size() + orders.size() << " records, "
+	          << (mismatches ? std::to_string(mismatches) + " mismatched" : std::string("all agree")) << std::endl;
+	return mismatches == 0;
+}
+
+static std::string describe(const seneca::Scenario& scenario)
+{
+	std::ostringstream out;
+	for (const auto& station : scenario.getStations())
+		station.display(out, true);
+	for (const auto& spec : scenario.getOrders()) {
+		out << spec.m_name << '|' << spec.m_product;
+		for (const auto& item : spec.m_items)
+			out << '|' << item;
+		out << '\n';
+	}
+	for (const auto& link : scenario.getLinks())
+		out << link.first << "->" << link.second << '\n';
+	return out.str();
+}
+
+static std::vector<std::string> readLines(const std::string& path)
+{
+	std::vector<std::string> lines;
+	std::ifstream file(path);
+	std::string line;
+	while (std::getline(file, line))
+		lines.push_back(line);
+	return lines;
+}
+
+static void writeLines(const std::string& path, const std::vector<std::string>& lines)
+{
+	std::ofstream file(path);
+	for (const auto& line : lines)
+		file << line << '\n';
+}
+
+// Breaks every tenth non-empty line of a generated file, alternately with
+// an empty field and, for stations, a non-numeric serial number. Writes the
+// dirty file and the clean file without those lines; returns the 1-based
+// numbers of the broken lines.
+static std::vector<size_t> corrupt(const std::string& path, const std::string& cleanPath, char delimiter, bool numeric)
+{
+	std::vector<std::string> lines = readLines(path);
+	std::vector<std::string> clean;
+	std::vector<size_t> broken;
+	for (size_t i = 0; i < lines.size(); ++i) {
+		size_t split = lines[i].find(delimiter);
+		if (i % 10 != 3 || split == std::string::npos) {
+			clean.push_back(lines[i]);
+			continue;
+		}
+		if (numeric && broken.size() % 2)
+			lines[i].insert(split + 1, "#");
+		else
+			lines[i].insert(split, 1, delimiter);
+		broken.push_back(i + 1);
+	}
+	writeLines(path, lines);
+	writeLines(cleanPath, clean);
+	return broken;
+}
+
+template <typename Load>
+static std::string loadInContext(Load load)
+{
+	seneca::SimulationContext context;
+	seneca::SimulationContext::Scope scope(context);
+	return describe(load());
+}
+
+static bool checkDirtyFeed(const std::string& directory)
+{
+	seneca::GeneratorOptions options;
+	options.m_stations = 80;
+	options.m_orders = 30000;
+	options.m_seed = 46;
+	seneca::ScenarioGenerator(options).writeFiles(directory);
+
+	const std::vector<std::string> names{"Stations1", "Stations2", "CustomerOrders", "AssemblyLine"};
+	const std::string delimiters = ",|||";
+	std::vector<std::string> dirty, clean;
+	std::vector<std::pair<std::string, size_t>> expected;
+	for (size_t f = 0; f < names.size(); ++f) {
+		dirty.push_back(directory + "/" + names[f] + ".txt");
+		clean.push_back(directory + "/" + names[f] + ".clean.txt");
+		for (size_t line : corrupt(dirty[f], clean[f], delimiters[f], f < 2))
+			expected.emplace_back(dirty[f], line);
+	}
+
+	seneca::ParseReport report;
+	std::string lenient = loadInContext([&]() { return seneca::Scenario(dirty[0], dirty[1], dirty[2], dirty[3], report); });
+	std::string strict = loadInContext([&]() { return seneca::Scenario(clean[0], clean[1], clean[2], clean[3]); });
+
+	bool ok = lenient == strict && report.rejected() == expected.size();
+	for (size_t i = 0; ok && i < expected.size(); ++i)
+		ok = report.diagnostics()[i].m_file == expected[i].first && report.diagnostics()[i].m_line == expected[i].second;
+	std::cout << "Dirty feed: " << report.accepted() << " records accepted, " << report.rejected() << " skipped, "
+	          << (ok ? "match" : "MISMATCH") << std::endl;
+
+	// A strict load names the first bad line
+	bool thrown = false;
+	try {
+		loadInContext([&]() { return seneca::Scenario(dirty[0], dirty[1], dirty[2], dirty[3]); });
+	}
+	catch (const seneca::ValidationException& e) {
+		thrown = std::string(e.what()).find(dirty[0] + " line " + std::to_string(expected[0].second) + ":") != std::string::npos;
+	}
+	std::cout << "Strict load of the dirty feed: " << (thrown ? "rejected at the first bad line" : "NOT REJECTED") << std::endl;
+
+	for (size_t f = 0; f < names.size(); ++f) {
+		std::remove(dirty[f].c_str());
+		std::remove(clean[f].c_str());
+	}
+	return ok && thrown;
+}
+
+int main(int argc, char** argv)
+{
+	std::cout << "Command Line: " << argv[0];
+	for (int i = 1; i < argc; ++i)
+		std::cout << " " << argv[i];
+	std::cout << std::endl << std::endl;
+	if (argc != 5) {
+		std::cerr << "ERROR: Incorrect number of arguments\n";
+		std::exit(1);
+	}
+
+	seneca::Logger::getInstance().setLogLevel(seneca::LogLevel::ERROR);
+
+	bool ok = true;
+	std::string directory = "parse_test_" + std::to_string(::getpid());
+	try {
+		ok &= checkRecordParity();
+
+		// The sample data is clean: both modes load the same scenario
+		seneca::ParseReport report;
+		std::string lenient = loadInContext([&]() { return seneca::Scenario(argv[1], argv[2], argv[3], argv[4], report); });
+		std::string strict = loadInContext([&]() { return seneca::Scenario(argv[1], argv[2], argv[3], argv[4]); });
+		bool same = lenient == strict && report.clean();
+		std::cout << "Sample data: " << report.accepted() << " records, " << (same ? "match" : "MISMATCH") << std::endl;
+		ok &= same;
+
+		::mkdir(directory.c_str(), 0755);
+		ok &= checkDirtyFeed(directory);
+	}
+	catch (const std::exception& e) {
+		std::cerr << e.what() << '\n';
+		std::exit(2);
+	}
+	::rmdir(directory.c_str());
+
+	if (!ok) {
+		std::cerr << "ERROR: lenient parsing diverged from the throwing parsers\n";
+		std::exit(3);
+	}
+	return 0;
+}